@@ -0,0 +1,85 @@
+#include "PoolDeRender.h"
+#include "../rastreio/Rastreador.h"
+
+#include <string>
+
+PoolDeRender::PoolDeRender(int numThreads)
+    : m_numThreads(numThreads < 1 ? 1 : numThreads)
+{
+    // A fatia 0 é de quem chama executar(): só as outras precisam de thread
+    for (int k = 1; k < m_numThreads; k++)
+    {
+        m_threads.emplace_back(&PoolDeRender::_loopTrabalhador, this, k);
+    }
+}
+
+PoolDeRender::~PoolDeRender()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_encerrar = true;
+    }
+    m_cvInicio.notify_all();
+    for (auto &thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void PoolDeRender::executar(Tarefa tarefa, void *contexto)
+{
+    if (m_threads.empty())
+    {
+        tarefa(contexto, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tarefa = tarefa;
+        m_contexto = contexto;
+        m_pendentes = (int)m_threads.size();
+        m_geracao++;
+    }
+    m_cvInicio.notify_all();
+
+    // Quem chama também trabalha
+    tarefa(contexto, 0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvFim.wait(lock, [this]
+                 { return m_pendentes == 0; });
+}
+
+void PoolDeRender::_loopTrabalhador(int indice)
+{
+    if (Rastreador::ativo())
+        Rastreador::nomearThread("render " + std::to_string(indice));
+
+    uint64_t geracaoVista = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_cvInicio.wait(lock, [&]
+                        { return m_encerrar || m_geracao != geracaoVista; });
+        if (m_encerrar)
+            return;
+
+        geracaoVista = m_geracao;
+        Tarefa tarefa = m_tarefa;
+        void *contexto = m_contexto;
+
+        lock.unlock();
+        {
+            SIM_SPAN("app", "fatiaRender");
+            tarefa(contexto, indice);
+        }
+        lock.lock();
+
+        if (--m_pendentes == 0)
+        {
+            m_cvFim.notify_one();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef POOL_DE_RENDER_H
+#define POOL_DE_RENDER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class PoolDeRender
+ * @brief Pool persistente de threads para dividir um frame em fatias.
+ *
+ * As threads são criadas uma única vez e ficam dormindo entre frames.
+ * executar() roda tarefa(contexto, k) para cada k em [0, numThreads()):
+ * a fatia 0 roda na própria thread que chamou, as demais no pool, e a
+ * chamada só retorna quando todas terminarem.
+ */
+class PoolDeRender
+{
+public:
+    typedef void (*Tarefa)(void *contexto, int indice);
+
+    /**
+     * @param numThreads Total de fatias por execução (inclui quem chama).
+     */
+    explicit PoolDeRender(int numThreads);
+    ~PoolDeRender();
+
+    PoolDeRender(const PoolDeRender &) = delete;
+    PoolDeRender &operator=(const PoolDeRender &) = delete;
+
+    int numThreads() const { return m_numThreads; }
+
+    void executar(Tarefa tarefa, void *contexto);
+
+private:
+    int m_numThreads;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cvInicio;
+    std::condition_variable m_cvFim;
+    uint64_t m_geracao = 0; // Incrementada a cada executar()
+    int m_pendentes = 0;    // Fatias do pool ainda rodando
+    bool m_encerrar = false;
+
+    Tarefa m_tarefa = nullptr;
+    void *m_contexto = nullptr;
+
+    void _loopTrabalhador(int indice);
+};
+
+#endif // POOL_DE_RENDER_H
@@ -1,10 +1,98 @@
 #include "donut.h"
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+#include <algorithm> // Para std::fill, std::min, std::max
 
-AppDonut::AppDonut() 
+/**
+ * @brief Cor do nível de luminância N: de um violeta escuro (sombra) a
+ * um amarelo pálido (reflexo), passando por um laranja avermelhado.
+ */
+static uint32_t _corDaLuminancia(int N)
+{
+    static const float PARADAS[3][3] = {{0x40, 0x18, 0x70}, {0xE0, 0x48, 0x30}, {0xFF, 0xEC, 0xA8}};
+    const float t = 2.0f * N / MAX_LUMINANCIA_DONUT; // 0..2
+    const int trecho = t < 1.0f ? 0 : 1;
+    const float f = t - trecho;
+    uint32_t canais[3];
+    for (int k = 0; k < 3; k++)
+        canais[k] = (uint32_t)(PARADAS[trecho][k] + (PARADAS[trecho + 1][k] - PARADAS[trecho][k]) * f + 0.5f);
+    return corRGB(canais[0], canais[1], canais[2]);
+}
+
+AppDonut::AppDonut(int numThreadsRender, int largura, int altura)
     : m_angleA(0), m_angleB(0), 
-      m_velocityA(0.0), m_velocityB(0.0) // Inicializa velocidades
+      m_velocityA(0.0), m_velocityB(0.0), // Inicializa velocidades
+      m_largura(0), m_altura(0), m_escala(1.0f),
+      m_pool(numThreadsRender)
 {
-    // Estado inicial dos ângulos e velocidades
+    m_kernel = selecionarKernelDonut();
+    _configurarResolucao(largura, altura);
+
+    // Só os glifos do gradiente têm cor; o fundo (' ') fica na cor padrão
+    std::fill(m_corDoGlifo, m_corDoGlifo + 256, COR_PADRAO);
+    for (int N = 0; N <= MAX_LUMINANCIA_DONUT; N++)
+        m_corDoGlifo[(unsigned char)GRADIENTE_DONUT[N]] = _corDaLuminancia(N);
+}
+
+void AppDonut::usarCores(bool cores)
+{
+    m_cores = cores;
+    m_frameAnterior.clear(); // O próximo frame vai inteiro, no modo novo
+    m_reenviar = true;
+}
+
+void AppDonut::redimensionar(int largura, int altura)
+{
+    if (largura <= 0 || altura <= 0 || (largura == m_largura && altura == m_altura))
+        return;
+
+    _configurarResolucao(largura, altura);
+    if (m_framebuffer)
+        m_framebuffer->redimensionar(largura, altura);
+}
+
+void AppDonut::_configurarResolucao(int largura, int altura)
+{
+    m_largura = largura;
+    m_altura = altura;
+    const size_t celulas = (size_t)largura * (size_t)altura;
+
+    // A projeção cresce com o menor dos eixos (o donut cabe e mantém a
+    // proporção) e o passo de amostragem encolhe junto, para não abrir
+    // buracos. No laço original, amostras vizinhas em j ficam a ~1 célula
+    // (encolhe com a escala) e em i a ~0.1 (só encolhe passando de 4x):
+    // as amostras crescem com as células, não com o quadrado delas.
+    // No 80x24 a escala é 1: os passos originais (j += 0.07, i += 0.02).
+    m_escala = std::min((float)largura / LARGURA_PADRAO_DONUT, (float)altura / ALTURA_PADRAO_DONUT);
+    const double escalaI = std::max(1.0, m_escala / 2.0);
+    construirTabelasDonut(m_tabelas, 0.02 / escalaI, 0.07 / m_escala);
+    m_b.assign(celulas, ' ');
+    m_z.assign(celulas, 0.0f);
+
+    // Divide as amostras j em fatias contínuas, uma por thread
+    int numFatias = m_pool.numThreads();
+    m_fatias.resize(numFatias);
+    for (int k = 0; k < numFatias; k++)
+    {
+        m_fatias[k].jInicio = m_tabelas.numJ * k / numFatias;
+        m_fatias[k].jFim = m_tabelas.numJ * (k + 1) / numFatias;
+        if (k > 0)
+        {
+            m_fatias[k].b.assign(celulas, ' ');
+            m_fatias[k].z.assign(celulas, 0.0f);
+        }
+    }
+
+    // Sem frame anterior do mesmo tamanho: o próximo vai inteiro
+    m_regioesSujas.reserve(altura + 1); // + o prefixo, no desenho direto
+    m_frame.reserve(celulas + 3);
+    m_frameAnterior.clear();
+    m_reenviar = true;
+
+    SIM_LOG(LOG_INFO, "APP DONUT", "Kernel de renderização: {} amostras por frame ({}x{}), {} thread(s).",
+            m_tabelas.numI * m_tabelas.numJ, m_tabelas.numJ, m_tabelas.numI, numFatias);
+    SIM_LOG(LOG_INFO, "APP DONUT", "Display de {}x{} caracteres.", largura, altura);
 }
 
 void AppDonut::conectar(BufferDeEntradaOS *bufferEntrada, IFrameBuffer *framebuffer)
@@ -19,25 +107,29 @@ void AppDonut::executarTick()
         return; // Não executa se não estiver conectado
 
     // --- 1. Processar Inputs (Consumidor) ---
-    while (m_bufferEntrada->temDados())
+    // Retira as teclas em lotes: uma única sincronização com o ISR por lote
+    char teclas[64];
+    size_t n;
+    while ((n = m_bufferEntrada->desenfileirar(teclas, sizeof(teclas))) > 0)
     {
-        char c = m_bufferEntrada->desenfileirarTecla();
-
-        // --- CORREÇÃO: Aumentamos a magnitude da "força" ---
-        switch (c)
+        for (size_t k = 0; k < n; k++)
         {
-        case 'w':
-            m_velocityA -= 0.1; // Era 0.01
-            break; 
-        case 's':
-            m_velocityA += 0.1; // Era 0.01
-            break; 
-        case 'a':
-            m_velocityB -= 0.1; // Era 0.01
-            break; 
-        case 'd':
-            m_velocityB += 0.1; // Era 0.01
-            break; 
+            // --- CORREÇÃO: Aumentamos a magnitude da "força" ---
+            switch (teclas[k])
+            {
+            case 'w':
+                m_velocityA -= 0.1; // Era 0.01
+                break; 
+            case 's':
+                m_velocityA += 0.1; // Era 0.01
+                break; 
+            case 'a':
+                m_velocityB -= 0.1; // Era 0.01
+                break; 
+            case 'd':
+                m_velocityB += 0.1; // Era 0.01
+                break; 
+            }
         }
     }
 
@@ -47,57 +139,206 @@ void AppDonut::executarTick()
     m_angleB += m_velocityB;
 
     // --- 3. Renderizar ---
-    std::string frame_output;
-    frame_output.reserve(W * H + 5); 
+    _renderizarFrame();
+    m_reenviar = false;
+
+    // --- 4. Enviar para a "Tela" (só o que mudou, quando possível) ---
+    // Texto num framebuffer que empresta a memória: desenha direto nela
+    static const size_t PREFIXO = sizeof("\x1b[H") - 1;
+    char *direto = m_cores ? nullptr : m_framebuffer->frameParaDesenho(PREFIXO + (size_t)m_largura * m_altura);
+    if (direto != nullptr)
+    {
+        _desenharDireto(direto);
+        m_framebuffer->publicarDesenho(m_regioesSujas.data(), m_regioesSujas.size());
+        m_frameAnterior.clear(); // Se o próximo for por string, vai inteiro
+        return;
+    }
+
+    // O \x1b[H (home) é crucial para limpar a tela do terminal; uma cópia
+    // por linha, e a coluna 0 (nunca desenhada) vira o '\n'
+    textoDeGlifos(m_b.data(), m_largura, m_altura, m_frame);
+    const bool temDelta = _calcularRegioesSujas();
+    if (m_cores)
+    {
+        _enviarCelulas(temDelta);
+    }
+    else if (temDelta)
+    {
+        m_framebuffer->atualizarRegioes(m_frame, m_regioesSujas.data(), m_regioesSujas.size());
+    }
+    else
+    {
+        m_framebuffer->atualizar(m_frame);
+    }
+    m_frame.swap(m_frameAnterior);
+}
+
+bool AppDonut::temTrabalho() const
+{
+    if (!m_bufferEntrada || !m_framebuffer)
+        return false;
+    return m_reenviar || m_velocityA != 0.0 || m_velocityB != 0.0 || m_bufferEntrada->temDados();
+}
 
-    _renderizarFrame(frame_output);
+bool AppDonut::_calcularRegioesSujas()
+{
+    // O frame é "\x1b[H" seguido de 'altura' linhas de 'largura' bytes
+    static const size_t PREFIXO = sizeof("\x1b[H") - 1;
+    const int largura = m_largura;
+
+    if (m_frameAnterior.size() != m_frame.size() || m_frame.size() != PREFIXO + (size_t)largura * m_altura)
+        return false;
+
+    m_regioesSujas.clear();
+    const char *atual = m_frame.data() + PREFIXO;
+    const char *anterior = m_frameAnterior.data() + PREFIXO;
+
+    for (int y = 0; y < m_altura; y++)
+    {
+        const char *linhaAtual = atual + (size_t)y * largura;
+        const char *linhaAnterior = anterior + (size_t)y * largura;
+
+        // Nas grades grandes a maioria das linhas não muda: memcmp primeiro
+        if (memcmp(linhaAtual, linhaAnterior, (size_t)largura) == 0)
+            continue; // Linha inalterada
+
+        int inicio = 0;
+        while (linhaAtual[inicio] == linhaAnterior[inicio])
+            inicio++;
+
+        int fim = largura - 1;
+        while (linhaAtual[fim] == linhaAnterior[fim])
+            fim--;
+
+        m_regioesSujas.push_back({(uint32_t)(PREFIXO + (size_t)y * largura + inicio), (uint32_t)(fim - inicio + 1)});
+    }
+    return true;
+}
+
+void AppDonut::_desenharDireto(char *frame)
+{
+    // O mesmo texto do textoDeGlifos(), escrito só onde difere do que
+    // já está no framebuffer (o frame anterior, ou lixo de outro tamanho)
+    static const char PREFIXO[] = "\x1b[H";
+    static const size_t TAMANHO_PREFIXO = sizeof(PREFIXO) - 1;
+    const int largura = m_largura;
+
+    m_regioesSujas.clear();
+    if (memcmp(frame, PREFIXO, TAMANHO_PREFIXO) != 0)
+    {
+        memcpy(frame, PREFIXO, TAMANHO_PREFIXO);
+        m_regioesSujas.push_back({0, (uint32_t)TAMANHO_PREFIXO});
+    }
+
+    for (int y = 0; y < m_altura; y++)
+    {
+        char *destino = frame + TAMANHO_PREFIXO + (size_t)y * largura;
+        const char *origem = m_b.data() + (size_t)y * largura;
+
+        // Coluna 0 é sempre o '\n'; o resto são os glifos
+        int inicio = destino[0] == '\n' ? 1 : 0;
+        if (inicio == 1)
+        {
+            while (inicio < largura && destino[inicio] == origem[inicio])
+                inicio++;
+            if (inicio == largura)
+                continue; // Linha inalterada
+        }
+        int fim = largura - 1;
+        while (fim > inicio && destino[fim] == origem[fim])
+            fim--;
 
-    // --- 4. Enviar para a "Tela" ---
-    m_framebuffer->atualizar(frame_output);
+        memcpy(destino + inicio, origem + inicio, (size_t)(fim - inicio + 1));
+        destino[0] = '\n';
+        m_regioesSujas.push_back({(uint32_t)(TAMANHO_PREFIXO + (size_t)y * largura + inicio), (uint32_t)(fim - inicio + 1)});
+    }
+}
+
+void AppDonut::_enviarCelulas(bool delta)
+{
+    static const size_t PREFIXO = sizeof("\x1b[H") - 1;
+    const size_t celulas = (size_t)m_largura * m_altura;
+    if (m_celulas.largura != m_largura || m_celulas.altura != m_altura)
+    {
+        m_celulas.redimensionar(m_largura, m_altura);
+        delta = false;
+    }
+
+    // A célula o é o byte PREFIXO + o do frame de texto (na coluna 0 o
+    // '\n' nunca muda): as regiões sujas viram trechos de células
+    if (!delta)
+    {
+        for (size_t o = 0; o < celulas; o++)
+        {
+            m_celulas.glifos[o] = m_b[o];
+            m_celulas.frente[o] = m_corDoGlifo[(unsigned char)m_b[o]];
+        }
+        m_framebuffer->atualizarCelulas(m_celulas);
+        return;
+    }
+
+    for (RegiaoSuja &regiao : m_regioesSujas)
+    {
+        regiao.deslocamento -= (uint32_t)PREFIXO;
+        for (size_t o = regiao.deslocamento; o < (size_t)regiao.deslocamento + regiao.tamanho; o++)
+        {
+            m_celulas.glifos[o] = m_b[o];
+            m_celulas.frente[o] = m_corDoGlifo[(unsigned char)m_b[o]];
+        }
+    }
+    m_framebuffer->atualizarCelulasRegioes(m_celulas, m_regioesSujas.data(), m_regioesSujas.size());
 }
 
 /**
  * @brief Esta é a sua função, adaptada para C++ e para usar
  * os membros da classe (m_angleA, m_angleB).
+ * O laço j/i agora mora no kernel (donut_kernel.cpp), com tabelas
+ * de sin/cos e caminhos SIMD.
  */
-void AppDonut::_renderizarFrame(std::string &output)
+void AppDonut::_renderizarFrame()
 {
-    static const char gradient[] = ".,-~:;=!*#$@";
+    SIM_SPAN("app", "renderizarFrame");
+    CronometroMetrica cronometro(HIST_RENDER);
 
-    // Usamos std::vector em vez de arrays C (mais seguro)
-    std::vector<char> b(H * W, ' ');
-    std::vector<double> z(H * W, 0.0);
+    // Só A e B mudam entre frames: 4 sin/cos por frame, e não 8 por amostra
+    m_parametros.senA = (float)sin(m_angleA);
+    m_parametros.cosA = (float)cos(m_angleA);
+    m_parametros.senB = (float)sin(m_angleB);
+    m_parametros.cosB = (float)cos(m_angleB);
+    m_parametros.largura = m_largura;
+    m_parametros.altura = m_altura;
+    m_parametros.escalaX = 30.0f * m_escala;
+    m_parametros.escalaY = 15.0f * m_escala;
 
-    double A = m_angleA; // Usa o estado da classe
-    double B = m_angleB; // Usa o estado da classe
+    // Cada fatia rasteriza o seu intervalo de j nos seus buffers
+    m_pool.executar(&AppDonut::_renderizarFatia, this);
 
-    for (double j = 0; j < 6.28; j += 0.07)
+    // Combina as fatias em ordem de j: uma fatia só vence com um 1/z
+    // estritamente maior, igual ao teste do laço serial.
+    const size_t celulas = (size_t)m_largura * m_altura;
+    for (size_t k = 1; k < m_fatias.size(); k++)
     {
-        for (double i = 0; i < 6.28; i += 0.02)
+        const FatiaRender &fatia = m_fatias[k];
+        for (size_t o = 0; o < celulas; o++)
         {
-            double c = sin(i), d = cos(j), e = sin(A), f = sin(j), g = cos(A);
-            double h = d + 2, D = 1 / (c * h * e + f * g + 5);
-            double l = cos(i), m = cos(B), n = sin(B);
-            double t = c * h * g - f * e;
-            int x = W / 2 + 30 * D * (l * h * m - t * n);
-            int y = H / 2 + 15 * D * (l * h * n + t * m);
-            int o = x + W * y;
-            int N = 8 * ((f * e - c * d * g) * m - c * d * e - f * g - l * d * n);
-            if (H > y && y > 0 && x > 0 && W > x && D > z[o])
+            if (fatia.z[o] > m_z[o])
             {
-                z[o] = D;
-                b[o] = gradient[N > 0 ? N : 0];
+                m_z[o] = fatia.z[o];
+                m_b[o] = fatia.b[o];
             }
         }
     }
+}
 
-    // O \x1b[H (home) é crucial para limpar a tela do terminal
-    output.clear();
-    output += "\x1b[H";
+void AppDonut::_renderizarFatia(void *contexto, int indice)
+{
+    AppDonut *app = static_cast<AppDonut *>(contexto);
+    FatiaRender &fatia = app->m_fatias[indice];
+    char *b = indice == 0 ? app->m_b.data() : fatia.b.data();
+    float *z = indice == 0 ? app->m_z.data() : fatia.z.data();
 
-    // Constrói a string de saída (mais eficiente que sprintf/strlen)
-    for (int k = 0; k < H * W; k++)
-    {
-        output += (k % W) ? b[k] : '\n';
-    }
-}
\ No newline at end of file
+    const size_t celulas = (size_t)app->m_largura * app->m_altura;
+    std::fill(b, b + celulas, ' ');
+    std::fill(z, z + celulas, 0.0f);
+    app->m_kernel(app->m_tabelas, app->m_parametros, fatia.jInicio, fatia.jFim, b, z);
+}
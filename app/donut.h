@@ -8,17 +8,41 @@
 #include "../interface/IProcesso.h"
 #include "../buffer/BufferDeEntradaOS.h"
 #include "../interface/IFrameBuffer.h"
+#include "donut_kernel.h"
+#include "PoolDeRender.h"
 
-// Definindo o tamanho do nosso "framebuffer"
-static const int W = 80;
-static const int H = 24;
+// Tamanho padrão do nosso "framebuffer" (o original); outros vêm de --resolucao
+static const int LARGURA_PADRAO_DONUT = 80;
+static const int ALTURA_PADRAO_DONUT = 24;
 
-class AppDonut : public IAplicacao
+class AppDonut final : public IAplicacao
 {
 public:
-    AppDonut();
+    /**
+     * @param numThreadsRender Em quantas threads dividir cada frame
+     * (1 = renderiza direto na thread da CPU, sem pool).
+     * @param largura, altura Tamanho do display em caracteres. A projeção
+     * e a densidade de amostras acompanham (no 80x24, o frame original).
+     */
+    explicit AppDonut(int numThreadsRender = 1, int largura = LARGURA_PADRAO_DONUT, int altura = ALTURA_PADRAO_DONUT);
     virtual ~AppDonut() = default;
 
+    /**
+     * @brief Muda o tamanho do display (e repassa ao framebuffer). O
+     * próximo frame vai inteiro. Chame entre ticks, na thread da CPU.
+     */
+    void redimensionar(int largura, int altura);
+
+    int largura() const { return m_largura; }
+    int altura() const { return m_altura; }
+
+    /**
+     * @brief Liga/desliga a cor: cada glifo ganha a cor da sua luminância
+     * e os frames vão ao framebuffer como células (atualizarCelulas*).
+     * Desligada, o envio é o frame de texto de sempre.
+     */
+    void usarCores(bool cores);
+
     /**
      * @brief Conecta a aplicação às interfaces do "SO".
      * (Implementação do contrato IAplicacao)
@@ -31,6 +55,12 @@ public:
      */
     void executarTick() override;
 
+    /**
+     * @brief Parado (velocidade zero) e sem teclas, o próximo frame seria
+     * idêntico ao anterior: não há trabalho.
+     */
+    bool temTrabalho() const override;
+
 private:
     // --- Interfaces do "SO" ---
     BufferDeEntradaOS *m_bufferEntrada = nullptr;
@@ -44,10 +74,72 @@ private:
     double m_velocityA; // Velocidade de rotação no eixo A
     double m_velocityB; // Velocidade de rotação no eixo B
 
+    // --- Rasterização ---
+    int m_largura, m_altura;  // Display, em caracteres
+    float m_escala;           // Projeção relativa ao 80x24 (1 = original)
+    TabelasDonut m_tabelas;   // sin/cos dos ângulos de amostragem (por resolução)
+    KernelDonut m_kernel;     // AVX2 / SSE4.1 / escalar, escolhido em tempo de execução
+    std::vector<char> m_b;    // Buffer de caracteres (largura * altura)
+    std::vector<float> m_z;   // Z-buffer (1/z) (largura * altura)
+
+    // --- Renderização paralela ---
+    // Cada fatia cobre um intervalo contínuo de j e tem os seus próprios
+    // buffers (a fatia 0 usa m_b/m_z). No fim, as fatias são combinadas
+    // em ordem, o que dá exatamente o mesmo frame da versão serial.
+    struct FatiaRender
+    {
+        int jInicio, jFim;
+        std::vector<char> b;
+        std::vector<float> z;
+    };
+    PoolDeRender m_pool;
+    std::vector<FatiaRender> m_fatias;
+    ParametrosDonut m_parametros; // Do frame em andamento (lido pelas fatias)
+
+    static void _renderizarFatia(void *contexto, int indice);
+
+    /**
+     * @brief Ajusta escala, tabelas de amostragem, buffers e fatias para
+     * um display largura x altura.
+     */
+    void _configurarResolucao(int largura, int altura);
+
+    // --- Frames (atual e anterior) para o envio por delta ---
+    std::string m_frame;
+    std::string m_frameAnterior;
+    std::vector<RegiaoSuja> m_regioesSujas;
+
+    // --- Cor (usarCores) ---
+    bool m_cores = false;
+    FrameCelulas m_celulas;      // Último frame enviado como células
+    uint32_t m_corDoGlifo[256];  // Glifo do gradiente -> cor da luminância
+
+    // O próximo frame precisa sair mesmo parado (início, resolução ou modo novo)
+    bool m_reenviar = true;
+
+    /**
+     * @brief Renderiza um único frame do donut em m_b (glifos).
+     */
+    void _renderizarFrame();
+
+    /**
+     * @brief Escreve o texto do frame (m_b) direto na memória emprestada
+     * pelo framebuffer, só onde ela difere, e preenche m_regioesSujas.
+     */
+    void _desenharDireto(char *frame);
+
+    /**
+     * @brief Compara m_frame com m_frameAnterior linha a linha e
+     * preenche m_regioesSujas com um trecho por linha alterada.
+     * @return false se não há frame anterior comparável (enviar tudo).
+     */
+    bool _calcularRegioesSujas();
+
     /**
-     * @brief Renderiza um único frame do donut na string de output.
+     * @brief Envia m_frame como células: só as regiões sujas são
+     * recoloridas (e enviadas) quando 'delta' vale, senão o frame todo.
      */
-    void _renderizarFrame(std::string &output);
+    void _enviarCelulas(bool delta);
 };
 
 #endif // APP_DONUT_H
\ No newline at end of file
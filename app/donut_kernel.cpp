@@ -0,0 +1,386 @@
+#include "donut_kernel.h"
+
+#include <cmath> // Para sin() e cos()
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DONUT_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+void construirTabelasDonut(TabelasDonut &tabelas, double passoI, double passoJ)
+{
+    tabelas.senI.clear();
+    tabelas.cosI.clear();
+    tabelas.senJ.clear();
+    tabelas.cosJ.clear();
+
+    // Mesmos ângulos (com o mesmo acúmulo de erro) do laço original
+    for (double j = 0; j < 6.28; j += passoJ)
+    {
+        tabelas.senJ.push_back((float)sin(j));
+        tabelas.cosJ.push_back((float)cos(j));
+    }
+    for (double i = 0; i < 6.28; i += passoI)
+    {
+        tabelas.senI.push_back((float)sin(i));
+        tabelas.cosI.push_back((float)cos(i));
+    }
+    tabelas.numJ = (int)tabelas.senJ.size();
+    tabelas.numI = (int)tabelas.senI.size();
+
+    // Folga até múltiplo de 8: os kernels vetoriais leem sempre 8 amostras
+    size_t alinhado = (tabelas.senI.size() + 7) & ~(size_t)7;
+    tabelas.senI.resize(alinhado, 0.0f);
+    tabelas.cosI.resize(alinhado, 0.0f);
+}
+
+/**
+ * @brief Tudo o que só depende de j (e de A/B), fatorado para fora do laço em i.
+ * Com c = sin(i) e l = cos(i), cada amostra vira:
+ *   D = 1 / (c*k1 + k0)          t = c*k2 - k3
+ *   x = cx + escalaX*D*(l*k4 - t*senB)
+ *   y = cy + escalaY*D*(l*k5 + t*cosB)
+ *   N = n0 - c*n1 - l*n2
+ */
+struct CoeficientesJ
+{
+    float k0, k1, k2, k3, k4, k5;
+    float n0, n1, n2;
+};
+
+static inline CoeficientesJ _coeficientesJ(const ParametrosDonut &p, float senJ, float cosJ)
+{
+    const float d = cosJ, f = senJ;
+    const float e = p.senA, g = p.cosA, m = p.cosB, n = p.senB;
+    const float h = d + 2.0f;
+
+    CoeficientesJ k;
+    k.k0 = f * g + 5.0f;
+    k.k1 = h * e;
+    k.k2 = h * g;
+    k.k3 = f * e;
+    k.k4 = h * m;
+    k.k5 = h * n;
+    k.n0 = 8.0f * (f * e * m - f * g);
+    k.n1 = 8.0f * (d * (g * m + e));
+    k.n2 = 8.0f * (d * n);
+    return k;
+}
+
+/**
+ * @brief Teste de profundidade do kernel escalar, na ordem das amostras.
+ */
+static inline void _plotar(int x, int y, float D, int N, int largura, char *b, float *z)
+{
+    int o = x + largura * y;
+    if (D > z[o])
+    {
+        z[o] = D;
+        b[o] = GRADIENTE_DONUT[N > 0 ? (N < MAX_LUMINANCIA_DONUT ? N : MAX_LUMINANCIA_DONUT) : 0];
+    }
+}
+
+void renderizarDonutOriginal(double A, double B, std::vector<char> &b)
+{
+    static const char gradient[] = ".,-~:;=!*#$@";
+    const int W = 80, H = 24;
+
+    b.assign(H * W, ' ');
+    std::vector<double> z(H * W, 0.0);
+
+    for (double j = 0; j < 6.28; j += 0.07)
+    {
+        for (double i = 0; i < 6.28; i += 0.02)
+        {
+            double c = sin(i), d = cos(j), e = sin(A), f = sin(j), g = cos(A);
+            double h = d + 2, D = 1 / (c * h * e + f * g + 5);
+            double l = cos(i), m = cos(B), n = sin(B);
+            double t = c * h * g - f * e;
+            int x = W / 2 + 30 * D * (l * h * m - t * n);
+            int y = H / 2 + 15 * D * (l * h * n + t * m);
+            int o = x + W * y;
+            int N = 8 * ((f * e - c * d * g) * m - c * d * e - f * g - l * d * n);
+            if (H > y && y > 0 && x > 0 && W > x && D > z[o])
+            {
+                z[o] = D;
+                b[o] = gradient[N > 0 ? N : 0];
+            }
+        }
+    }
+}
+
+void kernelDonutEscalar(const TabelasDonut &tabelas, const ParametrosDonut &p,
+                        int jInicio, int jFim, char *b, float *z)
+{
+    const float cx = (float)(p.largura / 2), cy = (float)(p.altura / 2);
+
+    for (int j = jInicio; j < jFim; j++)
+    {
+        const CoeficientesJ k = _coeficientesJ(p, tabelas.senJ[j], tabelas.cosJ[j]);
+
+        for (int i = 0; i < tabelas.numI; i++)
+        {
+            const float c = tabelas.senI[i], l = tabelas.cosI[i];
+
+            float D = 1.0f / (c * k.k1 + k.k0);
+            float t = c * k.k2 - k.k3;
+            int x = (int)(cx + p.escalaX * D * (l * k.k4 - t * p.senB));
+            int y = (int)(cy + p.escalaY * D * (l * k.k5 + t * p.cosB));
+            int N = (int)(k.n0 - c * k.n1 - l * k.n2);
+
+            if (p.altura > y && y > 0 && x > 0 && p.largura > x)
+            {
+                _plotar(x, y, D, N, p.largura, b, z);
+            }
+        }
+    }
+}
+
+#ifdef DONUT_KERNEL_X86
+
+// Para cada rotação r do lote de 8: a lane k é comparada com a (k + r) % 8,
+// que vem antes dela nas amostras quando k + r passa de 8
+struct TabelasLote
+{
+    alignas(32) int rotacao[8][8];
+    alignas(32) int antes[8][8];
+
+    TabelasLote()
+    {
+        for (int r = 0; r < 8; r++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                rotacao[r][k] = (k + r) & 7;
+                antes[r][k] = k + r >= 8 ? -1 : 0;
+            }
+        }
+    }
+};
+static const TabelasLote TABELAS_LOTE;
+
+__attribute__((target("avx2"))) static void _kernelDonutAVX2(const TabelasDonut &tabelas, const ParametrosDonut &p,
+                                                              int jInicio, int jFim, char *b, float *z)
+{
+    const __m256 cx = _mm256_set1_ps((float)(p.largura / 2));
+    const __m256 cy = _mm256_set1_ps((float)(p.altura / 2));
+    const __m256 escalaX = _mm256_set1_ps(p.escalaX);
+    const __m256 escalaY = _mm256_set1_ps(p.escalaY);
+    const __m256 senB = _mm256_set1_ps(p.senB);
+    const __m256 cosB = _mm256_set1_ps(p.cosB);
+    const __m256 um = _mm256_set1_ps(1.0f);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i largura = _mm256_set1_epi32(p.largura);
+    const __m256i altura = _mm256_set1_epi32(p.altura);
+    const __m256i maxN = _mm256_set1_epi32(MAX_LUMINANCIA_DONUT);
+    const __m256i todos = _mm256_set1_epi32(-1);
+
+    alignas(32) int os[8], Ns[8];
+    alignas(32) float Ds[8];
+
+    // A célula 0 (x = 0) nunca é desenhada: serve de descarte no lote
+    const float zCelula0 = z[0];
+    const char bCelula0 = b[0];
+
+    for (int j = jInicio; j < jFim; j++)
+    {
+        const CoeficientesJ k = _coeficientesJ(p, tabelas.senJ[j], tabelas.cosJ[j]);
+        const __m256 k0 = _mm256_set1_ps(k.k0), k1 = _mm256_set1_ps(k.k1), k2 = _mm256_set1_ps(k.k2);
+        const __m256 k3 = _mm256_set1_ps(k.k3), k4 = _mm256_set1_ps(k.k4), k5 = _mm256_set1_ps(k.k5);
+        const __m256 n0 = _mm256_set1_ps(k.n0), n1 = _mm256_set1_ps(k.n1), n2 = _mm256_set1_ps(k.n2);
+
+        for (int i = 0; i < tabelas.numI; i += 8)
+        {
+            const __m256 c = _mm256_loadu_ps(&tabelas.senI[i]);
+            const __m256 l = _mm256_loadu_ps(&tabelas.cosI[i]);
+
+            __m256 D = _mm256_div_ps(um, _mm256_add_ps(_mm256_mul_ps(c, k1), k0));
+            __m256 t = _mm256_sub_ps(_mm256_mul_ps(c, k2), k3);
+            __m256 px = _mm256_sub_ps(_mm256_mul_ps(l, k4), _mm256_mul_ps(t, senB));
+            __m256 py = _mm256_add_ps(_mm256_mul_ps(l, k5), _mm256_mul_ps(t, cosB));
+            __m256i x = _mm256_cvttps_epi32(_mm256_add_ps(cx, _mm256_mul_ps(_mm256_mul_ps(escalaX, D), px)));
+            __m256i y = _mm256_cvttps_epi32(_mm256_add_ps(cy, _mm256_mul_ps(_mm256_mul_ps(escalaY, D), py)));
+
+            // Máscara de quem cai dentro da tela: 0 < x < largura e 0 < y < altura
+            __m256i dentro = _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi32(x, zero), _mm256_cmpgt_epi32(largura, x)),
+                _mm256_and_si256(_mm256_cmpgt_epi32(y, zero), _mm256_cmpgt_epi32(altura, y)));
+            int restantes = tabelas.numI - i;
+            if (restantes < 8) // Descarta a folga da tabela
+                dentro = _mm256_and_si256(dentro, _mm256_cmpgt_epi32(_mm256_set1_epi32(restantes),
+                                                                     _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+
+            // Pré-filtro: lê o z-buffer atual (gather mascarado) e descarta as
+            // amostras já escondidas. Como z só cresce, descartar aqui nunca
+            // muda o resultado; o _plotar confere de novo as que sobram.
+            __m256i o = _mm256_add_epi32(x, _mm256_mullo_epi32(y, largura));
+            __m256 zAtual = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), z, o, _mm256_castsi256_ps(dentro), 4);
+            __m256 visivel = _mm256_and_ps(_mm256_cmp_ps(D, zAtual, _CMP_GT_OQ), _mm256_castsi256_ps(dentro));
+            int bits = _mm256_movemask_ps(visivel);
+            if (bits == 0)
+                continue;
+
+            // Amostras do mesmo lote na mesma célula (as vizinhas em i quase
+            // sempre caem juntas): resolvidas aqui, nos registradores. Vence
+            // a de maior D e, no empate, a primeira, como no laço serial. As
+            // descartadas ganham o = -1, que não bate com nenhuma célula.
+            // D > 0 nas visíveis: comparar os bits como inteiros é comparar
+            // os floats, e "DOutra > D - 1" vira o ">=" de quem vem antes.
+            const __m256i oVisivel = _mm256_or_si256(o, _mm256_xor_si256(_mm256_castps_si256(visivel), todos));
+            const __m256i DBits = _mm256_castps_si256(D);
+            __m256i perdeu = zero;
+            for (int r = 1; r < 8; r++)
+            {
+                const __m256i rotacao = _mm256_load_si256(reinterpret_cast<const __m256i *>(TABELAS_LOTE.rotacao[r]));
+                const __m256i antes = _mm256_load_si256(reinterpret_cast<const __m256i *>(TABELAS_LOTE.antes[r]));
+                const __m256i mesma = _mm256_cmpeq_epi32(_mm256_permutevar8x32_epi32(oVisivel, rotacao), oVisivel);
+                const __m256i maior = _mm256_cmpgt_epi32(_mm256_permutevar8x32_epi32(DBits, rotacao),
+                                                         _mm256_add_epi32(DBits, antes));
+                perdeu = _mm256_or_si256(perdeu, _mm256_and_si256(mesma, maior));
+            }
+            const __m256 vence = _mm256_andnot_ps(_mm256_castsi256_ps(perdeu), visivel);
+
+            __m256i N = _mm256_cvttps_epi32(_mm256_sub_ps(_mm256_sub_ps(n0, _mm256_mul_ps(c, n1)), _mm256_mul_ps(l, n2)));
+            N = _mm256_min_epi32(_mm256_max_epi32(N, zero), maxN);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(os), _mm256_and_si256(o, _mm256_castps_si256(vence)));
+            _mm256_store_si256(reinterpret_cast<__m256i *>(Ns), N);
+            _mm256_store_ps(Ds, _mm256_and_ps(D, vence));
+
+            // As vencedoras têm células distintas e já passaram no teste de
+            // profundidade: só escrita, sem ler z de volta. As 8 sempre (um
+            // laço sobre os bits erraria a previsão de desvio); as que não
+            // vencem escrevem na célula 0, restaurada no fim.
+            for (int lane = 0; lane < 8; lane++)
+            {
+                z[os[lane]] = Ds[lane];
+                b[os[lane]] = GRADIENTE_DONUT[Ns[lane]];
+            }
+        }
+    }
+
+    z[0] = zCelula0;
+    b[0] = bCelula0;
+}
+
+/**
+ * @brief Lanes que perdem para a lane (k + r) % 4 (rotação 'Imediato'):
+ * mesma célula e D maior, ou igual vindo antes ('antes').
+ */
+template <int Imediato>
+__attribute__((target("sse4.1"))) static inline __m128i _perdeNaRotacao(__m128i oVisivel, __m128i DBits, __m128i antes)
+{
+    const __m128i mesma = _mm_cmpeq_epi32(_mm_shuffle_epi32(oVisivel, Imediato), oVisivel);
+    const __m128i maior = _mm_cmpgt_epi32(_mm_shuffle_epi32(DBits, Imediato), _mm_add_epi32(DBits, antes));
+    return _mm_and_si128(mesma, maior);
+}
+
+__attribute__((target("sse4.1"))) static void _kernelDonutSSE4(const TabelasDonut &tabelas, const ParametrosDonut &p,
+                                                                int jInicio, int jFim, char *b, float *z)
+{
+    const __m128 cx = _mm_set1_ps((float)(p.largura / 2));
+    const __m128 cy = _mm_set1_ps((float)(p.altura / 2));
+    const __m128 escalaX = _mm_set1_ps(p.escalaX);
+    const __m128 escalaY = _mm_set1_ps(p.escalaY);
+    const __m128 senB = _mm_set1_ps(p.senB);
+    const __m128 cosB = _mm_set1_ps(p.cosB);
+    const __m128 um = _mm_set1_ps(1.0f);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i largura = _mm_set1_epi32(p.largura);
+    const __m128i altura = _mm_set1_epi32(p.altura);
+    const __m128i maxN = _mm_set1_epi32(MAX_LUMINANCIA_DONUT);
+    const __m128i todos = _mm_set1_epi32(-1);
+
+    alignas(16) int os[4], Ns[4];
+    alignas(16) float Ds[4];
+
+    const float zCelula0 = z[0];
+    const char bCelula0 = b[0];
+
+    for (int j = jInicio; j < jFim; j++)
+    {
+        const CoeficientesJ k = _coeficientesJ(p, tabelas.senJ[j], tabelas.cosJ[j]);
+        const __m128 k0 = _mm_set1_ps(k.k0), k1 = _mm_set1_ps(k.k1), k2 = _mm_set1_ps(k.k2);
+        const __m128 k3 = _mm_set1_ps(k.k3), k4 = _mm_set1_ps(k.k4), k5 = _mm_set1_ps(k.k5);
+        const __m128 n0 = _mm_set1_ps(k.n0), n1 = _mm_set1_ps(k.n1), n2 = _mm_set1_ps(k.n2);
+
+        for (int i = 0; i < tabelas.numI; i += 4)
+        {
+            const __m128 c = _mm_loadu_ps(&tabelas.senI[i]);
+            const __m128 l = _mm_loadu_ps(&tabelas.cosI[i]);
+
+            __m128 D = _mm_div_ps(um, _mm_add_ps(_mm_mul_ps(c, k1), k0));
+            __m128 t = _mm_sub_ps(_mm_mul_ps(c, k2), k3);
+            __m128 px = _mm_sub_ps(_mm_mul_ps(l, k4), _mm_mul_ps(t, senB));
+            __m128 py = _mm_add_ps(_mm_mul_ps(l, k5), _mm_mul_ps(t, cosB));
+            __m128i x = _mm_cvttps_epi32(_mm_add_ps(cx, _mm_mul_ps(_mm_mul_ps(escalaX, D), px)));
+            __m128i y = _mm_cvttps_epi32(_mm_add_ps(cy, _mm_mul_ps(_mm_mul_ps(escalaY, D), py)));
+
+            __m128i dentro = _mm_and_si128(
+                _mm_and_si128(_mm_cmpgt_epi32(x, zero), _mm_cmpgt_epi32(largura, x)),
+                _mm_and_si128(_mm_cmpgt_epi32(y, zero), _mm_cmpgt_epi32(altura, y)));
+            int restantes = tabelas.numI - i;
+            if (restantes < 4)
+                dentro = _mm_and_si128(dentro, _mm_cmpgt_epi32(_mm_set1_epi32(restantes), _mm_setr_epi32(0, 1, 2, 3)));
+            if (_mm_movemask_ps(_mm_castsi128_ps(dentro)) == 0)
+                continue;
+
+            // Sem gather no SSE4.1: quatro leituras, com o = 0 fora da tela
+            __m128i o = _mm_add_epi32(x, _mm_mullo_epi32(y, largura));
+            _mm_store_si128(reinterpret_cast<__m128i *>(os), _mm_and_si128(o, dentro));
+            const __m128 zAtual = _mm_setr_ps(z[os[0]], z[os[1]], z[os[2]], z[os[3]]);
+            const __m128 visivel = _mm_and_ps(_mm_cmpgt_ps(D, zAtual), _mm_castsi128_ps(dentro));
+            if (_mm_movemask_ps(visivel) == 0)
+                continue;
+
+            // Mesma resolução de células repetidas do AVX2, com 3 rotações
+            const __m128i oVisivel = _mm_or_si128(o, _mm_xor_si128(_mm_castps_si128(visivel), todos));
+            const __m128i DBits = _mm_castps_si128(D);
+            const __m128i perdeu = _mm_or_si128(
+                _mm_or_si128(_perdeNaRotacao<_MM_SHUFFLE(0, 3, 2, 1)>(oVisivel, DBits, _mm_setr_epi32(0, 0, 0, -1)),
+                             _perdeNaRotacao<_MM_SHUFFLE(1, 0, 3, 2)>(oVisivel, DBits, _mm_setr_epi32(0, 0, -1, -1))),
+                _perdeNaRotacao<_MM_SHUFFLE(2, 1, 0, 3)>(oVisivel, DBits, _mm_setr_epi32(0, -1, -1, -1)));
+            const __m128 vence = _mm_andnot_ps(_mm_castsi128_ps(perdeu), visivel);
+
+            __m128i N = _mm_cvttps_epi32(_mm_sub_ps(_mm_sub_ps(n0, _mm_mul_ps(c, n1)), _mm_mul_ps(l, n2)));
+            N = _mm_min_epi32(_mm_max_epi32(N, zero), maxN);
+            _mm_store_si128(reinterpret_cast<__m128i *>(os), _mm_and_si128(o, _mm_castps_si128(vence)));
+            _mm_store_si128(reinterpret_cast<__m128i *>(Ns), N);
+            _mm_store_ps(Ds, _mm_and_ps(D, vence));
+
+            for (int lane = 0; lane < 4; lane++)
+            {
+                z[os[lane]] = Ds[lane];
+                b[os[lane]] = GRADIENTE_DONUT[Ns[lane]];
+            }
+        }
+    }
+
+    z[0] = zCelula0;
+    b[0] = bCelula0;
+}
+
+#endif // DONUT_KERNEL_X86
+
+std::vector<OpcaoKernelDonut> kernelsDonutSuportados()
+{
+    std::vector<OpcaoKernelDonut> kernels;
+#ifdef DONUT_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back({"avx2", _kernelDonutAVX2});
+    if (__builtin_cpu_supports("sse4.1"))
+        kernels.push_back({"sse4.1", _kernelDonutSSE4});
+#endif
+    kernels.push_back({"escalar", kernelDonutEscalar});
+    return kernels;
+}
+
+KernelDonut selecionarKernelDonut()
+{
+    return kernelsDonutSuportados().front().kernel;
+}
+
+const char *nomeKernelDonut()
+{
+    return kernelsDonutSuportados().front().nome;
+}
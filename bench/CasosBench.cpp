@@ -0,0 +1,1354 @@
+#include "SuiteBench.h"
+
+#include <algorithm> // Para std::fill
+#include <atomic>
+#include <chrono>
+#include <cmath>  // Para sin() e cos()
+#include <cstdio> // Para std::remove
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h> // getrusage(RUSAGE_THREAD)
+
+#include "../app/donut.h"
+#include "../buffer/BufferDeEntradaOS.h"
+#include "../buffer/CodificadorANSI.h"
+#include "../buffer/FileFrameBuffer.h"
+#include "../buffer/FrameBufferChecksum.h"
+#include "../buffer/FrameBufferNulo.h"
+#include "../buffer/GravadorFrameBuffer.h"
+#include "../buffer/MmapFrameBuffer.h"
+#include "../cpu/cpu.h"
+#include "../disco/DiscoArquivo.h"
+#include "../dma/ControladorDMA.h"
+#include "../kernel/Escalonador.h"
+#include "../kernel/EscalonadorSMP.h"
+#include "../smp/MaquinaSMP.h"
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+#include "../pic/ControladorPIC.h"
+#include "../placa/PlacaEstatica.h"
+#include "../teclado/teclado.h"
+#include "../timer/TimerPIT.h"
+
+// Casos do modo --bench. Os logs ficam desligados (Logger não iniciado),
+// exceto no caso do próprio logger: cada caso mede só a sua camada.
+
+namespace
+{
+    const char *const ARQUIVO_BENCH_SHM = "sim_bench_frame.shm";
+    const char *const ARQUIVO_BENCH_TXT = "sim_bench_frame.txt";
+    const char *const ARQUIVO_BENCH_LOG = "sim_bench_logs.bin";
+    const char *const ARQUIVO_BENCH_DISCO = "sim_bench_disco.img";
+    const char *const ARQUIVO_BENCH_GRAVACAO = "sim_bench_gravacao.bin";
+    const char *const ARQUIVO_BENCH_METRICAS = "sim_bench_metricas.shm";
+
+    /**
+     * @brief Aplicação que não faz nada: sobra só o custo do tick.
+     * ('final': na composição estática a chamada vira inline)
+     */
+    class AppOciosa final : public IAplicacao
+    {
+    public:
+        uint64_t ticks = 0;
+        void conectar(BufferDeEntradaOS *, IFrameBuffer *) override {}
+        void executarTick() override { ticks++; }
+    };
+
+    /**
+     * @brief Aplicação sem trabalho nenhum: todo tick sem IRQ vira HLT.
+     */
+    class AppParada : public IAplicacao
+    {
+    public:
+        void conectar(BufferDeEntradaOS *, IFrameBuffer *) override {}
+        void executarTick() override {}
+        bool temTrabalho() const override { return false; }
+    };
+
+    /**
+     * @brief Controlador que sempre tem a mesma linha pronta: tira o
+     * custo do PIC da conta e deixa só o despacho pela IDT.
+     */
+    class ControladorFixo : public IControladorIRQ
+    {
+    public:
+        int linha = 1;
+        int verificarInterrupcoes() override { return linha; }
+    };
+
+    /**
+     * @brief A IDT como era antes do vetor plano: std::map de
+     * std::function, com count() + operator[] e cópia a cada IRQ.
+     * O tick é o do NucleoCPU (mesmos logs, span, EOI e ramo sem IRQ):
+     * só a consulta à IDT muda, para o caso comparar a mesma operação.
+     * Mantida só como referência de comparação.
+     */
+    struct CPUIDTMapReferencia
+    {
+        IControladorIRQ &controlador;
+        IAplicacao *aplicacao = nullptr;
+        std::map<int, std::function<void()>> idt;
+
+        explicit CPUIDTMapReferencia(IControladorIRQ &c) : controlador(c) {}
+
+        void tick()
+        {
+            int linhaAtiva = controlador.verificarInterrupcoes();
+
+            if (linhaAtiva != -1)
+            {
+                SIM_LOG(LOG_DEBUG, "CPU", "Interrupção detectada! (IRQ {}). Pausando trabalho.", linhaAtiva);
+
+                if (idt.count(linhaAtiva))
+                {
+                    std::function<void()> isr = idt[linhaAtiva];
+                    SIM_LOG(LOG_DEBUG, "CPU", "Despachando para ISR...");
+                    SIM_SPAN("cpu", "isr");
+                    isr();
+                    SIM_LOG(LOG_DEBUG, "CPU", "ISR concluído. Retomando...");
+                }
+                else
+                {
+                    SIM_LOG(LOG_AVISO, "CPU", "AVISO: IRQ {} disparada, mas NENHUM ISR registrado.", linhaAtiva);
+                }
+
+                controlador.finalizarInterrupcao(linhaAtiva);
+            }
+            else if (aplicacao != nullptr && aplicacao->temTrabalho())
+            {
+                SIM_SPAN("cpu", "aplicacao");
+                aplicacao->executarTick();
+            }
+        }
+    };
+
+    /**
+     * @brief Fila de teclas ingênua (mutex + std::queue), referência
+     * para o anel SPSC do BufferDeEntradaOS.
+     */
+    struct FilaMutexReferencia
+    {
+        std::mutex mutex;
+        std::queue<char, std::deque<char>> fila;
+
+        void enfileirar(char c)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fila.push(c);
+        }
+        char desenfileirar()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fila.empty())
+                return 0;
+            char c = fila.front();
+            fila.pop();
+            return c;
+        }
+    };
+
+    /**
+     * @brief Guarda uma cópia de cada frame de células que recebe: os
+     * casos "ansi/" codificam os mesmos frames, sem o render no meio.
+     */
+    class CapturaCelulas : public IFrameBuffer
+    {
+    public:
+        std::vector<FrameCelulas> frames;
+        void atualizar(const std::string &) override {}
+        void atualizarCelulas(const FrameCelulas &celulas) override { frames.push_back(celulas); }
+        void limpar() override {}
+    };
+
+    /**
+     * @brief Codificação ingênua, a referência dos casos "ansi/": cada
+     * célula alterada com o seu salto absoluto e o SGR completo.
+     */
+    size_t _codificarIngenuo(const FrameCelulas &anterior, const FrameCelulas &novo, std::string &saida)
+    {
+        size_t escritas = 0;
+        char sequencia[80];
+        for (int linha = 0; linha < novo.altura; linha++)
+        {
+            for (int coluna = 0; coluna < novo.largura; coluna++)
+            {
+                const size_t o = (size_t)linha * novo.largura + coluna;
+                if (anterior.igual(o, novo))
+                    continue;
+                const uint32_t f = novo.frente[o], b = novo.fundo[o];
+                int n = std::snprintf(sequencia, sizeof(sequencia), "\x1b[%d;%dH\x1b[38;2;%u;%u;%u;48;2;%u;%u;%um%c",
+                                      linha + 1, coluna + 1, (f >> 16) & 0xFF, (f >> 8) & 0xFF, f & 0xFF,
+                                      (b >> 16) & 0xFF, (b >> 8) & 0xFF, b & 0xFF, novo.glifos[o]);
+                saida.append(sequencia, (size_t)n);
+                escritas++;
+            }
+        }
+        return escritas;
+    }
+
+    // Tempo de CPU (usuário + sistema) gasto pela thread que chama
+    uint64_t _tempoCpuThreadNs()
+    {
+        rusage uso;
+        getrusage(RUSAGE_THREAD, &uso);
+        return (uint64_t)(uso.ru_utime.tv_sec + uso.ru_stime.tv_sec) * 1000000000ull +
+               (uint64_t)(uso.ru_utime.tv_usec + uso.ru_stime.tv_usec) * 1000ull;
+    }
+
+    // Um frame no formato da AppDonut ("\x1b[H" + altura linhas de largura + '\n')
+    std::string _frameDeTeste(char preenchimento, int largura = LARGURA_PADRAO_DONUT, int altura = ALTURA_PADRAO_DONUT)
+    {
+        std::string frame = "\x1b[H";
+        for (int y = 0; y < altura; y++)
+        {
+            frame.append(largura, preenchimento);
+            frame += '\n';
+        }
+        return frame;
+    }
+
+    // Escala 1, 2, 4, ... e termina exatamente no máximo (ex: 1, 2, 4, 6)
+    int _proximoPasso(int atual, int maximo)
+    {
+        if (atual < maximo && atual * 2 > maximo)
+            return maximo;
+        return atual * 2;
+    }
+
+    // ---------------------------------------------------------------
+
+    void _benchRender(SuiteBench &suite)
+    {
+        // Threads x resolução: no 80x24 o frame é pequeno demais para o
+        // pool compensar a sincronização; 400x200 e 1000x500 mostram a escala
+        static const int RESOLUCOES[][2] = {{LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT}, {400, 200}, {1000, 500}};
+        const int maxThreads = suite.config().maxNucleos;
+        for (const auto &resolucao : RESOLUCOES)
+        {
+            const int largura = resolucao[0], altura = resolucao[1];
+            const bool padrao = largura == LARGURA_PADRAO_DONUT && altura == ALTURA_PADRAO_DONUT;
+            const std::string prefixo = padrao ? "donut_frame/"
+                                               : "donut_frame/" + std::to_string(largura) + "x" + std::to_string(altura) + "/";
+
+            for (int threads = 1; threads <= maxThreads; threads = _proximoPasso(threads, maxThreads))
+            {
+                std::string nome = prefixo + "threads=" + std::to_string(threads);
+                if (!suite.selecionado(nome))
+                    continue;
+
+                BufferDeEntradaOS entrada;
+                FrameBufferNulo tela;
+                AppDonut app(threads, largura, altura);
+                app.conectar(&entrada, &tela);
+                // Dá velocidade ao donut: todo frame é diferente do anterior
+                entrada.enfileirarTecla('w');
+                entrada.enfileirarTecla('a');
+
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                        app.executarTick();
+                };
+                suite.medir(nome, "frame", corpo);
+
+                // Frames/s relativos a threads=1 (se ele também foi medido)
+                const SuiteBench::Resultado *base = suite.resultado(prefixo + "threads=1");
+                const SuiteBench::Resultado *este = suite.resultado(nome);
+                if (threads > 1 && base != nullptr && este != nullptr)
+                    suite.anotar(nome + "/x_threads=1", std::to_string(base->p50 / este->p50));
+            }
+        }
+    }
+
+    // Só a rasterização do 80x24, sem pool nem framebuffer: cada kernel
+    // desta CPU contra o laço original (a meta era 10x)
+    void _benchKernelDonut(SuiteBench &suite)
+    {
+        int frame = 0;
+        auto proximoAngulo = [&frame](double &A, double &B) {
+            frame++;
+            A = frame * 0.1;
+            B = frame * 0.07;
+        };
+
+        if (suite.selecionado("donut_kernel/original"))
+        {
+            std::vector<char> b;
+            auto corpo = [&](uint64_t n) {
+                double A, B;
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    proximoAngulo(A, B);
+                    renderizarDonutOriginal(A, B, b);
+                }
+                naoOtimizar(b);
+            };
+            suite.medir("donut_kernel/original", "frame", corpo);
+        }
+
+        TabelasDonut tabelas;
+        construirTabelasDonut(tabelas, 0.02, 0.07);
+        std::vector<char> b(80 * 24);
+        std::vector<float> z(80 * 24);
+        for (const OpcaoKernelDonut &opcao : kernelsDonutSuportados())
+        {
+            const std::string nome = std::string("donut_kernel/") + opcao.nome;
+            if (!suite.selecionado(nome))
+                continue;
+
+            auto corpo = [&](uint64_t n) {
+                double A, B;
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    proximoAngulo(A, B);
+                    ParametrosDonut p = {(float)sin(A), (float)cos(A), (float)sin(B), (float)cos(B), 80, 24, 30.0f, 15.0f};
+                    std::fill(b.begin(), b.end(), ' ');
+                    std::fill(z.begin(), z.end(), 0.0f);
+                    opcao.kernel(tabelas, p, 0, tabelas.numJ, b.data(), z.data());
+                }
+                naoOtimizar(b);
+            };
+            suite.medir(nome, "frame", corpo);
+        }
+    }
+
+    void _benchCPU(SuiteBench &suite)
+    {
+        // Sem interrupções: verificarInterrupcoes() + executarTick() vazio
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            AppOciosa app;
+            cpu.carregarAplicacao(&app);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    cpu.tick();
+            };
+            suite.medir("cpu_tick_ocioso", "tick", corpo);
+        }
+
+        // Uma IRQ por tick, ponta a ponta: elevar linha -> PIC -> IDT -> ISR -> EOI
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            auto isr = [&pic]() { pic.abaixarLinha(1); };
+            cpu.registrarISR(1, isr);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    pic.elevarLinha(1);
+                    cpu.tick();
+                }
+            };
+            suite.medir("irq_despacho/pic_completo", "irq", corpo);
+        }
+
+        // Só a IDT: um controlador que sempre aponta a linha 1 (o tick inteiro,
+        // igual ao da referência abaixo; só a consulta à IDT muda)
+        {
+            ControladorFixo controlador;
+            CPU cpu(controlador);
+            uint64_t atendidas = 0;
+            auto isr = [&controlador, &atendidas]() { atendidas += (uint64_t)controlador.linha; };
+            cpu.registrarISR(1, isr);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    cpu.tick();
+            };
+            suite.medir("irq_despacho/idt_vetor", "irq", corpo);
+            naoOtimizar(atendidas);
+        }
+
+        // O mesmo tick com a IDT antiga (std::map + std::function)
+        {
+            ControladorFixo controlador;
+            CPUIDTMapReferencia referencia(controlador);
+            uint64_t atendidas = 0;
+            referencia.idt[1] = [&controlador, &atendidas]() { atendidas += (uint64_t)controlador.linha; };
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    referencia.tick();
+            };
+            suite.medir("irq_despacho/idt_map_referencia", "irq", corpo);
+            naoOtimizar(atendidas);
+        }
+
+        // 256 linhas ocupadas, disparando em ordem espalhada
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            int linhaAtual = 0;
+            auto isr = [&pic, &linhaAtual]() { pic.abaixarLinha(linhaAtual); };
+            for (int linha = 0; linha < ControladorPIC::NUM_LINHAS; linha++)
+                cpu.registrarISR(linha, isr);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    linhaAtual = (int)((k * 97) % ControladorPIC::NUM_LINHAS);
+                    pic.elevarLinha(linhaAtual);
+                    cpu.tick();
+                }
+            };
+            suite.medir("irq_despacho/256_linhas", "irq", corpo);
+        }
+    }
+
+    void _benchComposicao(SuiteBench &suite)
+    {
+        // Mesma máquina montada pelas interfaces (CPU) e pelos tipos
+        // concretos (NucleoCPU/PlacaEstatica): o que muda é só o despacho
+
+        // Só a CPU: PIC sem IRQ + aplicação vazia
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            AppOciosa app;
+            cpu.carregarAplicacao(&app);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    cpu.tick();
+            };
+            suite.medir("composicao/cpu_dinamica", "tick", corpo);
+            naoOtimizar(app.ticks);
+        }
+        {
+            ControladorPIC pic;
+            NucleoCPU<ControladorPIC, AppOciosa> cpu(pic);
+            AppOciosa app;
+            cpu.carregarAplicacao(&app);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    cpu.tick();
+            };
+            suite.medir("composicao/cpu_estatica", "tick", corpo);
+            naoOtimizar(app.ticks);
+        }
+
+        // A placa do main (um núcleo): PIT na IRQ 0 preemptando o
+        // escalonador, teclado na IRQ 1, um processo vazio
+        {
+            TimerPIT pit;
+            HardwareTeclado teclado;
+            ControladorPIC pic;
+            CPU cpu(pic);
+            Escalonador escalonador;
+            AppOciosa app;
+            pic.registrarDispositivo(0, &pit, TipoDisparo::Borda);
+            pic.registrarDispositivo(1, &teclado);
+            pit.programar(10);
+            auto isrTimer = [&escalonador]() { escalonador.interrupcaoTimer(); };
+            cpu.registrarISR(0, isrTimer);
+            escalonador.adicionarProcesso(&app, "ociosa");
+            cpu.carregarAplicacao(&escalonador);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    pit.eventoClock();
+                    cpu.tick();
+                }
+            };
+            suite.medir("composicao/placa_dinamica", "tick", corpo);
+            naoOtimizar(app.ticks);
+        }
+        {
+            TimerPIT pit;
+            HardwareTeclado teclado;
+            Escalonador escalonador;
+            AppOciosa app;
+            PlacaEstatica<ControladorPIC, Escalonador,
+                          NaLinha<0, TimerPIT, TipoDisparo::Borda>,
+                          NaLinha<1, HardwareTeclado>> placa(escalonador, pit, teclado);
+            pit.programar(10);
+            auto isrTimer = [&escalonador]() { escalonador.interrupcaoTimer(); };
+            placa.cpu().registrarISR(0, isrTimer);
+            escalonador.adicionarProcesso(&app, "ociosa");
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    placa.tick();
+            };
+            suite.medir("composicao/placa_estatica", "tick", corpo);
+            naoOtimizar(app.ticks);
+        }
+    }
+
+    void _benchHLT(SuiteBench &suite)
+    {
+        // Ida e volta: outra thread sobe a linha -> a CPU sai do HLT -> ISR
+        if (suite.selecionado("hlt/despertar_irq"))
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            AppParada app;
+            cpu.carregarAplicacao(&app);
+            pic.configurarDisparo(1, TipoDisparo::Borda);
+
+            std::atomic<uint64_t> atendidas{0};
+            std::atomic<bool> parar{false};
+            auto isr = [&atendidas]() {
+                atendidas.fetch_add(1, std::memory_order_release);
+            };
+            cpu.registrarISR(1, isr);
+
+            std::thread threadCPU([&]() {
+                while (!parar.load(std::memory_order_acquire))
+                {
+                    cpu.tick();
+                    if (cpu.estaOciosa())
+                        cpu.aguardarInterrupcao(100);
+                }
+            });
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    uint64_t vistas = atendidas.load(std::memory_order_acquire);
+                    pic.elevarLinha(1);
+                    pic.abaixarLinha(1);
+                    while (atendidas.load(std::memory_order_acquire) == vistas)
+                        std::this_thread::yield();
+                }
+            };
+            suite.medir("hlt/despertar_irq", "irq", corpo);
+
+            parar.store(true, std::memory_order_release);
+            pic.elevarLinha(1);
+            pic.abaixarLinha(1);
+            threadCPU.join();
+
+            const ControladorPIC::EstatisticasDespertar &d = pic.estatisticasDespertar();
+            if (d.despertares > 0)
+            {
+                suite.anotar("hlt/latencia_sinal_ate_acordar_us", std::to_string(d.latenciaTotalNs / d.despertares / 1e3));
+                suite.anotar("hlt/latencia_sinal_ate_acordar_max_us", std::to_string(d.latenciaMaximaNs / 1e3));
+            }
+        }
+
+        // CPU do host gasta por uma CPU simulada sem nada a fazer durante
+        // ~300 ms: HLT (dorme no futex) vs acordar a cada 33 ms para girar
+        if (suite.selecionado("hlt/uso_cpu_ocioso"))
+        {
+            const auto janela = std::chrono::milliseconds(300);
+            auto medirUso = [&](bool usarHLT) {
+                ControladorPIC pic;
+                CPU cpu(pic);
+                AppParada app;
+                cpu.carregarAplicacao(&app);
+                double porcento = 0.0;
+
+                std::thread threadCPU([&]() {
+                    uint64_t cpuInicio = _tempoCpuThreadNs();
+                    auto inicio = std::chrono::steady_clock::now();
+                    auto fim = inicio + janela;
+                    while (std::chrono::steady_clock::now() < fim)
+                    {
+                        cpu.tick();
+                        if (usarHLT)
+                            cpu.aguardarInterrupcao((unsigned)janela.count());
+                        else
+                            std::this_thread::sleep_for(std::chrono::milliseconds(33));
+                    }
+                    double decorridoNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now() - inicio)
+                                             .count();
+                    porcento = 100.0 * (double)(_tempoCpuThreadNs() - cpuInicio) / decorridoNs;
+                });
+                threadCPU.join();
+                return porcento;
+            };
+            suite.anotar("hlt/uso_cpu_ocioso_pct", std::to_string(medirUso(true)));
+            suite.anotar("hlt/uso_cpu_polling_33ms_pct", std::to_string(medirUso(false)));
+        }
+    }
+
+    void _benchEscalonador(SuiteBench &suite)
+    {
+        // Custo do kernel por tick (timer + troca de contexto + contabilidade)
+        // e a justiça da divisão, com N processos ociosos
+        const int quantidades[] = {1, 4, 16, 64};
+        for (int numProcessos : quantidades)
+        {
+            std::string nome = "escalonador/processos=" + std::to_string(numProcessos);
+            if (!suite.selecionado(nome))
+                continue;
+
+            ControladorPIC pic;
+            CPU cpu(pic);
+            TimerPIT pit;
+            Escalonador escalonador(Escalonador::Politica::RoundRobin, 1);
+            std::vector<AppOciosa> apps(numProcessos);
+
+            pic.registrarDispositivo(0, &pit, TipoDisparo::Borda);
+            pit.programar(10);
+            auto isrTimer = [&escalonador]() { escalonador.interrupcaoTimer(); };
+            cpu.registrarISR(0, isrTimer);
+            for (int pid = 0; pid < numProcessos; pid++)
+                escalonador.adicionarProcesso(&apps[pid], "ocioso", 1);
+            cpu.carregarAplicacao(&escalonador);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    pit.eventoClock();
+                    cpu.tick();
+                }
+            };
+            suite.medir(nome, "tick", corpo);
+            suite.anotar("justica_" + nome, std::to_string(escalonador.indiceJustica()));
+        }
+    }
+
+    void _benchSMP(SuiteBench &suite)
+    {
+        // Ticks/s agregados de 1 a N núcleos, com a mesma carga: 2 donuts
+        // por núcleo do maior caso, todos disputando as filas
+        const int maxNucleos = suite.config().maxNucleos;
+        const int numProcessos = 2 * maxNucleos;
+
+        for (int nucleos = 1; nucleos <= maxNucleos; nucleos = _proximoPasso(nucleos, maxNucleos))
+        {
+            std::string nome = "smp/nucleos=" + std::to_string(nucleos);
+            if (!suite.selecionado(nome))
+                continue;
+
+            FrameBufferNulo tela;
+            std::vector<std::unique_ptr<BufferDeEntradaOS>> entradas;
+            std::vector<std::unique_ptr<AppDonut>> apps;
+            EscalonadorSMP kernel(nucleos);
+            for (int pid = 0; pid < numProcessos; pid++)
+            {
+                entradas.emplace_back(new BufferDeEntradaOS());
+                apps.emplace_back(new AppDonut(1));
+                apps.back()->conectar(entradas.back().get(), &tela);
+                entradas.back()->enfileirarTecla('w'); // Todo frame muda
+                kernel.adicionarProcesso(apps.back().get(), "donut", 1);
+            }
+            MaquinaSMP maquina(nucleos, kernel, 10);
+
+            // Uma operação = um tick de algum núcleo (ticks agregados)
+            auto corpo = [&](uint64_t n) {
+                maquina.iniciar(RelogioSimulacao::Modo::Livre, 1, RelogioSimulacao::PoliticaAtraso::Recuperar,
+                                (n + nucleos - 1) / nucleos);
+                maquina.aguardar();
+            };
+            suite.medir(nome, "tick", corpo);
+            suite.anotar("justica_" + nome, std::to_string(kernel.indiceJustica()));
+        }
+    }
+
+    void _benchTeclado(SuiteBench &suite)
+    {
+        // Caminho completo de uma tecla: hardware -> IRQ -> ISR -> fila do SO -> app
+        ControladorPIC pic;
+        CPU cpu(pic);
+        HardwareTeclado teclado;
+        BufferDeEntradaOS bufferDeEntrada;
+        pic.registrarDispositivo(1, &teclado);
+        auto isrTeclado = [&teclado, &bufferDeEntrada]() {
+            bufferDeEntrada.enfileirarTecla((char)teclado.lerDados());
+            teclado.eventoCPULeuDados();
+        };
+        cpu.registrarISR(1, isrTeclado);
+
+        const char teclas[] = "wasd";
+        char lidas[64];
+
+        auto umaPorVez = [&](uint64_t n) {
+            for (uint64_t k = 0; k < n; k++)
+            {
+                teclado.eventoUsuarioDigitou(teclas + (k & 3), 1);
+                cpu.tick();
+                bufferDeEntrada.desenfileirar(lidas, sizeof(lidas));
+            }
+        };
+        suite.medir("teclado/tecla_ate_app", "tecla", umaPorVez);
+
+        // Rajadas de 64 teclas (cabem no buffer interno de 256)
+        char rajada[64];
+        for (size_t k = 0; k < sizeof(rajada); k++)
+            rajada[k] = teclas[k & 3];
+
+        auto emRajada = [&](uint64_t n) {
+            for (uint64_t k = 0; k < n; k += 64)
+            {
+                teclado.eventoUsuarioDigitou(rajada, 64);
+                for (int t = 0; t < 64; t++)
+                    cpu.tick();
+                bufferDeEntrada.desenfileirar(lidas, sizeof(lidas));
+            }
+        };
+        suite.medir("teclado/rajada_64", "tecla", emRajada);
+    }
+
+    /**
+     * @brief Um teclado completo (hardware, PIC, CPU, fila do SO) no modo
+     * byte (limiar 0) ou FIFO, com o ISR certo para cada modo.
+     */
+    struct BancadaTeclado
+    {
+        ControladorPIC pic;
+        CPU cpu;
+        HardwareTeclado teclado;
+        BufferDeEntradaOS bufferDeEntrada;
+        bool fifo;
+
+        BancadaTeclado(size_t limiar, unsigned timeoutMs)
+            : cpu(pic), fifo(limiar > 0)
+        {
+            teclado.configurarFIFO(limiar, timeoutMs);
+            pic.registrarDispositivo(1, &teclado);
+            cpu.registrarISR(1, &BancadaTeclado::_isr, this);
+        }
+
+        static void _isr(void *contexto)
+        {
+            BancadaTeclado *b = static_cast<BancadaTeclado *>(contexto);
+            if (b->fifo)
+            {
+                char teclas[256];
+                size_t n = b->teclado.lerFIFO(teclas, sizeof(teclas));
+                for (size_t k = 0; k < n; k++)
+                    b->bufferDeEntrada.enfileirarTecla(teclas[k]);
+                return;
+            }
+            b->bufferDeEntrada.enfileirarTecla((char)b->teclado.lerDados());
+            b->teclado.eventoCPULeuDados();
+        }
+    };
+
+    void _benchTecladoFIFO(SuiteBench &suite)
+    {
+        char lidas[256];
+        char colagem[100];
+        for (size_t k = 0; k < sizeof(colagem); k++)
+            colagem[k] = "wasd"[k & 3];
+
+        // Custo por tecla de uma colagem de 100 teclas, até a fila do SO
+        for (size_t limiar : {(size_t)0, (size_t)8})
+        {
+            std::string nome = limiar == 0 ? "teclado/colar_100/byte" : "teclado/colar_100/fifo_8";
+            if (!suite.selecionado(nome))
+                continue;
+
+            BancadaTeclado b(limiar, 2);
+            uint64_t ticks = 0;
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k += sizeof(colagem))
+                {
+                    b.teclado.eventoUsuarioDigitou(colagem, sizeof(colagem));
+                    size_t entregues = 0;
+                    while (entregues < sizeof(colagem))
+                    {
+                        b.cpu.tick();
+                        ticks++;
+                        entregues += b.bufferDeEntrada.desenfileirar(lidas, sizeof(lidas));
+                    }
+                }
+            };
+            suite.medir(nome, "tecla", corpo);
+
+            HardwareTeclado::EstatisticasEntrega e = b.teclado.estatisticasEntrega();
+            suite.anotar(nome + "/teclas_por_tick", std::to_string((double)e.teclasEntregues / (double)ticks));
+            suite.anotar(nome + "/teclas_por_irq", std::to_string((double)e.teclasEntregues / (double)e.leituras));
+        }
+
+        // Latência sob carga, em tempo real: um "usuário" digita 2000 teclas/s
+        // enquanto a CPU roda a 1 kHz (headless com passo de 1 ms)
+        if (suite.selecionado("teclado/latencia_sob_carga"))
+        {
+            for (size_t limiar : {(size_t)0, (size_t)8})
+            {
+                BancadaTeclado b(limiar, 2);
+                std::atomic<bool> parar{false};
+                std::thread usuario([&]() {
+                    uint64_t k = 0;
+                    while (!parar.load(std::memory_order_acquire))
+                    {
+                        b.teclado.eventoUsuarioDigitou(colagem + (k++ & 3), 1);
+                        b.teclado.verificarTimeout();
+                        std::this_thread::sleep_for(std::chrono::microseconds(500));
+                    }
+                });
+
+                uint64_t ticks = 0;
+                auto fim = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+                while (std::chrono::steady_clock::now() < fim)
+                {
+                    b.cpu.tick();
+                    ticks++;
+                    b.bufferDeEntrada.desenfileirar(lidas, sizeof(lidas));
+                    b.teclado.verificarTimeout();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                parar.store(true, std::memory_order_release);
+                usuario.join();
+
+                HardwareTeclado::EstatisticasEntrega e = b.teclado.estatisticasEntrega();
+                std::string prefixo = limiar == 0 ? "teclado/latencia_sob_carga/byte" : "teclado/latencia_sob_carga/fifo_8";
+                suite.anotar(prefixo + "/teclas_por_tick", std::to_string((double)e.teclasEntregues / (double)ticks));
+                if (e.teclasEntregues > 0)
+                {
+                    suite.anotar(prefixo + "/latencia_media_us", std::to_string(e.latenciaTotalNs / e.teclasEntregues / 1e3));
+                    suite.anotar(prefixo + "/latencia_max_us", std::to_string(e.latenciaMaximaNs / 1e3));
+                }
+                suite.anotar(prefixo + "/descartadas", std::to_string(b.teclado.totalTeclasDescartadas()));
+            }
+        }
+    }
+
+    void _benchDMA(SuiteBench &suite)
+    {
+        // 64 KiB por operação: um bloco por DMA (uma IRQ) vs um byte por IRQ
+        const size_t BYTES_POR_OPERACAO = 64 * 1024;
+        const size_t TAMANHO_BLOCO = 512;
+        const uint32_t BLOCOS_POR_OPERACAO = (uint32_t)(BYTES_POR_OPERACAO / TAMANHO_BLOCO);
+        std::vector<char> destino(BYTES_POR_OPERACAO);
+
+        if (suite.selecionado("dma/disco_64k"))
+        {
+            std::remove(ARQUIVO_BENCH_DISCO);
+            {
+                ControladorPIC pic;
+                CPU cpu(pic);
+                AppParada app;
+                cpu.carregarAplicacao(&app);
+                ControladorDMA dma;
+                pic.registrarDispositivo(3, &dma);
+                DiscoArquivo disco(ARQUIVO_BENCH_DISCO, dma, 0, TAMANHO_BLOCO, 64 * BLOCOS_POR_OPERACAO);
+
+                bool concluido = false;
+                uint64_t irqs = 0;
+                auto isrDMA = [&dma, &concluido, &irqs]() {
+                    irqs++;
+                    if (dma.reconhecer() & 1)
+                        concluido = true;
+                };
+                cpu.registrarISR(3, isrDMA);
+
+                uint64_t lba = 0;
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                    {
+                        concluido = false;
+                        disco.lerBlocos(lba, BLOCOS_POR_OPERACAO, destino.data());
+                        lba = (lba + BLOCOS_POR_OPERACAO) % disco.totalBlocos();
+                        // A CPU não participa da cópia: fica em HLT até a IRQ de conclusão
+                        while (!concluido)
+                        {
+                            cpu.tick();
+                            if (cpu.estaOciosa())
+                                cpu.aguardarInterrupcao(100);
+                        }
+                    }
+                };
+                suite.medir("dma/disco_64k", "64KiB", corpo);
+
+                ControladorDMA::Estatisticas e = dma.estatisticas();
+                if (e.tempoCopiandoNs > 0)
+                    suite.anotar("dma/disco_64k/MB_s_no_motor", std::to_string((double)e.bytes / (double)e.tempoCopiandoNs * 1e3));
+                suite.anotar("dma/disco_64k/irqs_por_64KiB", std::to_string((double)irqs / (double)e.transferencias));
+            }
+            std::remove(ARQUIVO_BENCH_DISCO);
+        }
+
+        // Referência: os mesmos 64 KiB por E/S programada, uma IRQ por byte
+        // (o caminho do teclado no modo byte, com ISR copiando para a memória)
+        if (suite.selecionado("dma/pio_por_byte_64k"))
+        {
+            ControladorPIC pic;
+            CPU cpu(pic);
+            HardwareTeclado uart;
+            pic.registrarDispositivo(1, &uart);
+            std::vector<char> origem(BYTES_POR_OPERACAO, 'w');
+
+            size_t posicao = 0;
+            auto isrByte = [&]() {
+                destino[posicao++] = (char)uart.lerDados();
+                uart.eventoCPULeuDados();
+            };
+            cpu.registrarISR(1, isrByte);
+
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    posicao = 0;
+                    // O buffer interno tem 256 bytes: alimenta em pedaços
+                    for (size_t inicio = 0; inicio < BYTES_POR_OPERACAO; inicio += 256)
+                    {
+                        uart.eventoUsuarioDigitou(origem.data() + inicio, 256);
+                        for (int t = 0; t < 256; t++)
+                            cpu.tick();
+                    }
+                }
+            };
+            suite.medir("dma/pio_por_byte_64k", "64KiB", corpo);
+            suite.anotar("dma/pio_por_byte_64k/irqs_por_64KiB", std::to_string(BYTES_POR_OPERACAO));
+        }
+    }
+
+    void _benchFilas(SuiteBench &suite)
+    {
+        BufferDeEntradaOS anel;
+        auto corpoAnel = [&](uint64_t n) {
+            char c = 0;
+            for (uint64_t k = 0; k < n; k++)
+            {
+                anel.enfileirarTecla((char)k);
+                c ^= anel.desenfileirarTecla();
+            }
+            naoOtimizar(c);
+        };
+        suite.medir("fila/spsc_anel", "tecla", corpoAnel);
+
+        FilaMutexReferencia fila;
+        auto corpoFila = [&](uint64_t n) {
+            char c = 0;
+            for (uint64_t k = 0; k < n; k++)
+            {
+                fila.enfileirar((char)k);
+                c ^= fila.desenfileirar();
+            }
+            naoOtimizar(c);
+        };
+        suite.medir("fila/mutex_referencia", "tecla", corpoFila);
+    }
+
+    void _benchFrameBuffers(SuiteBench &suite)
+    {
+        const int W = LARGURA_PADRAO_DONUT, H = ALTURA_PADRAO_DONUT;
+        std::string frames[2] = {_frameDeTeste('.'), _frameDeTeste('#')};
+
+        // Uma linha muda por frame (o caso típico do donut girando devagar)
+        std::string parcial = frames[0];
+        RegiaoSuja regiao;
+        regiao.tamanho = W;
+
+        {
+            MmapFrameBuffer mmap(ARQUIVO_BENCH_SHM, W, H);
+            auto completo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    mmap.atualizar(frames[k & 1]);
+            };
+            suite.medir("framebuffer/mmap_completo", "frame", completo);
+
+            auto regioes = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    int linha = (int)(k % H);
+                    regiao.deslocamento = (uint32_t)(3 + linha * (W + 1));
+                    parcial[regiao.deslocamento] ^= 1;
+                    mmap.atualizarRegioes(parcial, &regiao, 1);
+                }
+            };
+            suite.medir("framebuffer/mmap_1_linha", "frame", regioes);
+        }
+
+        {
+            FileFrameBuffer arquivo(ARQUIVO_BENCH_TXT);
+            auto completo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    arquivo.atualizar(frames[k & 1]);
+            };
+            suite.medir("framebuffer/file_completo", "frame", completo);
+
+            auto regioes = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    int linha = (int)(k % H);
+                    regiao.deslocamento = (uint32_t)(3 + linha * (W + 1));
+                    parcial[regiao.deslocamento] ^= 1;
+                    arquivo.atualizarRegioes(parcial, &regiao, 1);
+                }
+            };
+            suite.medir("framebuffer/file_1_linha", "frame", regioes);
+        }
+
+        // Gravador: custo por frame e compressão (tudo muda vs uma linha muda)
+        {
+            std::unique_ptr<GravadorFrameBuffer> gravador;
+            auto preparar = [&]() {
+                gravador.reset(new GravadorFrameBuffer(ARQUIVO_BENCH_GRAVACAO, W, H));
+            };
+            auto anotarCompressao = [&](const std::string &nome) {
+                const GravadorFrameBuffer::Estatisticas &e = gravador->estatisticas();
+                if (e.bytesGravados > 0)
+                    suite.anotar(nome + "/compressao", std::to_string((double)e.bytesBrutos / (double)e.bytesGravados));
+                gravador.reset();
+            };
+
+            auto completo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                    gravador->atualizar(frames[k & 1]);
+            };
+            if (suite.selecionado("framebuffer/gravador_completo"))
+            {
+                suite.medir("framebuffer/gravador_completo", "frame", completo, preparar);
+                anotarCompressao("framebuffer/gravador_completo");
+            }
+
+            auto umaLinha = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    int linha = (int)(k % H);
+                    parcial[3 + linha * (W + 1)] ^= 1;
+                    gravador->atualizar(parcial);
+                }
+            };
+            if (suite.selecionado("framebuffer/gravador_1_linha"))
+            {
+                suite.medir("framebuffer/gravador_1_linha", "frame", umaLinha, preparar);
+                anotarCompressao("framebuffer/gravador_1_linha");
+            }
+        }
+
+        std::remove(ARQUIVO_BENCH_SHM);
+        std::remove(ARQUIVO_BENCH_TXT);
+        std::remove(ARQUIVO_BENCH_GRAVACAO);
+    }
+
+    // Como o custo do frame cresce com o número de células: o render
+    // (projeção e amostragem escalam com a grade) e a publicação no mmap
+    void _benchResolucao(SuiteBench &suite)
+    {
+        static const int RESOLUCOES[][2] = {{80, 24}, {400, 200}, {1000, 500}};
+        for (const auto &resolucao : RESOLUCOES)
+        {
+            const int largura = resolucao[0], altura = resolucao[1];
+            const std::string sufixo = std::to_string(largura) + "x" + std::to_string(altura);
+            const std::string nomeRender = "resolucao/render_" + sufixo;
+            const std::string nomeCompleto = "resolucao/mmap_completo_" + sufixo;
+            const std::string nomeDonut = "resolucao/donut_mmap_" + sufixo;
+            if (!suite.selecionado(nomeRender) && !suite.selecionado(nomeCompleto) && !suite.selecionado(nomeDonut))
+                continue;
+            suite.anotar("resolucao/celulas_" + sufixo, std::to_string(largura * altura));
+
+            // Só o render (e o delta), numa tela nula; o donut girando muda todo frame
+            {
+                BufferDeEntradaOS entrada;
+                FrameBufferNulo tela;
+                AppDonut app(1, largura, altura);
+                app.conectar(&entrada, &tela);
+                entrada.enfileirarTecla('w');
+                entrada.enfileirarTecla('a');
+
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                        app.executarTick();
+                };
+                suite.medir(nomeRender, "frame", corpo);
+            }
+
+            MmapFrameBuffer mmap(ARQUIVO_BENCH_SHM, largura, altura);
+
+            // Publicação do frame inteiro (o pior caso: tudo mudou)
+            {
+                std::string frames[2] = {_frameDeTeste('.', largura, altura), _frameDeTeste('#', largura, altura)};
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                        mmap.atualizar(frames[k & 1]);
+                };
+                suite.medir(nomeCompleto, "frame", corpo);
+            }
+
+            // Ponta a ponta: render + regiões sujas + publicação por blocos
+            {
+                BufferDeEntradaOS entrada;
+                AppDonut app(1, largura, altura);
+                app.conectar(&entrada, &mmap);
+                entrada.enfileirarTecla('w');
+                entrada.enfileirarTecla('a');
+
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                        app.executarTick();
+                };
+                suite.medir(nomeDonut, "frame", corpo);
+            }
+        }
+
+        // A troca de arquivo do redimensionar() (novo arquivo + rename + aviso)
+        if (suite.selecionado("resolucao/mmap_redimensionar"))
+        {
+            MmapFrameBuffer mmap(ARQUIVO_BENCH_SHM, LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT);
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    if (k & 1)
+                        mmap.redimensionar(LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT);
+                    else
+                        mmap.redimensionar(400, 200);
+                }
+            };
+            suite.medir("resolucao/mmap_redimensionar", "troca", corpo);
+        }
+
+        std::remove(ARQUIVO_BENCH_SHM);
+    }
+
+    void _benchANSI(SuiteBench &suite)
+    {
+        static const int RESOLUCOES[][2] = {{80, 24}, {400, 200}};
+        static const size_t NUM_FRAMES = 64;
+        for (const auto &resolucao : RESOLUCOES)
+        {
+            const int largura = resolucao[0], altura = resolucao[1];
+            const std::string sufixo = std::to_string(largura) + "x" + std::to_string(altura);
+            const std::string nomeDelta = "ansi/cor_delta_" + sufixo;
+            const std::string nomeCompleto = "ansi/cor_completo_" + sufixo;
+            const std::string nomeIngenuo = "ansi/ingenuo_" + sufixo;
+            if (!suite.selecionado(nomeDelta) && !suite.selecionado(nomeCompleto) && !suite.selecionado(nomeIngenuo))
+                continue;
+
+            // Frames reais do donut girando, com cor
+            CapturaCelulas captura;
+            {
+                BufferDeEntradaOS entrada;
+                AppDonut app(1, largura, altura);
+                app.usarCores(true);
+                app.conectar(&entrada, &captura);
+                entrada.enfileirarTecla('w');
+                entrada.enfileirarTecla('a');
+                for (size_t k = 0; k < NUM_FRAMES; k++)
+                    app.executarTick();
+            }
+            const std::vector<FrameCelulas> &frames = captura.frames;
+
+            // Bytes por frame de cada codificação (uma volta, fora da medição).
+            // 'sem_cor' são os mesmos frames só com os glifos: o custo da cor.
+            {
+                CodificadorANSI delta, semCor;
+                std::string saida;
+                uint64_t bytesDelta = 0, bytesSemCor = 0, bytesCompleto = 0, bytesIngenuo = 0;
+                FrameCelulas glifos;
+                for (size_t k = 0; k < NUM_FRAMES; k++)
+                {
+                    saida.clear();
+                    delta.codificar(frames[k], saida);
+                    if (k == 0)
+                        bytesCompleto = saida.size(); // O primeiro frame sai inteiro
+                    else
+                        bytesDelta += saida.size();
+
+                    glifos = frames[k];
+                    std::fill(glifos.frente.begin(), glifos.frente.end(), COR_PADRAO);
+                    saida.clear();
+                    semCor.codificar(glifos, saida);
+                    if (k > 0)
+                        bytesSemCor += saida.size();
+
+                    if (k > 0)
+                    {
+                        saida.clear();
+                        _codificarIngenuo(frames[k - 1], frames[k], saida);
+                        bytesIngenuo += saida.size();
+                    }
+                }
+                const uint64_t deltas = NUM_FRAMES - 1;
+                suite.anotar("ansi/bytes_cor_delta_" + sufixo, std::to_string(bytesDelta / deltas));
+                suite.anotar("ansi/bytes_sem_cor_delta_" + sufixo, std::to_string(bytesSemCor / deltas));
+                suite.anotar("ansi/bytes_cor_completo_" + sufixo, std::to_string(bytesCompleto));
+                suite.anotar("ansi/bytes_ingenuo_" + sufixo, std::to_string(bytesIngenuo / deltas));
+            }
+
+            std::string saida;
+            saida.reserve(frames[0].celulas() * 48);
+
+            // Só o que mudou desde o frame anterior (o caso do ./visor)
+            {
+                CodificadorANSI codificador;
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                    {
+                        saida.clear();
+                        codificador.codificar(frames[k % NUM_FRAMES], saida);
+                        naoOtimizar(saida);
+                    }
+                };
+                suite.medir(nomeDelta, "frame", corpo);
+            }
+
+            // A tela inteira a cada frame (primeiro frame, ou depois de um ESC[2J)
+            {
+                CodificadorANSI codificador;
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 0; k < n; k++)
+                    {
+                        saida.clear();
+                        codificador.invalidar();
+                        codificador.codificar(frames[k % NUM_FRAMES], saida);
+                        naoOtimizar(saida);
+                    }
+                };
+                suite.medir(nomeCompleto, "frame", corpo);
+            }
+
+            // Referência: salto e SGR completos por célula alterada
+            {
+                auto corpo = [&](uint64_t n) {
+                    for (uint64_t k = 1; k <= n; k++)
+                    {
+                        saida.clear();
+                        _codificarIngenuo(frames[(k - 1) % NUM_FRAMES], frames[k % NUM_FRAMES], saida);
+                        naoOtimizar(saida);
+                    }
+                };
+                suite.medir(nomeIngenuo, "frame", corpo);
+            }
+        }
+    }
+
+    void _benchLogger(SuiteBench &suite)
+    {
+        auto corpo = [](uint64_t n) {
+            for (uint64_t k = 0; k < n; k++)
+                SIM_LOG(LOG_INFO, "BENCH", "Registro {} de {}.", k, n);
+        };
+        suite.medir("log/sim_log_inativo", "registro", corpo);
+
+        if (!suite.selecionado("log/sim_log_ativo") || !Logger::iniciar(ARQUIVO_BENCH_LOG))
+            return;
+
+        // Lotes menores que o anel da thread (8192), com tempo para a
+        // drenagem entre repetições: mede o caminho quente, não o descarte
+        auto esperarDrenagem = [] { std::this_thread::sleep_for(std::chrono::milliseconds(25)); };
+        suite.medir("log/sim_log_ativo", "registro", corpo, esperarDrenagem, 4096);
+
+        Logger::encerrar();
+        std::remove(ARQUIVO_BENCH_LOG);
+    }
+
+    void _benchRastreio(SuiteBench &suite)
+    {
+        // Um span vazio: o custo fixo de cada SIM_SPAN (duas leituras do relógio
+        // e um registro no buffer da thread), com o rastreio desligado e ligado
+        auto corpo = [](uint64_t n) {
+            for (uint64_t k = 0; k < n; k++)
+            {
+                SIM_SPAN("bench", "span");
+                naoOtimizar(k);
+            }
+        };
+        suite.medir("rastreio/span_inativo", "span", corpo);
+
+        if (!suite.selecionado("rastreio/span_ativo"))
+            return;
+        Rastreador::iniciar();
+        suite.medir("rastreio/span_ativo", "span", corpo);
+        Rastreador::encerrar();
+    }
+
+    void _benchMetricas(SuiteBench &suite)
+    {
+        // O custo de cada ponto de métrica: um CronometroMetrica (duas leituras
+        // do relógio e uma amostra no histograma da página) e uma IRQ contada
+        auto cronometro = [](uint64_t n) {
+            for (uint64_t k = 0; k < n; k++)
+            {
+                CronometroMetrica medir(HIST_PUBLICACAO);
+                naoOtimizar(k);
+            }
+        };
+        suite.medir("metricas/cronometro_inativo", "amostra", cronometro);
+
+        if (!suite.selecionado("metricas/cronometro_ativo") && !suite.selecionado("metricas/irq"))
+            return;
+        Metricas::iniciar(ARQUIVO_BENCH_METRICAS, 0, 1);
+        suite.medir("metricas/cronometro_ativo", "amostra", cronometro);
+        auto irq = [](uint64_t n) {
+            for (uint64_t k = 0; k < n; k++)
+                Metricas::registrarIRQ(1, 100 + (k & 1023));
+        };
+        suite.medir("metricas/irq", "irq", irq);
+        Metricas::encerrar();
+        std::remove(ARQUIVO_BENCH_METRICAS);
+    }
+
+    void _benchSistema(SuiteBench &suite)
+    {
+        // A máquina inteira como na main, sem o relógio: um tick por operação
+        // e uma tecla a cada 8 ticks. Com '/reproduzivel', como no
+        // --reproduzir-entrada: tempo simulado no teclado e checksum do frame
+        for (bool reproduzivel : {false, true})
+        {
+            const std::string nome = reproduzivel ? "sistema/tick_reproduzivel" : "sistema/tick_completo";
+            if (!suite.selecionado(nome))
+                continue;
+
+            BufferDeEntradaOS bufferDeEntrada;
+            MmapFrameBuffer tela(ARQUIVO_BENCH_SHM, LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT);
+            FrameBufferChecksum telaChecksum(tela);
+            HardwareTeclado teclado;
+            ControladorPIC pic;
+            CPU cpu(pic);
+            AppDonut appDonut;
+
+            pic.registrarDispositivo(1, &teclado);
+            auto isrTeclado = [&teclado, &bufferDeEntrada]() {
+                bufferDeEntrada.enfileirarTecla((char)teclado.lerDados());
+                teclado.eventoCPULeuDados();
+            };
+            cpu.registrarISR(1, isrTeclado);
+            if (reproduzivel)
+                teclado.usarTempoSimulado();
+            appDonut.conectar(&bufferDeEntrada, reproduzivel ? static_cast<IFrameBuffer *>(&telaChecksum) : &tela);
+            cpu.carregarAplicacao(&appDonut);
+
+            const char teclas[] = "wasd";
+            uint64_t soma = 0;
+            auto corpo = [&](uint64_t n) {
+                for (uint64_t k = 0; k < n; k++)
+                {
+                    if ((k & 7) == 0)
+                        teclado.eventoUsuarioDigitou(teclas + ((k >> 3) & 3), 1);
+                    cpu.tick();
+                    if (reproduzivel)
+                    {
+                        teclado.avancarTempoSimulado(33333333);
+                        soma += telaChecksum.valor();
+                    }
+                }
+            };
+            suite.medir(nome, "tick", corpo);
+            naoOtimizar(soma);
+
+            std::remove(ARQUIVO_BENCH_SHM);
+        }
+    }
+}
+
+void executarCasosBench(SuiteBench &suite)
+{
+    _benchRender(suite);
+    _benchKernelDonut(suite);
+    _benchCPU(suite);
+    _benchComposicao(suite);
+    _benchHLT(suite);
+    _benchEscalonador(suite);
+    _benchSMP(suite);
+    _benchTeclado(suite);
+    _benchTecladoFIFO(suite);
+    _benchDMA(suite);
+    _benchFilas(suite);
+    _benchFrameBuffers(suite);
+    _benchResolucao(suite);
+    _benchANSI(suite);
+    _benchLogger(suite);
+    _benchRastreio(suite);
+    _benchMetricas(suite);
+    _benchSistema(suite);
+}
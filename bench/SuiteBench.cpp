@@ -0,0 +1,235 @@
+#include "SuiteBench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "../app/donut_kernel.h"
+
+namespace
+{
+    // Percentil por interpolação linear entre as amostras ordenadas
+    double _percentil(const std::vector<double> &ordenadas, double p)
+    {
+        if (ordenadas.empty())
+            return 0.0;
+        double posicao = p * (double)(ordenadas.size() - 1);
+        size_t abaixo = (size_t)posicao;
+        size_t acima = abaixo + 1 < ordenadas.size() ? abaixo + 1 : abaixo;
+        double fracao = posicao - (double)abaixo;
+        return ordenadas[abaixo] + (ordenadas[acima] - ordenadas[abaixo]) * fracao;
+    }
+
+    std::string _escaparJSON(const std::string &texto)
+    {
+        std::string saida;
+        for (char c : texto)
+        {
+            if (c == '"' || c == '\\')
+            {
+                saida += '\\';
+                saida += c;
+            }
+            else if ((unsigned char)c < 0x20)
+            {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", (unsigned)c);
+                saida += escape;
+            }
+            else
+            {
+                saida += c;
+            }
+        }
+        return saida;
+    }
+
+    // Escolhe a unidade mais legível para um tempo em ns
+    std::string _formatarTempo(double ns)
+    {
+        char texto[32];
+        if (ns < 1e3)
+            snprintf(texto, sizeof(texto), "%.1f ns", ns);
+        else if (ns < 1e6)
+            snprintf(texto, sizeof(texto), "%.2f us", ns / 1e3);
+        else
+            snprintf(texto, sizeof(texto), "%.2f ms", ns / 1e6);
+        return texto;
+    }
+}
+
+bool SuiteBench::selecionado(const std::string &nome) const
+{
+    return m_config.filtro.empty() || nome.find(m_config.filtro) != std::string::npos;
+}
+
+const SuiteBench::Resultado *SuiteBench::resultado(const std::string &nome) const
+{
+    for (const Resultado &r : m_resultados)
+    {
+        if (r.nome == nome)
+            return &r;
+    }
+    return nullptr;
+}
+
+void SuiteBench::anotar(const std::string &chave, const std::string &valor)
+{
+    m_ambiente.emplace_back(chave, valor);
+}
+
+void SuiteBench::_registrar(const std::string &nome, const char *unidade, uint64_t n, std::vector<double> &amostras)
+{
+    std::sort(amostras.begin(), amostras.end());
+
+    Resultado r;
+    r.nome = nome;
+    r.unidade = unidade;
+    r.operacoesPorRepeticao = n;
+    r.minimo = amostras.front();
+    r.maximo = amostras.back();
+    r.p50 = _percentil(amostras, 0.50);
+    r.p90 = _percentil(amostras, 0.90);
+    r.p99 = _percentil(amostras, 0.99);
+
+    double soma = 0.0;
+    for (double a : amostras)
+        soma += a;
+    r.media = soma / (double)amostras.size();
+    double somaQuadrados = 0.0;
+    for (double a : amostras)
+        somaQuadrados += (a - r.media) * (a - r.media);
+    r.desvioPadrao = amostras.size() > 1 ? std::sqrt(somaQuadrados / (double)(amostras.size() - 1)) : 0.0;
+    r.nsPorOperacao = amostras;
+
+    // Progresso: uma linha por caso assim que ele termina
+    std::cout << std::left << std::setw(40) << r.nome
+              << " p50 " << std::setw(11) << _formatarTempo(r.p50)
+              << " p99 " << std::setw(11) << _formatarTempo(r.p99)
+              << std::fixed << std::setprecision(1) << " " << 1e9 / r.p50 << " " << r.unidade << "/s"
+              << std::defaultfloat << std::endl;
+
+    m_resultados.push_back(r);
+}
+
+void SuiteBench::escreverTabela(std::ostream &saida) const
+{
+    saida << "\n"
+          << std::left << std::setw(40) << "caso"
+          << std::right << std::setw(12) << "min" << std::setw(12) << "p50" << std::setw(12) << "p90"
+          << std::setw(12) << "p99" << std::setw(12) << "max" << std::setw(10) << "desvio%"
+          << "  ops/s (p50)\n";
+
+    for (const Resultado &r : m_resultados)
+    {
+        saida << std::left << std::setw(40) << r.nome << std::right
+              << std::setw(12) << _formatarTempo(r.minimo)
+              << std::setw(12) << _formatarTempo(r.p50)
+              << std::setw(12) << _formatarTempo(r.p90)
+              << std::setw(12) << _formatarTempo(r.p99)
+              << std::setw(12) << _formatarTempo(r.maximo)
+              << std::setw(10) << std::fixed << std::setprecision(1) << 100.0 * r.desvioPadrao / r.media
+              << "  " << 1e9 / r.p50 << " " << r.unidade << "/s" << std::defaultfloat << "\n";
+    }
+}
+
+void SuiteBench::escreverJSON(std::ostream &saida) const
+{
+    saida << "{\n  \"config\": {\"aquecimento\": " << m_config.aquecimento
+          << ", \"repeticoes\": " << m_config.repeticoes
+          << ", \"ms_minimo_por_repeticao\": " << m_config.msMinimoPorRepeticao
+          << ", \"filtro\": \"" << _escaparJSON(m_config.filtro) << "\""
+          << ", \"max_nucleos\": " << m_config.maxNucleos << "},\n";
+
+    saida << "  \"ambiente\": {";
+    for (size_t k = 0; k < m_ambiente.size(); k++)
+    {
+        saida << (k ? ", " : "") << "\"" << _escaparJSON(m_ambiente[k].first) << "\": \""
+              << _escaparJSON(m_ambiente[k].second) << "\"";
+    }
+    saida << "},\n  \"resultados\": [\n";
+
+    saida << std::setprecision(6);
+    for (size_t k = 0; k < m_resultados.size(); k++)
+    {
+        const Resultado &r = m_resultados[k];
+        saida << "    {\"nome\": \"" << _escaparJSON(r.nome) << "\", \"unidade\": \"" << _escaparJSON(r.unidade) << "\""
+              << ", \"operacoes_por_repeticao\": " << r.operacoesPorRepeticao
+              << ", \"ns_por_operacao\": {\"min\": " << r.minimo << ", \"p50\": " << r.p50
+              << ", \"p90\": " << r.p90 << ", \"p99\": " << r.p99 << ", \"max\": " << r.maximo
+              << ", \"media\": " << r.media << ", \"desvio\": " << r.desvioPadrao << "}"
+              << ", \"operacoes_por_segundo\": " << 1e9 / r.p50
+              << ", \"amostras_ns\": [";
+        for (size_t a = 0; a < r.nsPorOperacao.size(); a++)
+        {
+            saida << (a ? ", " : "") << r.nsPorOperacao[a];
+        }
+        saida << "]}" << (k + 1 < m_resultados.size() ? "," : "") << "\n";
+    }
+    saida << "  ]\n}\n";
+}
+
+int executarSuiteBench(int argc, char *argv[])
+{
+    SuiteBench::Config config;
+    config.maxNucleos = (int)std::thread::hardware_concurrency();
+    std::string arquivoJSON = "sim_bench.json";
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--bench")
+            continue;
+        else if (arg.rfind("--bench-filtro=", 0) == 0)
+            config.filtro = arg.substr(15);
+        else if (arg.rfind("--bench-reps=", 0) == 0 && std::atoi(arg.c_str() + 13) > 0)
+            config.repeticoes = std::atoi(arg.c_str() + 13);
+        else if (arg.rfind("--bench-aquecimento=", 0) == 0)
+            config.aquecimento = std::atoi(arg.c_str() + 20);
+        else if (arg.rfind("--bench-ms=", 0) == 0 && std::atof(arg.c_str() + 11) > 0.0)
+            config.msMinimoPorRepeticao = std::atof(arg.c_str() + 11);
+        else if (arg.rfind("--bench-nucleos=", 0) == 0 && std::atoi(arg.c_str() + 16) > 0)
+            config.maxNucleos = std::atoi(arg.c_str() + 16);
+        else if (arg.rfind("--bench-json=", 0) == 0)
+            arquivoJSON = arg.substr(13);
+        else
+        {
+            std::cerr << "Argumento desconhecido no modo --bench: " << arg << std::endl;
+            std::cerr << "Uso: " << argv[0] << " --bench [--bench-filtro=TEXTO] [--bench-reps=N]"
+                      << " [--bench-aquecimento=N] [--bench-ms=N] [--bench-json=ARQUIVO] [--bench-nucleos=N]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.maxNucleos < 1)
+        config.maxNucleos = 1;
+
+    SuiteBench suite(config);
+    suite.anotar("kernel_donut", nomeKernelDonut());
+    suite.anotar("threads_hardware", std::to_string(std::thread::hardware_concurrency()));
+#ifdef __VERSION__
+    suite.anotar("compilador", __VERSION__);
+#endif
+
+    std::cout << "--- BENCHMARKS (" << config.repeticoes << " repetições, " << config.aquecimento
+              << " de aquecimento, >= " << config.msMinimoPorRepeticao << " ms cada) ---" << std::endl;
+
+    executarCasosBench(suite);
+
+    suite.escreverTabela(std::cout);
+
+    std::ofstream json(arquivoJSON, std::ios::trunc);
+    if (!json.is_open())
+    {
+        std::cerr << "Erro: Não foi possível criar " << arquivoJSON << std::endl;
+        return 1;
+    }
+    suite.escreverJSON(json);
+    std::cout << "\nResultados gravados em " << arquivoJSON << std::endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#ifndef SUITE_BENCH_H
+#define SUITE_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Impede o compilador de descartar um valor calculado no bench.
+ */
+template <typename T>
+inline void naoOtimizar(T &valor)
+{
+    asm volatile("" : "+m"(valor) : : "memory");
+}
+
+/**
+ * @class SuiteBench
+ * @brief Executor de microbenchmarks do modo --bench.
+ *
+ * Cada caso é um chamável corpo(n) que executa 'n' operações.
+ * O executor calibra 'n' até uma repetição durar pelo menos
+ * msMinimoPorRepeticao, roda as repetições de aquecimento (descartadas)
+ * e então as medidas. O resultado é o tempo por operação em cada
+ * repetição, resumido em percentis (tabela no terminal e JSON).
+ */
+class SuiteBench
+{
+public:
+    struct Config
+    {
+        int aquecimento = 3;
+        int repeticoes = 20;
+        double msMinimoPorRepeticao = 20.0;
+        std::string filtro; // Só roda casos cujo nome contém o filtro
+        int maxNucleos = 0; // Threads/núcleos nos casos que escalam (0 = todos do host)
+    };
+
+    struct Resultado
+    {
+        std::string nome;
+        std::string unidade;     // O que é "uma operação" (frame, tick, tecla...)
+        uint64_t operacoesPorRepeticao;
+        std::vector<double> nsPorOperacao; // Uma amostra por repetição (ordenada)
+        double minimo, p50, p90, p99, maximo, media, desvioPadrao;
+    };
+
+    explicit SuiteBench(const Config &config) : m_config(config) {}
+
+    bool selecionado(const std::string &nome) const;
+    const Config &config() const { return m_config; }
+
+    /**
+     * @brief Mede 'corpo' se o nome passar no filtro.
+     * @param preparar Chamado antes de cada repetição, fora da medição.
+     * @param operacoesFixas Se > 0, pula a calibração e usa este 'n'.
+     */
+    template <typename F, typename P>
+    void medir(const std::string &nome, const char *unidade, F &corpo, P &preparar, uint64_t operacoesFixas = 0)
+    {
+        if (!selecionado(nome))
+            return;
+
+        uint64_t n = operacoesFixas > 0 ? operacoesFixas : _calibrar(corpo, preparar);
+        for (int k = 0; k < m_config.aquecimento; k++)
+        {
+            preparar();
+            corpo(n);
+        }
+
+        std::vector<double> amostras;
+        amostras.reserve(m_config.repeticoes);
+        for (int k = 0; k < m_config.repeticoes; k++)
+        {
+            preparar();
+            auto inicio = Relogio::now();
+            corpo(n);
+            auto fim = Relogio::now();
+            amostras.push_back(std::chrono::duration<double, std::nano>(fim - inicio).count() / (double)n);
+        }
+        _registrar(nome, unidade, n, amostras);
+    }
+
+    template <typename F>
+    void medir(const std::string &nome, const char *unidade, F &corpo, uint64_t operacoesFixas = 0)
+    {
+        auto nada = [] {};
+        medir(nome, unidade, corpo, nada, operacoesFixas);
+    }
+
+    /**
+     * @brief O resultado de um caso já medido, ou nullptr.
+     */
+    const Resultado *resultado(const std::string &nome) const;
+
+    /**
+     * @brief Anota um par chave/valor do ambiente (vai para o JSON).
+     */
+    void anotar(const std::string &chave, const std::string &valor);
+
+    void escreverTabela(std::ostream &saida) const;
+    void escreverJSON(std::ostream &saida) const;
+
+private:
+    typedef std::chrono::steady_clock Relogio;
+
+    Config m_config;
+    std::vector<Resultado> m_resultados;
+    std::vector<std::pair<std::string, std::string>> m_ambiente;
+
+    template <typename F, typename P>
+    uint64_t _calibrar(F &corpo, P &preparar)
+    {
+        const double alvoNs = m_config.msMinimoPorRepeticao * 1e6;
+        uint64_t n = 1;
+        while (true)
+        {
+            preparar();
+            auto inicio = Relogio::now();
+            corpo(n);
+            double ns = std::chrono::duration<double, std::nano>(Relogio::now() - inicio).count();
+            if (ns >= alvoNs || n >= (1ull << 40))
+                return n;
+
+            // Cresce de 2x a 10x, mirando um pouco acima do alvo
+            double fator = ns > 0.0 ? alvoNs * 1.2 / ns : 10.0;
+            fator = fator < 2.0 ? 2.0 : (fator > 10.0 ? 10.0 : fator);
+            n = (uint64_t)((double)n * fator) + 1;
+        }
+    }
+
+    void _registrar(const std::string &nome, const char *unidade, uint64_t n, std::vector<double> &amostras);
+};
+
+/**
+ * @brief Ponto de entrada do modo --bench (chamado pela main).
+ * Opções: --bench-filtro=TEXTO --bench-reps=N --bench-aquecimento=N
+ *         --bench-ms=N --bench-json=ARQUIVO --bench-nucleos=N
+ */
+int executarSuiteBench(int argc, char *argv[]);
+
+// --- Casos (bench/CasosBench.cpp) ---
+void executarCasosBench(SuiteBench &suite);
+
+#endif // SUITE_BENCH_H
@@ -1,40 +1,144 @@
 #ifndef BUFFER_ENTRADA_OS_H
 #define BUFFER_ENTRADA_OS_H
 
-#include <queue>
-#include <mutex>
+#include <atomic>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint64_t
+#include <thread>  // Para std::this_thread::yield
 
+/**
+ * @class BufferDeEntradaOS
+ * @brief Fila de teclas do "SO" entre o ISR do teclado (Produtor)
+ * e a Aplicação (Consumidor).
+ *
+ * Implementada como um anel SPSC (um produtor, um consumidor) de
+ * capacidade fixa e sem locks: o produtor só escreve em m_cauda,
+ * o consumidor só escreve em m_cabeca. Cada índice fica na sua
+ * própria linha de cache para evitar "false sharing".
+ */
 class BufferDeEntradaOS
 {
 public:
+    // Potência de 2, para que o índice seja uma máscara (e não um '%')
+    static const size_t CAPACIDADE = 1024;
+
+    /**
+     * @brief O que fazer quando o ISR enfileira com o anel cheio.
+     */
+    enum class PoliticaOverflow
+    {
+        DescartarNova, // Descarta a tecla nova e conta no m_descartadas
+        Bloquear       // Espera o consumidor liberar espaço (só se estiverem em threads diferentes!)
+    };
+
+    explicit BufferDeEntradaOS(PoliticaOverflow politica = PoliticaOverflow::DescartarNova)
+        : m_politica(politica)
+    {
+    }
+
+    BufferDeEntradaOS(const BufferDeEntradaOS &) = delete;
+    BufferDeEntradaOS &operator=(const BufferDeEntradaOS &) = delete;
+
     // Chamado pelo ISR (Produtor)
-    void enfileirarTecla(char c)
+    // @return false se a tecla foi descartada por overflow.
+    bool enfileirarTecla(char c)
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_queue.push(c);
+        const size_t cauda = m_cauda.load(std::memory_order_relaxed);
+
+        if (cauda - m_cabecaCache == CAPACIDADE)
+        {
+            // Parece cheio: relê a cabeça real do consumidor
+            m_cabecaCache = m_cabeca.load(std::memory_order_acquire);
+            while (cauda - m_cabecaCache == CAPACIDADE)
+            {
+                if (m_politica == PoliticaOverflow::DescartarNova)
+                {
+                    m_descartadas.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                std::this_thread::yield();
+                m_cabecaCache = m_cabeca.load(std::memory_order_acquire);
+            }
+        }
+
+        m_dados[cauda & MASCARA] = c;
+        m_cauda.store(cauda + 1, std::memory_order_release);
+        m_enfileiradas.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Retira até 'max' teclas de uma vez (Consumidor).
+     * Uma única leitura atômica da cauda serve para o lote inteiro.
+     * @return Quantas teclas foram copiadas para 'destino'.
+     */
+    size_t desenfileirar(char *destino, size_t max)
+    {
+        const size_t cabeca = m_cabeca.load(std::memory_order_relaxed);
+
+        if (m_caudaCache - cabeca < max)
+        {
+            m_caudaCache = m_cauda.load(std::memory_order_acquire);
+        }
+
+        size_t disponiveis = m_caudaCache - cabeca;
+        size_t n = disponiveis < max ? disponiveis : max;
+
+        for (size_t k = 0; k < n; k++)
+        {
+            destino[k] = m_dados[(cabeca + k) & MASCARA];
+        }
+
+        if (n > 0)
+        {
+            m_cabeca.store(cabeca + n, std::memory_order_release);
+        }
+        return n;
     }
 
     // Chamado pela Aplicação (Consumidor)
     char desenfileirarTecla()
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_queue.empty())
-            return 0; // 0 = Nenhuma tecla
-        char c = m_queue.front();
-        m_queue.pop();
+        char c = 0; // 0 = Nenhuma tecla
+        desenfileirar(&c, 1);
         return c;
     }
 
     // Chamado pela Aplicação (Consumidor)
     bool temDados()
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return !m_queue.empty();
+        return m_cauda.load(std::memory_order_acquire) != m_cabeca.load(std::memory_order_relaxed);
+    }
+
+    // --- Contadores (podem ser lidos de qualquer thread) ---
+    uint64_t totalEnfileiradas() const { return m_enfileiradas.load(std::memory_order_relaxed); }
+    uint64_t totalDescartadas() const { return m_descartadas.load(std::memory_order_relaxed); }
+    size_t pendentes() const
+    {
+        // A cabeça antes da cauda: a cabeça lida nunca passa da cauda lida
+        const size_t cabeca = m_cabeca.load(std::memory_order_acquire);
+        return m_cauda.load(std::memory_order_acquire) - cabeca;
     }
 
 private:
-    std::mutex m_mutex;
-    std::queue<char> m_queue;
+    static const size_t MASCARA = CAPACIDADE - 1;
+    static const size_t LINHA_CACHE = 64;
+
+    static_assert((CAPACIDADE & MASCARA) == 0, "CAPACIDADE deve ser potência de 2");
+
+    // --- Lado do Consumidor ---
+    alignas(LINHA_CACHE) std::atomic<size_t> m_cabeca{0};
+    size_t m_caudaCache = 0; // Última cauda vista (evita reler o atômico a cada tecla)
+
+    // --- Lado do Produtor ---
+    alignas(LINHA_CACHE) std::atomic<size_t> m_cauda{0};
+    size_t m_cabecaCache = 0; // Última cabeça vista
+    std::atomic<uint64_t> m_enfileiradas{0};
+    std::atomic<uint64_t> m_descartadas{0};
+
+    // --- Configuração e dados (somente leitura após a construção / anel) ---
+    alignas(LINHA_CACHE) PoliticaOverflow m_politica;
+    char m_dados[CAPACIDADE];
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,270 @@
+#include "CodificadorANSI.h"
+
+#include <cstring> // Para memcmp
+
+namespace
+{
+    /**
+     * @brief Escreve 'n' em decimal a partir de 'p' e devolve o fim.
+     */
+    inline char *escreverNumero(char *p, uint32_t n)
+    {
+        char digitos[10];
+        int k = 0;
+        do
+        {
+            digitos[k++] = (char)('0' + n % 10);
+            n /= 10;
+        } while (n != 0);
+        while (k > 0)
+            *p++ = digitos[--k];
+        return p;
+    }
+
+    inline size_t tamanhoNumero(uint32_t n)
+    {
+        size_t digitos = 1;
+        while (n >= 10)
+        {
+            n /= 10;
+            digitos++;
+        }
+        return digitos;
+    }
+
+    inline char *escreverCor(char *p, char plano, uint32_t cor)
+    {
+        // "38;2;r;g;b" (frente) ou "48;2;r;g;b" (fundo); "39"/"49" para a cor padrão
+        *p++ = plano;
+        if (cor == COR_PADRAO)
+        {
+            *p++ = '9';
+            return p;
+        }
+        *p++ = '8';
+        *p++ = ';';
+        *p++ = '2';
+        *p++ = ';';
+        p = escreverNumero(p, (cor >> 16) & 0xFF);
+        *p++ = ';';
+        p = escreverNumero(p, (cor >> 8) & 0xFF);
+        *p++ = ';';
+        return escreverNumero(p, cor & 0xFF);
+    }
+
+    // Maior SGR possível: ESC [ 38;2;255;255;255 ; 48;2;255;255;255 m
+    const size_t MAIOR_SGR = 40;
+
+    /**
+     * @brief O SGR que troca as cores ativas (frenteDe/fundoDe) por
+     * frente/fundo, em 'destino'. Devolve o tamanho (0 se nada muda).
+     */
+    size_t montarSGR(uint32_t frenteDe, uint32_t fundoDe, uint32_t frente, uint32_t fundo, char *destino)
+    {
+        if (frente == frenteDe && fundo == fundoDe)
+            return 0;
+        char *p = destino;
+        *p++ = '\x1b';
+        *p++ = '[';
+        if (frente == COR_PADRAO && fundo == COR_PADRAO)
+        {
+            // "0" volta as duas de uma vez (e vale mesmo com as ativas desconhecidas)
+            *p++ = '0';
+        }
+        else
+        {
+            if (frente != frenteDe)
+                p = escreverCor(p, '3', frente);
+            if (fundo != fundoDe)
+            {
+                if (frente != frenteDe)
+                    *p++ = ';';
+                p = escreverCor(p, '4', fundo);
+            }
+        }
+        *p++ = 'm';
+        return (size_t)(p - destino);
+    }
+
+    inline size_t tamanhoSGR(uint32_t frenteDe, uint32_t fundoDe, uint32_t frente, uint32_t fundo)
+    {
+        char sgr[MAIOR_SGR];
+        return montarSGR(frenteDe, fundoDe, frente, fundo, sgr);
+    }
+
+    inline size_t tamanhoAvanco(int colunas)
+    {
+        // ESC [ C avança uma coluna; ESC [ n C avança n
+        return colunas == 1 ? 3 : 3 + tamanhoNumero((uint32_t)colunas);
+    }
+}
+
+void CodificadorANSI::redimensionar(int largura, int altura)
+{
+    m_tela.redimensionar(largura, altura);
+    invalidar();
+}
+
+void CodificadorANSI::invalidar()
+{
+    m_valido = false;
+    esquecerCursor();
+}
+
+void CodificadorANSI::esquecerCursor()
+{
+    m_cursorLinha = -1;
+    m_cursorColuna = -1;
+}
+
+void CodificadorANSI::restaurarCores(std::string &saida)
+{
+    if (m_frente != COR_PADRAO || m_fundo != COR_PADRAO)
+        saida += "\x1b[0m";
+    m_frente = COR_PADRAO;
+    m_fundo = COR_PADRAO;
+}
+
+void CodificadorANSI::_trocarCores(uint32_t frente, uint32_t fundo, std::string &saida)
+{
+    char sgr[MAIOR_SGR];
+    size_t tamanho = montarSGR(m_frente, m_fundo, frente, fundo, sgr);
+    if (tamanho == 0)
+        return;
+    saida.append(sgr, tamanho);
+    m_frente = frente;
+    m_fundo = fundo;
+}
+
+void CodificadorANSI::_mover(int linha, int coluna, uint32_t frente, uint32_t fundo, std::string &saida)
+{
+    if (linha == m_cursorLinha && coluna == m_cursorColuna)
+        return;
+
+    char sequencia[32];
+    char *p = sequencia;
+
+    if (linha == m_cursorLinha && coluna > m_cursorColuna)
+    {
+        const int buraco = coluna - m_cursorColuna;
+        const size_t custoAvanco = tamanhoAvanco(buraco) + tamanhoSGR(m_frente, m_fundo, frente, fundo);
+
+        // As células do buraco estão certas na tela: reescrevê-las (com as
+        // trocas de cor que pedirem) às vezes sai mais barato que o CUF
+        if (m_valido && buraco <= MAIOR_BURACO_REESCRITO)
+        {
+            const size_t inicio = (size_t)linha * m_tela.largura + m_cursorColuna;
+            uint32_t corFrente = m_frente, corFundo = m_fundo;
+            size_t custoReescrita = 0;
+            int k = 0;
+            for (; k < buraco && custoReescrita <= custoAvanco; k++)
+            {
+                custoReescrita += tamanhoSGR(corFrente, corFundo, m_tela.frente[inicio + k], m_tela.fundo[inicio + k]) + 1;
+                corFrente = m_tela.frente[inicio + k];
+                corFundo = m_tela.fundo[inicio + k];
+            }
+            custoReescrita += tamanhoSGR(corFrente, corFundo, frente, fundo);
+            if (k == buraco && custoReescrita <= custoAvanco)
+            {
+                for (k = 0; k < buraco; k++)
+                {
+                    _trocarCores(m_tela.frente[inicio + k], m_tela.fundo[inicio + k], saida);
+                    saida += m_tela.glifos[inicio + k];
+                }
+                m_cursorColuna = coluna;
+                return;
+            }
+        }
+
+        *p++ = '\x1b';
+        *p++ = '[';
+        if (buraco > 1)
+            p = escreverNumero(p, (uint32_t)buraco);
+        *p++ = 'C';
+    }
+    else
+    {
+        // CUP: ESC [ linha ; coluna H (1-based), com as formas curtas
+        *p++ = '\x1b';
+        *p++ = '[';
+        if (linha > 0 || coluna > 0)
+            p = escreverNumero(p, (uint32_t)linha + 1);
+        if (coluna > 0)
+        {
+            *p++ = ';';
+            p = escreverNumero(p, (uint32_t)coluna + 1);
+        }
+        *p++ = 'H';
+
+        // Começo (ou perto do começo) da próxima linha: "\r\n" (+ CUF) é mais curto
+        if (m_cursorLinha >= 0 && linha == m_cursorLinha + 1)
+        {
+            size_t custoQuebra = 2 + (coluna > 0 ? tamanhoAvanco(coluna) : 0);
+            if (custoQuebra < (size_t)(p - sequencia))
+            {
+                p = sequencia;
+                *p++ = '\r';
+                *p++ = '\n';
+                if (coluna > 0)
+                {
+                    *p++ = '\x1b';
+                    *p++ = '[';
+                    if (coluna > 1)
+                        p = escreverNumero(p, (uint32_t)coluna);
+                    *p++ = 'C';
+                }
+            }
+        }
+    }
+
+    saida.append(sequencia, (size_t)(p - sequencia));
+    m_cursorLinha = linha;
+    m_cursorColuna = coluna;
+}
+
+size_t CodificadorANSI::codificar(const FrameCelulas &novo, std::string &saida)
+{
+    if (novo.largura != m_tela.largura || novo.altura != m_tela.altura)
+        redimensionar(novo.largura, novo.altura);
+
+    const int largura = m_tela.largura;
+    size_t escritas = 0;
+
+    for (int linha = 0; linha < m_tela.altura; linha++)
+    {
+        const size_t inicio = (size_t)linha * largura;
+
+        // Linha inteira igual: três memcmp e pronto
+        if (m_valido &&
+            memcmp(&m_tela.glifos[inicio], &novo.glifos[inicio], (size_t)largura) == 0 &&
+            memcmp(&m_tela.frente[inicio], &novo.frente[inicio], (size_t)largura * sizeof(uint32_t)) == 0 &&
+            memcmp(&m_tela.fundo[inicio], &novo.fundo[inicio], (size_t)largura * sizeof(uint32_t)) == 0)
+            continue;
+
+        for (int coluna = 0; coluna < largura; coluna++)
+        {
+            const size_t o = inicio + coluna;
+            if (m_valido && m_tela.igual(o, novo))
+                continue;
+
+            _mover(linha, coluna, novo.frente[o], novo.fundo[o], saida);
+            _trocarCores(novo.frente[o], novo.fundo[o], saida);
+            saida += novo.glifos[o];
+
+            m_tela.glifos[o] = novo.glifos[o];
+            m_tela.frente[o] = novo.frente[o];
+            m_tela.fundo[o] = novo.fundo[o];
+            escritas++;
+
+            // Na última coluna o terminal segura a quebra pendente:
+            // não dá para confiar na posição do cursor
+            if (coluna + 1 < largura)
+                m_cursorColuna = coluna + 1;
+            else
+                esquecerCursor();
+        }
+    }
+
+    m_valido = true;
+    return escritas;
+}
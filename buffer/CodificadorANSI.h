@@ -0,0 +1,73 @@
+#ifndef CODIFICADOR_ANSI_H
+#define CODIFICADOR_ANSI_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t
+#include <string>
+#include "FrameCelulas.h"
+
+/**
+ * @class CodificadorANSI
+ * @brief Transforma frames de células em saída ANSI para um terminal
+ * truecolor, mandando só o que mudou desde o frame anterior.
+ *
+ * Lembra o que está na tela, onde está o cursor e quais cores (SGR)
+ * estão ativas. Para chegar a cada célula alterada, usa o caminho mais
+ * curto em bytes: o cursor já está lá, reescrever as poucas células
+ * iguais no meio do caminho, avançar (CUF), "\r\n" para a próxima linha
+ * ou o salto absoluto (CUP). Um SGR só sai quando a cor muda ao longo
+ * do que é escrito, com frente e fundo juntos na mesma sequência.
+ */
+class CodificadorANSI
+{
+public:
+    /**
+     * @brief Tamanho da tela. Esquece tudo: o próximo frame sai inteiro.
+     */
+    void redimensionar(int largura, int altura);
+
+    /**
+     * @brief A tela foi apagada por fora (ex: ESC[2J): o próximo frame sai inteiro.
+     */
+    void invalidar();
+
+    /**
+     * @brief Algo foi escrito fora do codificador (ex: a linha de status):
+     * a posição do cursor passa a ser desconhecida.
+     */
+    void esquecerCursor();
+
+    /**
+     * @brief Anexa a 'saida' o que leva a tela ao frame 'novo' (se o
+     * tamanho for outro, redimensiona e manda tudo).
+     * @return Células reescritas.
+     */
+    size_t codificar(const FrameCelulas &novo, std::string &saida);
+
+    /**
+     * @brief Volta às cores padrão do terminal (ex: antes de escrever
+     * texto próprio ou de sair).
+     */
+    void restaurarCores(std::string &saida);
+
+private:
+    static const uint32_t COR_DESCONHECIDA = 0xFFFFFFFF;
+    // Reescrever mais que isso para pular um buraco nunca compensa um CUF
+    static const int MAIOR_BURACO_REESCRITO = 8;
+
+    FrameCelulas m_tela;       // O que está no terminal agora
+    int m_cursorLinha = -1;    // -1 = desconhecido
+    int m_cursorColuna = -1;
+    uint32_t m_frente = COR_DESCONHECIDA; // Cores do SGR ativo
+    uint32_t m_fundo = COR_DESCONHECIDA;
+    bool m_valido = false;     // false: redesenha tudo no próximo frame
+
+    /**
+     * @brief Leva o cursor a (linha, coluna) pelo caminho mais curto,
+     * sabendo que a célula de destino vai ser escrita com 'frente'/'fundo'.
+     */
+    void _mover(int linha, int coluna, uint32_t frente, uint32_t fundo, std::string &saida);
+    void _trocarCores(uint32_t frente, uint32_t fundo, std::string &saida);
+};
+
+#endif // CODIFICADOR_ANSI_H
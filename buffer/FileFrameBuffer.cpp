@@ -1,10 +1,11 @@
 #include "FileFrameBuffer.h"
 
+#include <algorithm> // Para std::min
+
 FileFrameBuffer::FileFrameBuffer(const std::string& caminhoArquivo)
-    : m_caminhoArquivo(caminhoArquivo) {
-    // Limpa o arquivo no início
-    std::ofstream out(m_caminhoArquivo, std::ios::trunc);
-    out.close();
+    : m_caminhoArquivo(caminhoArquivo), m_tamanhoEscrito(0) {
+    // Limpa o arquivo no início e o mantém aberto
+    m_arquivo.open(m_caminhoArquivo, std::ios::in | std::ios::out | std::ios::trunc);
 }
 
 // O código do donut já envia \x1b[H (home), 
@@ -15,11 +16,34 @@ void FileFrameBuffer::limpar() {
 }
 
 void FileFrameBuffer::atualizar(const std::string& conteudo) {
-    // Abre o arquivo (trunc = apaga o anterior) e escreve o frame
-    std::ofstream out(m_caminhoArquivo, std::ios::trunc);
-    if (out.is_open()) {
-        out << conteudo;
-        out.close();
+    // Um frame menor que o anterior precisa truncar o arquivo
+    if (conteudo.size() < m_tamanhoEscrito || !m_arquivo.is_open()) {
+        m_arquivo.close();
+        m_arquivo.open(m_caminhoArquivo, std::ios::in | std::ios::out | std::ios::trunc);
+    }
+    if (m_arquivo.is_open()) {
+        m_arquivo.seekp(0);
+        m_arquivo.write(conteudo.data(), conteudo.size());
+        m_arquivo.flush();
+        m_tamanhoEscrito = conteudo.size();
     }
 }
 
+void FileFrameBuffer::atualizarRegioes(const std::string& conteudo, const RegiaoSuja* regioes, size_t quantidade) {
+    // Sem um frame completo de mesmo tamanho no arquivo, não há base para o delta
+    if (conteudo.size() != m_tamanhoEscrito || !m_arquivo.is_open()) {
+        atualizar(conteudo);
+        return;
+    }
+
+    // Reescreve só os trechos que mudaram, cortados no fim do frame
+    for (size_t k = 0; k < quantidade; k++) {
+        const size_t inicio = regioes[k].deslocamento;
+        if (inicio >= conteudo.size())
+            continue;
+        const size_t tamanho = std::min<size_t>(regioes[k].tamanho, conteudo.size() - inicio);
+        m_arquivo.seekp(inicio);
+        m_arquivo.write(conteudo.data() + inicio, tamanho);
+    }
+    m_arquivo.flush();
+}
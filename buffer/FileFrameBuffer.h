@@ -3,12 +3,15 @@
 
 #include "../interface/IFrameBuffer.h"
 #include <string>
-#include <fstream> // Para std::ofstream
+#include <fstream> // Para std::fstream
 
 /**
  * @class FileFrameBuffer
  * @brief Implementação concreta do IFrameBuffer que escreve
  * o frame em um arquivo de texto.
+ *
+ * O arquivo fica aberto: atualizações parciais só reescrevem
+ * os trechos que mudaram, no lugar.
  */
 class FileFrameBuffer : public IFrameBuffer {
 public:
@@ -18,10 +21,12 @@ public:
     // Removemos o 'limpar()' pois \x1b[H faz isso
     void limpar() override;
     void atualizar(const std::string& conteudo) override;
+    void atualizarRegioes(const std::string& conteudo, const RegiaoSuja* regioes, size_t quantidade) override;
 
 private:
     std::string m_caminhoArquivo;
+    std::fstream m_arquivo;
+    size_t m_tamanhoEscrito; // Tamanho do último frame completo no arquivo
 };
 
 #endif // FILE_FRAMEBUFFER_H
-
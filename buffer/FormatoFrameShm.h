@@ -0,0 +1,210 @@
+#ifndef FORMATO_FRAME_SHM_H
+#define FORMATO_FRAME_SHM_H
+
+#include <atomic>
+#include <algorithm> // Para std::max
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t, uint64_t
+#include <cstring> // Para memcpy
+#include <ctime>   // Para timespec
+
+// --- DEPENDÊNCIAS LINUX (futex) ---
+#include <unistd.h>      // syscall
+#include <sys/syscall.h> // SYS_futex
+#include <linux/futex.h> // FUTEX_WAIT, FUTEX_WAKE
+// ----------------------------------
+
+/**
+ * Formato do framebuffer em memória compartilhada (sim_frame.shm).
+ *
+ * [CabecalhoFrameShm][CabecalhoSlot][dados do slot 0][CabecalhoSlot][dados do slot 1]...
+ *
+ * O escritor (MmapFrameBuffer) sempre escreve num slot que NÃO é o
+ * publicado, protegido por um seqlock, e só então o publica trocando
+ * 'slotPublicado'. Leitores nunca bloqueiam o escritor e, ao
+ * conferirem o seqlock, nunca aceitam um frame pela metade.
+ *
+ * Um leitor pode dormir num futex ('sinalFrame') até o próximo frame
+ * (aguardarFrameShm); o escritor só faz a syscall de wake quando há
+ * alguém dormindo.
+ *
+ * O tamanho do display só muda com um arquivo novo: o escritor monta o
+ * novo sim_frame.shm ao lado, troca-o de lugar com rename() e marca o
+ * antigo como 'substituido' (acordando quem dorme nele). Um leitor
+ * nunca vê o arquivo que mapeou encolher (o que daria SIGBUS); ele só
+ * precisa reabrir o caminho.
+ */
+
+static const uint32_t MAGIC_FRAME_SHM = 0x314D5246; // "FRM1"
+static const uint32_t VERSAO_FRAME_SHM = 4;
+static const uint32_t NUM_SLOTS_FRAME_SHM = 3;
+static const size_t LINHA_CACHE_FRAME_SHM = 64;
+
+// O que os dados de um slot guardam (CabecalhoFrameShm::formato)
+static const uint32_t FORMATO_FRAME_TEXTO = 0;   // O texto do frame ("\x1b[H", linhas com '\n')
+static const uint32_t FORMATO_FRAME_CELULAS = 1; // Os planos de um FrameCelulas (ver abaixo)
+
+struct CabecalhoFrameShm
+{
+    uint32_t magic;
+    uint32_t versao;
+    uint32_t largura;
+    uint32_t altura;
+    uint32_t numSlots;
+    uint32_t tamanhoSlot; // Bytes de dados por slot (sem o CabecalhoSlot)
+    uint32_t formato;     // FORMATO_FRAME_TEXTO ou FORMATO_FRAME_CELULAS
+
+    alignas(LINHA_CACHE_FRAME_SHM) std::atomic<uint64_t> sequencia; // Nº do último frame publicado
+    std::atomic<uint32_t> slotPublicado;
+    std::atomic<uint32_t> sinalFrame;       // Palavra do futex: +1 a cada publicação
+    std::atomic<uint32_t> leitoresDormindo; // Leitores no futex agora
+    std::atomic<uint32_t> substituido;      // != 0: há um arquivo novo no caminho (reabrir)
+};
+
+struct alignas(LINHA_CACHE_FRAME_SHM) CabecalhoSlot
+{
+    std::atomic<uint64_t> seqlock; // Ímpar = escrita em andamento
+    uint64_t sequencia;            // Nº do frame guardado neste slot
+    uint64_t timestampNs;          // CLOCK_MONOTONIC da publicação
+    uint32_t tamanho;              // Bytes válidos nos dados
+};
+
+/**
+ * @brief Bytes de um slot de texto. O frame do donut é "\x1b[H" + largura
+ * * altura (a coluna 0 de cada linha é o '\n'); texto com um '\n' ao fim
+ * de cada linha ocupa largura * altura + altura. Cabem os dois, em
+ * qualquer altura (com altura 2, o segundo é o menor).
+ */
+inline size_t tamanhoTextoShm(size_t largura, size_t altura)
+{
+    const size_t celulas = largura * altura;
+    return std::max(3 + celulas, celulas + altura);
+}
+
+/**
+ * Slot de células (largura * altura células), um plano após o outro:
+ * [glifos: 1 byte cada][frente: uint32 cada][fundo: uint32 cada],
+ * com as cores alinhadas a 4 bytes.
+ */
+inline size_t inicioFrenteCelulasShm(size_t celulas)
+{
+    return (celulas + 3) & ~(size_t)3;
+}
+
+inline size_t inicioFundoCelulasShm(size_t celulas)
+{
+    return inicioFrenteCelulasShm(celulas) + celulas * sizeof(uint32_t);
+}
+
+inline size_t tamanhoCelulasShm(size_t celulas)
+{
+    return inicioFundoCelulasShm(celulas) + celulas * sizeof(uint32_t);
+}
+
+/**
+ * @brief Bytes ocupados por um slot (cabeçalho + dados), alinhado à linha de cache.
+ */
+inline size_t tamanhoSlotFrameShm(uint32_t tamanhoSlot)
+{
+    size_t bruto = sizeof(CabecalhoSlot) + tamanhoSlot;
+    return (bruto + LINHA_CACHE_FRAME_SHM - 1) & ~(LINHA_CACHE_FRAME_SHM - 1);
+}
+
+/**
+ * @brief Tamanho total do arquivo mapeado.
+ */
+inline size_t tamanhoArquivoFrameShm(uint32_t numSlots, uint32_t tamanhoSlot)
+{
+    return sizeof(CabecalhoFrameShm) +
+           (size_t)numSlots * tamanhoSlotFrameShm(tamanhoSlot);
+}
+
+inline CabecalhoSlot *slotFrameShm(CabecalhoFrameShm *cabecalho, uint32_t indice)
+{
+    char *base = reinterpret_cast<char *>(cabecalho) + sizeof(CabecalhoFrameShm);
+    return reinterpret_cast<CabecalhoSlot *>(base + indice * tamanhoSlotFrameShm(cabecalho->tamanhoSlot));
+}
+
+inline char *dadosSlotFrameShm(CabecalhoSlot *slot)
+{
+    return reinterpret_cast<char *>(slot) + sizeof(CabecalhoSlot);
+}
+
+/**
+ * @brief Lê o frame publicado mais recente sem locks (lado do leitor).
+ *
+ * @param destino Recebe os dados do frame (ao menos tamanhoSlot bytes).
+ * @param sequencia Recebe o nº do frame lido.
+ * @param timestampNs Recebe o instante de publicação do frame.
+ * @return Bytes válidos copiados, ou 0 se nenhum frame completo foi obtido.
+ */
+inline size_t lerFrameShm(CabecalhoFrameShm *cabecalho, char *destino, uint64_t &sequencia, uint64_t &timestampNs)
+{
+    // O escritor só reutiliza um slot depois de publicar outros dois,
+    // então poucas tentativas bastam mesmo com um leitor lento.
+    for (int tentativa = 0; tentativa < 64; tentativa++)
+    {
+        uint32_t indice = cabecalho->slotPublicado.load(std::memory_order_acquire);
+        if (indice >= cabecalho->numSlots)
+            return 0;
+
+        CabecalhoSlot *slot = slotFrameShm(cabecalho, indice);
+        uint64_t s1 = slot->seqlock.load(std::memory_order_acquire);
+        if (s1 & 1)
+            continue; // O escritor está neste slot agora
+
+        uint32_t tamanho = slot->tamanho;
+        if (tamanho > cabecalho->tamanhoSlot)
+            continue;
+        uint64_t seq = slot->sequencia;
+        uint64_t ts = slot->timestampNs;
+        memcpy(destino, dadosSlotFrameShm(slot), tamanho);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seqlock.load(std::memory_order_relaxed) == s1)
+        {
+            sequencia = seq;
+            timestampNs = ts;
+            return tamanho;
+        }
+    }
+    return 0;
+}
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex precisa de uma palavra de 32 bits");
+
+/**
+ * @brief Lado do escritor, depois de publicar: acorda os leitores que
+ * dormem em aguardarFrameShm (a syscall só acontece se houver algum).
+ */
+inline void avisarLeitoresFrameShm(CabecalhoFrameShm *cabecalho)
+{
+    cabecalho->sinalFrame.fetch_add(1, std::memory_order_seq_cst);
+    if (cabecalho->leitoresDormindo.load(std::memory_order_seq_cst) > 0)
+    {
+        // Sem FUTEX_PRIVATE_FLAG: a palavra é compartilhada entre processos
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&cabecalho->sinalFrame), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    }
+}
+
+/**
+ * @brief Lado do leitor: dorme até a sequência passar de 'ultimaSequencia'
+ * ou até o timeout. @return A sequência publicada ao acordar.
+ */
+inline uint64_t aguardarFrameShm(CabecalhoFrameShm *cabecalho, uint64_t ultimaSequencia, int timeoutMs)
+{
+    uint32_t sinal = cabecalho->sinalFrame.load(std::memory_order_acquire);
+    cabecalho->leitoresDormindo.fetch_add(1, std::memory_order_seq_cst);
+
+    // Reconfere depois de anunciar que vai dormir (evita perder um wake)
+    if (cabecalho->sequencia.load(std::memory_order_seq_cst) == ultimaSequencia)
+    {
+        timespec timeout = {timeoutMs / 1000, (long)(timeoutMs % 1000) * 1000000L};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&cabecalho->sinalFrame), FUTEX_WAIT, sinal, &timeout, nullptr, 0);
+    }
+
+    cabecalho->leitoresDormindo.fetch_sub(1, std::memory_order_relaxed);
+    return cabecalho->sequencia.load(std::memory_order_acquire);
+}
+
+#endif // FORMATO_FRAME_SHM_H
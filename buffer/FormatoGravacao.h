@@ -0,0 +1,162 @@
+#ifndef FORMATO_GRAVACAO_H
+#define FORMATO_GRAVACAO_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint8_t, uint32_t, uint64_t
+#include <cstring> // Para memcpy
+
+/**
+ * Formato da gravação de frames (sim_gravacao.bin), só de anexar:
+ *
+ * [CabecalhoGravacao][RegistroFrame][dados]...[RegistroFrame][dados]
+ * [EntradaIndiceGravacao x N][RodapeGravacao]
+ *
+ * Cada frame é um registro:
+ *  - KEYFRAME: o frame inteiro comprimido com RLE;
+ *  - DELTA: o XOR com o frame anterior comprimido com RLE. O que não
+ *    mudou vira zeros, e as sequências de zeros viram poucos bytes.
+ *
+ * A cada 'intervaloKeyframe' frames (ou quando o tamanho muda) sai um
+ * KEYFRAME: é onde um leitor pode começar a decodificar. O índice
+ * (um par frame/deslocamento por keyframe) e o rodapé só são escritos
+ * ao fechar; sem eles (gravação interrompida) o leitor reconstrói o
+ * índice percorrendo os registros.
+ */
+
+static const uint32_t MAGIC_GRAVACAO = 0x31434552; // "REC1"
+static const uint32_t MAGIC_RODAPE_GRAVACAO = 0x31584449; // "IDX1"
+static const uint32_t VERSAO_GRAVACAO = 1;
+
+enum TipoRegistroFrame : uint8_t
+{
+    REGISTRO_KEYFRAME = 1,
+    REGISTRO_DELTA = 2
+};
+
+struct CabecalhoGravacao
+{
+    uint32_t magic;
+    uint32_t versao;
+    uint32_t largura;
+    uint32_t altura;
+    uint32_t intervaloKeyframe;
+    uint32_t reservado;
+};
+
+struct RegistroFrame
+{
+    uint8_t tipo;             // TipoRegistroFrame
+    uint8_t reservado[3];
+    uint32_t tamanhoDados;    // Bytes comprimidos depois deste registro
+    uint32_t tamanhoFrame;    // Bytes do frame decodificado
+    uint32_t reservado2;
+    uint64_t numeroFrame;     // 0, 1, 2...
+    uint64_t instanteNs;      // Desde o início da gravação
+};
+
+struct EntradaIndiceGravacao
+{
+    uint64_t numeroFrame;  // Keyframe
+    uint64_t deslocamento; // Do RegistroFrame no arquivo
+};
+
+struct RodapeGravacao
+{
+    uint64_t deslocamentoIndice;
+    uint64_t entradasIndice;
+    uint64_t totalFrames;
+    uint32_t magic; // MAGIC_RODAPE_GRAVACAO (por último: rodapé completo)
+    uint32_t reservado;
+};
+
+/**
+ * @brief Pior caso do RLE (nada se repete): 1 byte de controle a cada 128.
+ */
+inline size_t tamanhoMaximoRLE(size_t tamanho)
+{
+    return tamanho + (tamanho + 127) / 128;
+}
+
+/**
+ * @brief RLE estilo PackBits. Byte de controle c:
+ *  - c < 128: seguem c + 1 bytes literais;
+ *  - c >= 128: o próximo byte se repete (c - 125) vezes (3 a 130).
+ * @param destino Ao menos tamanhoMaximoRLE(tamanho) bytes.
+ * @return Bytes escritos em 'destino'.
+ */
+inline size_t comprimirRLE(const uint8_t *origem, size_t tamanho, uint8_t *destino)
+{
+    size_t lido = 0;
+    size_t escrito = 0;
+    size_t inicioLiteral = 0;
+
+    auto despejarLiterais = [&](size_t fim) {
+        while (inicioLiteral < fim)
+        {
+            size_t n = fim - inicioLiteral;
+            if (n > 128)
+                n = 128;
+            destino[escrito++] = (uint8_t)(n - 1);
+            memcpy(destino + escrito, origem + inicioLiteral, n);
+            escrito += n;
+            inicioLiteral += n;
+        }
+    };
+
+    while (lido < tamanho)
+    {
+        size_t repeticao = 1;
+        while (lido + repeticao < tamanho && repeticao < 130 && origem[lido + repeticao] == origem[lido])
+            repeticao++;
+
+        if (repeticao >= 3)
+        {
+            despejarLiterais(lido);
+            destino[escrito++] = (uint8_t)(repeticao + 125);
+            destino[escrito++] = origem[lido];
+            lido += repeticao;
+            inicioLiteral = lido;
+        }
+        else
+        {
+            lido += repeticao;
+        }
+    }
+    despejarLiterais(tamanho);
+    return escrito;
+}
+
+/**
+ * @brief Desfaz o comprimirRLE.
+ * @return Bytes escritos em 'destino', ou 0 se os dados estão corrompidos
+ * ou não cabem em 'capacidade'.
+ */
+inline size_t descomprimirRLE(const uint8_t *origem, size_t tamanho, uint8_t *destino, size_t capacidade)
+{
+    size_t lido = 0;
+    size_t escrito = 0;
+    while (lido < tamanho)
+    {
+        uint8_t controle = origem[lido++];
+        if (controle < 128)
+        {
+            size_t n = (size_t)controle + 1;
+            if (lido + n > tamanho || escrito + n > capacidade)
+                return 0;
+            memcpy(destino + escrito, origem + lido, n);
+            lido += n;
+            escrito += n;
+        }
+        else
+        {
+            size_t n = (size_t)controle - 125;
+            if (lido >= tamanho || escrito + n > capacidade)
+                return 0;
+            memset(destino + escrito, origem[lido++], n);
+            escrito += n;
+        }
+    }
+    return escrito;
+}
+
+#endif // FORMATO_GRAVACAO_H
@@ -0,0 +1,71 @@
+#ifndef FRAMEBUFFER_CHECKSUM_H
+#define FRAMEBUFFER_CHECKSUM_H
+
+#include "../interface/IFrameBuffer.h"
+#include "../replay/TraceEntrada.h" // checksumFrame
+
+/**
+ * @class FrameBufferChecksum
+ * @brief Repassa cada atualização ao framebuffer de destino e guarda o
+ * checksum do último frame completo (o trace de entrada compara esse
+ * valor tick a tick). Não é dono do destino. Frames de células entram
+ * no checksum pelo texto equivalente: o mesmo valor com ou sem cor.
+ */
+class FrameBufferChecksum : public IFrameBuffer
+{
+public:
+    explicit FrameBufferChecksum(IFrameBuffer &destino)
+        : m_destino(destino), m_checksum(checksumFrame(nullptr, 0))
+    {
+    }
+
+    void limpar() override
+    {
+        m_destino.limpar();
+        m_checksum = checksumFrame(nullptr, 0);
+    }
+
+    void redimensionar(int largura, int altura) override
+    {
+        m_destino.redimensionar(largura, altura);
+    }
+
+    void atualizar(const std::string &conteudo) override
+    {
+        m_destino.atualizar(conteudo);
+        m_checksum = checksumFrame(conteudo.data(), conteudo.size());
+    }
+
+    void atualizarRegioes(const std::string &conteudo, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        m_destino.atualizarRegioes(conteudo, regioes, quantidade);
+        m_checksum = checksumFrame(conteudo.data(), conteudo.size());
+    }
+
+    void atualizarCelulas(const FrameCelulas &celulas) override
+    {
+        m_destino.atualizarCelulas(celulas);
+        _checksumCelulas(celulas);
+    }
+
+    void atualizarCelulasRegioes(const FrameCelulas &celulas, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        m_destino.atualizarCelulasRegioes(celulas, regioes, quantidade);
+        _checksumCelulas(celulas);
+    }
+
+    uint64_t valor() const { return m_checksum; }
+
+private:
+    IFrameBuffer &m_destino;
+    uint64_t m_checksum;
+    std::string m_texto;
+
+    void _checksumCelulas(const FrameCelulas &celulas)
+    {
+        celulas.paraTexto(m_texto);
+        m_checksum = checksumFrame(m_texto.data(), m_texto.size());
+    }
+};
+
+#endif // FRAMEBUFFER_CHECKSUM_H
@@ -0,0 +1,60 @@
+#ifndef FRAMEBUFFER_DUPLO_H
+#define FRAMEBUFFER_DUPLO_H
+
+#include "../interface/IFrameBuffer.h"
+
+/**
+ * @class FrameBufferDuplo
+ * @brief Repassa cada atualização a dois framebuffers (ex: a tela
+ * mmap e o GravadorFrameBuffer). Não é dono de nenhum dos dois.
+ */
+class FrameBufferDuplo : public IFrameBuffer
+{
+public:
+    FrameBufferDuplo(IFrameBuffer &primeiro, IFrameBuffer &segundo)
+        : m_primeiro(primeiro), m_segundo(segundo)
+    {
+    }
+
+    void limpar() override
+    {
+        m_primeiro.limpar();
+        m_segundo.limpar();
+    }
+
+    void atualizarCelulas(const FrameCelulas &celulas) override
+    {
+        m_primeiro.atualizarCelulas(celulas);
+        m_segundo.atualizarCelulas(celulas);
+    }
+
+    void atualizarCelulasRegioes(const FrameCelulas &celulas, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        m_primeiro.atualizarCelulasRegioes(celulas, regioes, quantidade);
+        m_segundo.atualizarCelulasRegioes(celulas, regioes, quantidade);
+    }
+
+    void redimensionar(int largura, int altura) override
+    {
+        m_primeiro.redimensionar(largura, altura);
+        m_segundo.redimensionar(largura, altura);
+    }
+
+    void atualizar(const std::string &conteudo) override
+    {
+        m_primeiro.atualizar(conteudo);
+        m_segundo.atualizar(conteudo);
+    }
+
+    void atualizarRegioes(const std::string &conteudo, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        m_primeiro.atualizarRegioes(conteudo, regioes, quantidade);
+        m_segundo.atualizarRegioes(conteudo, regioes, quantidade);
+    }
+
+private:
+    IFrameBuffer &m_primeiro;
+    IFrameBuffer &m_segundo;
+};
+
+#endif // FRAMEBUFFER_DUPLO_H
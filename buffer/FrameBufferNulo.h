@@ -0,0 +1,54 @@
+#ifndef FRAMEBUFFER_NULO_H
+#define FRAMEBUFFER_NULO_H
+
+#include "../interface/IFrameBuffer.h"
+#include <atomic>
+#include <cstdint> // Para uint64_t
+
+/**
+ * @class FrameBufferNulo
+ * @brief Framebuffer que descarta tudo (só conta os bytes recebidos).
+ * Para processos sem tela (em segundo plano) e para benchmarks.
+ * Pode ser compartilhado por processos em núcleos diferentes.
+ */
+class FrameBufferNulo : public IFrameBuffer
+{
+public:
+    void limpar() override {}
+
+    void atualizar(const std::string &conteudo) override
+    {
+        m_bytesRecebidos.fetch_add(conteudo.size(), std::memory_order_relaxed);
+    }
+
+    void atualizarRegioes(const std::string &conteudo, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        (void)conteudo;
+        uint64_t total = 0;
+        for (size_t k = 0; k < quantidade; k++)
+            total += regioes[k].tamanho;
+        m_bytesRecebidos.fetch_add(total, std::memory_order_relaxed);
+    }
+
+    void atualizarCelulas(const FrameCelulas &celulas) override
+    {
+        m_bytesRecebidos.fetch_add(celulas.celulas() * BYTES_POR_CELULA, std::memory_order_relaxed);
+    }
+
+    void atualizarCelulasRegioes(const FrameCelulas &celulas, const RegiaoSuja *regioes, size_t quantidade) override
+    {
+        (void)celulas;
+        uint64_t total = 0;
+        for (size_t k = 0; k < quantidade; k++)
+            total += regioes[k].tamanho;
+        m_bytesRecebidos.fetch_add(total * BYTES_POR_CELULA, std::memory_order_relaxed);
+    }
+
+    uint64_t bytesRecebidos() const { return m_bytesRecebidos.load(std::memory_order_relaxed); }
+
+private:
+    static const uint64_t BYTES_POR_CELULA = sizeof(char) + 2 * sizeof(uint32_t); // Glifo, frente e fundo
+    std::atomic<uint64_t> m_bytesRecebidos{0};
+};
+
+#endif // FRAMEBUFFER_NULO_H
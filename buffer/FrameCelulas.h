@@ -0,0 +1,124 @@
+#ifndef FRAME_CELULAS_H
+#define FRAME_CELULAS_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t
+#include <cstring> // Para memcpy
+#include <string>
+#include <vector>
+
+/**
+ * Frame de células com cor: um glifo, uma cor de frente e uma de fundo
+ * por célula, em planos separados (struct-of-arrays). Comparar e copiar
+ * um trecho de linha é um memcmp/memcpy por plano, e o plano de glifos
+ * sozinho é o frame de texto.
+ *
+ * Cores são 0xRRGGBB (24 bits) ou COR_PADRAO (a cor padrão do terminal).
+ */
+
+static const uint32_t COR_PADRAO = 0xFF000000;
+
+inline uint32_t corRGB(uint32_t r, uint32_t g, uint32_t b)
+{
+    return (r << 16) | (g << 8) | b;
+}
+
+/**
+ * @brief O texto equivalente a um plano de glifos, no formato do frame
+ * de texto da AppDonut: "\x1b[H" e, por linha, '\n' no lugar da coluna 0.
+ * Quem só entende texto (gravador, sim_frame.txt, checksum do replay)
+ * recebe exatamente os bytes do modo sem cor.
+ */
+inline void textoDeGlifos(const char *glifos, int largura, int altura, std::string &texto)
+{
+    texto.resize(3 + (size_t)largura * altura);
+    char *destino = &texto[0];
+    memcpy(destino, "\x1b[H", 3);
+    destino += 3;
+    for (int y = 0; y < altura; y++)
+    {
+        destino[0] = '\n';
+        memcpy(destino + 1, glifos + (size_t)y * largura + 1, (size_t)largura - 1);
+        destino += largura;
+    }
+}
+
+struct FrameCelulas
+{
+    int largura = 0;
+    int altura = 0;
+    std::vector<char> glifos;     // largura * altura, linha a linha
+    std::vector<uint32_t> frente; // Cor do glifo
+    std::vector<uint32_t> fundo;  // Cor da célula
+
+    size_t celulas() const { return (size_t)largura * (size_t)altura; }
+
+    /**
+     * @brief Novo tamanho, tudo em branco (espaço nas cores padrão).
+     */
+    void redimensionar(int novaLargura, int novaAltura)
+    {
+        largura = novaLargura;
+        altura = novaAltura;
+        glifos.assign(celulas(), ' ');
+        frente.assign(celulas(), COR_PADRAO);
+        fundo.assign(celulas(), COR_PADRAO);
+    }
+
+    void limpar() { redimensionar(largura, altura); }
+
+    bool igual(size_t o, const FrameCelulas &outro) const
+    {
+        return glifos[o] == outro.glifos[o] && frente[o] == outro.frente[o] && fundo[o] == outro.fundo[o];
+    }
+
+    void paraTexto(std::string &texto) const
+    {
+        textoDeGlifos(glifos.data(), largura, altura, texto);
+    }
+
+    /**
+     * @brief Interpreta um frame de texto qualquer (cores padrão):
+     * sequências ESC [ ... são ignoradas, '\n' pula de linha e o resto
+     * ocupa uma célula.
+     */
+    void deTexto(const char *dados, size_t tamanho)
+    {
+        limpar();
+        int linha = 0, coluna = 0;
+        for (size_t k = 0; k < tamanho && linha < altura; k++)
+        {
+            char c = dados[k];
+            if (c == '\x1b')
+            {
+                // CSI: ESC [ parâmetros byte-final (0x40..0x7e)
+                if (k + 1 < tamanho && dados[k + 1] == '[')
+                {
+                    k += 2;
+                    while (k < tamanho && (dados[k] < 0x40 || dados[k] > 0x7e))
+                        k++;
+                }
+                continue;
+            }
+            if (c == '\n')
+            {
+                linha++;
+                coluna = 0;
+                continue;
+            }
+            if (c == '\r')
+            {
+                coluna = 0;
+                continue;
+            }
+            glifos[(size_t)linha * largura + coluna] = c;
+            if (++coluna == largura)
+            {
+                linha++;
+                coluna = 0;
+            }
+        }
+    }
+};
+
+#endif // FRAME_CELULAS_H
@@ -0,0 +1,145 @@
+#include "GravadorFrameBuffer.h"
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+
+#include <cerrno>
+#include <cstring> // Para memcpy
+
+// --- DEPENDÊNCIAS POSIX ---
+#include <fcntl.h>    // open
+#include <unistd.h>   // write, close
+#include <sys/stat.h> // mode_t
+// --------------------------
+
+GravadorFrameBuffer::GravadorFrameBuffer(const std::string &caminhoArquivo, int largura, int altura,
+                                         uint32_t intervaloKeyframe)
+    : m_fd(-1),
+      m_deslocamento(0),
+      m_intervaloKeyframe(intervaloKeyframe > 0 ? intervaloKeyframe : 1),
+      m_inicio(std::chrono::steady_clock::now())
+{
+    m_fd = open(caminhoArquivo.c_str(), O_CREAT | O_WRONLY | O_TRUNC, (mode_t)0644);
+    if (m_fd == -1)
+    {
+        SIM_LOG(LOG_ERRO, "GRAVADOR", "ERRO: Falha ao criar o arquivo de gravação (errno {}).", errno);
+        return;
+    }
+    m_pendente.reserve(TAMANHO_BLOCO_ESCRITA + 4096);
+
+    CabecalhoGravacao cabecalho = {};
+    cabecalho.magic = MAGIC_GRAVACAO;
+    cabecalho.versao = VERSAO_GRAVACAO;
+    cabecalho.largura = (uint32_t)largura;
+    cabecalho.altura = (uint32_t)altura;
+    cabecalho.intervaloKeyframe = m_intervaloKeyframe;
+    _anexar(&cabecalho, sizeof(cabecalho));
+    _descarregar();
+
+    SIM_LOG(LOG_INFO, "GRAVADOR", "Gravando frames (keyframe a cada {} frames).", m_intervaloKeyframe);
+}
+
+GravadorFrameBuffer::~GravadorFrameBuffer()
+{
+    fechar();
+}
+
+void GravadorFrameBuffer::atualizar(const std::string &conteudo)
+{
+    SIM_SPAN("framebuffer", "gravador");
+
+    if (m_fd == -1)
+        return;
+
+    const uint8_t *frame = reinterpret_cast<const uint8_t *>(conteudo.data());
+    const size_t tamanho = conteudo.size();
+
+    RegistroFrame registro = {};
+    registro.numeroFrame = m_estatisticas.frames;
+    registro.instanteNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - m_inicio)
+                              .count();
+    registro.tamanhoFrame = (uint32_t)tamanho;
+
+    m_comprimido.resize(tamanhoMaximoRLE(tamanho));
+    bool keyframe = m_estatisticas.frames % m_intervaloKeyframe == 0 || m_anterior.size() != tamanho;
+    if (keyframe)
+    {
+        registro.tipo = REGISTRO_KEYFRAME;
+        registro.tamanhoDados = (uint32_t)comprimirRLE(frame, tamanho, m_comprimido.data());
+
+        EntradaIndiceGravacao entrada;
+        entrada.numeroFrame = registro.numeroFrame;
+        entrada.deslocamento = m_deslocamento;
+        m_indice.push_back(entrada);
+        m_estatisticas.keyframes++;
+    }
+    else
+    {
+        // Delta: o que não mudou vira zero (e os zeros viram poucas sequências)
+        m_xor.resize(tamanho);
+        for (size_t k = 0; k < tamanho; k++)
+            m_xor[k] = frame[k] ^ m_anterior[k];
+        registro.tipo = REGISTRO_DELTA;
+        registro.tamanhoDados = (uint32_t)comprimirRLE(m_xor.data(), tamanho, m_comprimido.data());
+    }
+
+    _anexar(&registro, sizeof(registro));
+    _anexar(m_comprimido.data(), registro.tamanhoDados);
+    m_anterior.assign(frame, frame + tamanho);
+
+    m_estatisticas.frames++;
+    m_estatisticas.bytesBrutos += tamanho;
+
+    // Keyframe é ponto de recuperação: chega ao arquivo logo
+    if (keyframe || m_pendente.size() >= TAMANHO_BLOCO_ESCRITA)
+        _descarregar();
+}
+
+void GravadorFrameBuffer::fechar()
+{
+    if (m_fd == -1)
+        return;
+
+    RodapeGravacao rodape = {};
+    rodape.deslocamentoIndice = m_deslocamento;
+    rodape.entradasIndice = m_indice.size();
+    rodape.totalFrames = m_estatisticas.frames;
+    rodape.magic = MAGIC_RODAPE_GRAVACAO;
+    if (!m_indice.empty())
+        _anexar(m_indice.data(), m_indice.size() * sizeof(EntradaIndiceGravacao));
+    _anexar(&rodape, sizeof(rodape));
+    _descarregar();
+
+    close(m_fd);
+    m_fd = -1;
+    SIM_LOG(LOG_INFO, "GRAVADOR", "Gravação fechada: {} frames, {} keyframes, {} bytes brutos -> {} bytes.",
+            m_estatisticas.frames, m_estatisticas.keyframes, m_estatisticas.bytesBrutos, m_estatisticas.bytesGravados);
+}
+
+void GravadorFrameBuffer::_anexar(const void *dados, size_t tamanho)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(dados);
+    m_pendente.insert(m_pendente.end(), bytes, bytes + tamanho);
+    m_deslocamento += tamanho;
+    m_estatisticas.bytesGravados += tamanho;
+}
+
+void GravadorFrameBuffer::_descarregar()
+{
+    size_t escrito = 0;
+    while (escrito < m_pendente.size())
+    {
+        ssize_t n = write(m_fd, m_pendente.data() + escrito, m_pendente.size() - escrito);
+        if (n <= 0)
+        {
+            if (n == -1 && errno == EINTR)
+                continue;
+            SIM_LOG(LOG_ERRO, "GRAVADOR", "ERRO: Falha ao gravar (errno {}). Gravação interrompida.", errno);
+            close(m_fd);
+            m_fd = -1;
+            break;
+        }
+        escrito += (size_t)n;
+    }
+    m_pendente.clear();
+}
@@ -0,0 +1,76 @@
+#ifndef GRAVADOR_FRAMEBUFFER_H
+#define GRAVADOR_FRAMEBUFFER_H
+
+#include "../interface/IFrameBuffer.h"
+#include "FormatoGravacao.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class GravadorFrameBuffer
+ * @brief IFrameBuffer que grava todos os frames num arquivo binário
+ * comprimido (formato FormatoGravacao.h), para reprodução com ./player.
+ *
+ * Cada frame vira o XOR com o anterior comprimido com RLE (um frame
+ * parado custa ~30 bytes em vez de 1944), com keyframes periódicos e
+ * um índice no fim para o player saltar direto a qualquer ponto.
+ * Os registros são acumulados e escritos em blocos (e a cada keyframe),
+ * não um write() por frame.
+ */
+class GravadorFrameBuffer : public IFrameBuffer
+{
+public:
+    /**
+     * @param intervaloKeyframe Frames entre keyframes (ex: 300 = 10 s a 30 Hz).
+     */
+    GravadorFrameBuffer(const std::string &caminhoArquivo, int largura, int altura,
+                        uint32_t intervaloKeyframe = 300);
+    ~GravadorFrameBuffer() override;
+
+    GravadorFrameBuffer(const GravadorFrameBuffer &) = delete;
+    GravadorFrameBuffer &operator=(const GravadorFrameBuffer &) = delete;
+
+    bool valido() const { return m_fd != -1; }
+
+    void limpar() override {}
+    void atualizar(const std::string &conteudo) override;
+
+    /**
+     * @brief Escreve o que falta, o índice e o rodapé, e fecha o arquivo.
+     * (Chamado também pelo destrutor.)
+     */
+    void fechar();
+
+    struct Estatisticas
+    {
+        uint64_t frames = 0;
+        uint64_t keyframes = 0;
+        uint64_t bytesBrutos = 0;   // Soma dos frames recebidos
+        uint64_t bytesGravados = 0; // Registros + dados comprimidos
+    };
+    const Estatisticas &estatisticas() const { return m_estatisticas; }
+
+private:
+    static const size_t TAMANHO_BLOCO_ESCRITA = 64 * 1024;
+
+    int m_fd;
+    uint64_t m_deslocamento; // Onde o próximo registro vai parar no arquivo
+    uint32_t m_intervaloKeyframe;
+    std::chrono::steady_clock::time_point m_inicio;
+
+    std::vector<uint8_t> m_anterior; // Último frame gravado
+    std::vector<uint8_t> m_xor;
+    std::vector<uint8_t> m_comprimido;
+    std::vector<uint8_t> m_pendente; // Ainda não escrito no arquivo
+    std::vector<EntradaIndiceGravacao> m_indice;
+
+    Estatisticas m_estatisticas;
+
+    void _anexar(const void *dados, size_t tamanho);
+    void _descarregar();
+};
+
+#endif // GRAVADOR_FRAMEBUFFER_H
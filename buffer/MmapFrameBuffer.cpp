@@ -0,0 +1,401 @@
+#include "MmapFrameBuffer.h"
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+
+#include <algorithm> // Para std::min
+#include <chrono>
+#include <cerrno>
+#include <cstring>   // Para memcpy, memset
+
+// --- DEPENDÊNCIAS POSIX PARA MMAP ---
+#include <sys/mman.h> // mmap, munmap
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, ftruncate, pwrite
+#include <sys/stat.h> // mode_t
+// ------------------------------------
+
+MmapFrameBuffer::MmapFrameBuffer(const std::string& caminhoArquivo, int largura, int altura,
+                                 const std::string& caminhoPersistencia, uint32_t formato)
+    : m_caminhoArquivo(caminhoArquivo), m_formato(formato), m_cabecalho(nullptr), m_size(0), m_sequencia(0), m_tamanhoSombra(0), m_tamanhoDesenho(0),
+      m_caminhoPersistencia(caminhoPersistencia), m_encerrar(false) {
+
+    SIM_LOG(LOG_INFO, "MMAP FB", "Inicializando MmapFrameBuffer...");
+
+    // Um visor que ainda mapeia o arquivo de uma execução anterior é
+    // avisado da troca, como num redimensionar()
+    if (!_criarArquivo(largura, altura)) {
+        return;
+    }
+
+    // Persistência em disco (opcional), fora do caminho do frame
+    if (!m_caminhoPersistencia.empty()) {
+        m_threadPersistencia = std::thread(&MmapFrameBuffer::_loopPersistencia, this);
+    }
+
+    SIM_LOG(LOG_INFO, "MMAP FB", "Mmap bem-sucedido. Framebuffer pronto ({}x{}, {} slots).", largura, altura, NUM_SLOTS_FRAME_SHM);
+}
+
+MmapFrameBuffer::~MmapFrameBuffer() {
+    if (m_threadPersistencia.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutexPersistencia);
+            m_encerrar = true;
+        }
+        m_cvPersistencia.notify_one();
+        m_threadPersistencia.join();
+    }
+    if (m_cabecalho != nullptr) {
+        munmap(m_cabecalho, m_size);
+    }
+}
+
+void MmapFrameBuffer::redimensionar(int largura, int altura) {
+    if (m_cabecalho == nullptr || largura <= 0 || altura <= 0 ||
+        ((int)m_cabecalho->largura == largura && (int)m_cabecalho->altura == altura)) {
+        return;
+    }
+    if (_criarArquivo(largura, altura)) {
+        SIM_LOG(LOG_INFO, "MMAP FB", "Framebuffer redimensionado para {}x{}.", largura, altura);
+    }
+}
+
+bool MmapFrameBuffer::_criarArquivo(int largura, int altura) {
+    // Texto: o maior entre "\x1b[H" + W * H e W * H + H newlines (80 * 24 + 24 = 1944 bytes).
+    // Células: 1 + 4 + 4 bytes por célula (80 * 24 = 17280 bytes).
+    const size_t celulas = (size_t)largura * (size_t)altura;
+    uint32_t tamanhoSlot = m_formato == FORMATO_FRAME_CELULAS ? (uint32_t)tamanhoCelulasShm(celulas)
+                                                              : (uint32_t)tamanhoTextoShm(largura, altura);
+    size_t tamanhoArquivo = tamanhoArquivoFrameShm(NUM_SLOTS_FRAME_SHM, tamanhoSlot);
+
+    // 1. Cria o arquivo novo ao lado do atual: ninguém o vê pela metade
+    std::string caminhoNovo = m_caminhoArquivo + ".novo";
+    int fd = open(caminhoNovo.c_str(), O_CREAT | O_RDWR | O_TRUNC, (mode_t)0600);
+    if (fd == -1) {
+        SIM_LOG(LOG_ERRO, "MMAP FB", "ERRO: Falha ao abrir/criar o arquivo (errno {}).", errno);
+        return false;
+    }
+
+    // 2. Define o tamanho do arquivo (Crucial para MMAP)
+    if (ftruncate(fd, tamanhoArquivo) == -1) {
+        SIM_LOG(LOG_ERRO, "MMAP FB", "ERRO: Falha ao definir o tamanho do arquivo com ftruncate (errno {}).", errno);
+        close(fd);
+        unlink(caminhoNovo.c_str());
+        return false;
+    }
+
+    // 3. Mapeia o arquivo para a memória (o mapeamento sobrevive ao close)
+    void* ptr = mmap(0, tamanhoArquivo, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        SIM_LOG(LOG_ERRO, "MMAP FB", "ERRO: Falha ao mapear o arquivo para a memória com mmap (errno {}).", errno);
+        unlink(caminhoNovo.c_str());
+        return false;
+    }
+    CabecalhoFrameShm* cabecalho = static_cast<CabecalhoFrameShm*>(ptr);
+
+    // 4. Monta o cabeçalho. O 'magic' é escrito por último:
+    // um leitor que o vê já encontra o resto do formato pronto.
+    memset(ptr, 0, tamanhoArquivo);
+    cabecalho->versao = VERSAO_FRAME_SHM;
+    cabecalho->largura = (uint32_t)largura;
+    cabecalho->altura = (uint32_t)altura;
+    cabecalho->numSlots = NUM_SLOTS_FRAME_SHM;
+    cabecalho->tamanhoSlot = tamanhoSlot;
+    cabecalho->formato = m_formato;
+    cabecalho->slotPublicado.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    cabecalho->magic = MAGIC_FRAME_SHM;
+
+    // 5. Passa a escrever no novo (a persistência lê m_cabecalho sob o mutex)
+    CabecalhoFrameShm* antigo = nullptr;
+    size_t tamanhoAntigo = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexPersistencia);
+        antigo = m_cabecalho;
+        tamanhoAntigo = m_size;
+        m_cabecalho = cabecalho;
+        m_size = tamanhoArquivo;
+
+        // Sombra e bitmaps de blocos sujos (um por slot)
+        m_sombra.assign(tamanhoSlot, ' ');
+        m_tamanhoDesenho = 0; // Um frameParaDesenho() anterior apontava para a sombra antiga
+        size_t palavras = ((tamanhoSlot + TAMANHO_BLOCO - 1) / TAMANHO_BLOCO + 63) / 64;
+        for (auto& bitmap : m_blocosSujos) {
+            bitmap.assign(palavras, 0);
+        }
+        if (m_formato == FORMATO_FRAME_CELULAS) {
+            m_celulasDeTexto.redimensionar(largura, altura);
+        }
+
+        // Publica um frame em branco antes de o arquivo aparecer no caminho
+        limpar();
+    }
+
+    // 6. Troca atômica no caminho, e avisa quem ainda mapeia o arquivo
+    // anterior (deste processo ou de uma execução passada) para reabrir
+    int fdAntigo = open(m_caminhoArquivo.c_str(), O_RDWR);
+    if (rename(caminhoNovo.c_str(), m_caminhoArquivo.c_str()) == -1) {
+        SIM_LOG(LOG_ERRO, "MMAP FB", "ERRO: Falha ao colocar o arquivo novo no lugar com rename (errno {}).", errno);
+    }
+    if (fdAntigo != -1) {
+        struct stat info;
+        if (fstat(fdAntigo, &info) == 0 && (size_t)info.st_size >= sizeof(CabecalhoFrameShm)) {
+            void* ptrAntigo = mmap(0, sizeof(CabecalhoFrameShm), PROT_READ | PROT_WRITE, MAP_SHARED, fdAntigo, 0);
+            if (ptrAntigo != MAP_FAILED) {
+                CabecalhoFrameShm* c = static_cast<CabecalhoFrameShm*>(ptrAntigo);
+                if (c->magic == MAGIC_FRAME_SHM && c->versao == VERSAO_FRAME_SHM) {
+                    c->substituido.store(1, std::memory_order_seq_cst);
+                    avisarLeitoresFrameShm(c);
+                }
+                munmap(ptrAntigo, sizeof(CabecalhoFrameShm));
+            }
+        }
+        close(fdAntigo);
+    }
+    if (antigo != nullptr) {
+        munmap(antigo, tamanhoAntigo);
+    }
+    return true;
+}
+
+void MmapFrameBuffer::limpar() {
+    if (m_cabecalho == nullptr) {
+        return;
+    }
+    if (m_formato == FORMATO_FRAME_CELULAS) {
+        // Espaços nas cores padrão
+        m_celulasDeTexto.limpar();
+        atualizarCelulas(m_celulasDeTexto);
+        return;
+    }
+    // Publica um frame só de espaços
+    memset(m_sombra.data(), ' ', m_sombra.size());
+    m_tamanhoSombra = m_sombra.size();
+    _marcarSujo(0, m_tamanhoSombra);
+    _publicar();
+}
+
+void MmapFrameBuffer::atualizar(const std::string& conteudo) {
+    if (m_cabecalho == nullptr || conteudo.empty()) {
+        return;
+    }
+    if (m_formato == FORMATO_FRAME_CELULAS) {
+        m_celulasDeTexto.deTexto(conteudo.data(), conteudo.size());
+        atualizarCelulas(m_celulasDeTexto);
+        return;
+    }
+    size_t tamanho = std::min(conteudo.size(), m_sombra.size());
+    memcpy(m_sombra.data(), conteudo.data(), tamanho);
+    m_tamanhoSombra = tamanho;
+    _marcarSujo(0, tamanho);
+    _publicar();
+}
+
+void MmapFrameBuffer::atualizarRegioes(const std::string& conteudo, const RegiaoSuja* regioes, size_t quantidade) {
+    if (m_cabecalho == nullptr || conteudo.empty()) {
+        return;
+    }
+    // Um frame de outro tamanho (ou texto num framebuffer de células)
+    // não tem como ser um delta da sombra
+    if (m_formato == FORMATO_FRAME_CELULAS || conteudo.size() != m_tamanhoSombra) {
+        atualizar(conteudo);
+        return;
+    }
+
+    for (size_t k = 0; k < quantidade; k++) {
+        size_t inicio = regioes[k].deslocamento;
+        size_t fim = std::min(inicio + regioes[k].tamanho, m_tamanhoSombra);
+        if (inicio >= fim) {
+            continue;
+        }
+        memcpy(m_sombra.data() + inicio, conteudo.data() + inicio, fim - inicio);
+        _marcarSujo(inicio, fim);
+    }
+    _publicar();
+}
+
+char* MmapFrameBuffer::frameParaDesenho(size_t tamanho) {
+    if (m_cabecalho == nullptr || m_formato != FORMATO_FRAME_TEXTO || tamanho == 0 || tamanho > m_sombra.size()) {
+        return nullptr;
+    }
+    m_tamanhoDesenho = tamanho;
+    return m_sombra.data();
+}
+
+void MmapFrameBuffer::publicarDesenho(const RegiaoSuja* regioes, size_t quantidade) {
+    if (m_cabecalho == nullptr || m_tamanhoDesenho == 0) {
+        return;
+    }
+    // A sombra já tem o frame novo: só falta marcar o que mudou
+    m_tamanhoSombra = m_tamanhoDesenho;
+    m_tamanhoDesenho = 0;
+    for (size_t k = 0; k < quantidade; k++) {
+        size_t inicio = regioes[k].deslocamento;
+        size_t fim = std::min(inicio + regioes[k].tamanho, m_tamanhoSombra);
+        if (inicio < fim) {
+            _marcarSujo(inicio, fim);
+        }
+    }
+    _publicar();
+}
+
+void MmapFrameBuffer::atualizarCelulas(const FrameCelulas& celulas) {
+    if (m_cabecalho == nullptr || celulas.celulas() == 0) {
+        return;
+    }
+    if (m_formato != FORMATO_FRAME_CELULAS) {
+        // Framebuffer de texto: só os glifos
+        celulas.paraTexto(m_textoDeCelulas);
+        atualizar(m_textoDeCelulas);
+        return;
+    }
+    redimensionar(celulas.largura, celulas.altura); // Nada a fazer se o tamanho é o mesmo
+    _copiarCelulas(celulas, 0, celulas.celulas());
+    m_tamanhoSombra = m_sombra.size();
+    _publicar();
+}
+
+void MmapFrameBuffer::atualizarCelulasRegioes(const FrameCelulas& celulas, const RegiaoSuja* regioes, size_t quantidade) {
+    if (m_cabecalho == nullptr || m_formato != FORMATO_FRAME_CELULAS ||
+        celulas.largura != (int)m_cabecalho->largura || celulas.altura != (int)m_cabecalho->altura) {
+        atualizarCelulas(celulas);
+        return;
+    }
+
+    for (size_t k = 0; k < quantidade; k++) {
+        size_t inicio = regioes[k].deslocamento;
+        size_t fim = std::min(inicio + regioes[k].tamanho, celulas.celulas());
+        if (inicio < fim) {
+            _copiarCelulas(celulas, inicio, fim);
+        }
+    }
+    _publicar();
+}
+
+void MmapFrameBuffer::_copiarCelulas(const FrameCelulas& celulas, size_t inicio, size_t fim) {
+    // Um trecho em cada plano: glifos, frente e fundo
+    const size_t n = celulas.celulas();
+    const size_t quantidade = fim - inicio;
+    memcpy(m_sombra.data() + inicio, celulas.glifos.data() + inicio, quantidade);
+    _marcarSujo(inicio, fim);
+
+    const size_t frente = inicioFrenteCelulasShm(n) + inicio * sizeof(uint32_t);
+    memcpy(m_sombra.data() + frente, celulas.frente.data() + inicio, quantidade * sizeof(uint32_t));
+    _marcarSujo(frente, frente + quantidade * sizeof(uint32_t));
+
+    const size_t fundo = inicioFundoCelulasShm(n) + inicio * sizeof(uint32_t);
+    memcpy(m_sombra.data() + fundo, celulas.fundo.data() + inicio, quantidade * sizeof(uint32_t));
+    _marcarSujo(fundo, fundo + quantidade * sizeof(uint32_t));
+}
+
+void MmapFrameBuffer::_marcarSujo(size_t inicio, size_t fim) {
+    // Marca os blocos [inicio, fim) como sujos em TODOS os slots:
+    // cada slot precisa receber a mudança na próxima vez que for escrito.
+    for (size_t bloco = inicio / TAMANHO_BLOCO; bloco * TAMANHO_BLOCO < fim; bloco++) {
+        for (auto& bitmap : m_blocosSujos) {
+            bitmap[bloco / 64] |= 1ull << (bloco % 64);
+        }
+    }
+}
+
+void MmapFrameBuffer::_publicar() {
+    SIM_SPAN("framebuffer", "publicar");
+    CronometroMetrica cronometro(HIST_PUBLICACAO);
+
+    // 1. Escolhe o próximo slot (nunca o que os leitores estão vendo)
+    uint32_t indice = (m_cabecalho->slotPublicado.load(std::memory_order_relaxed) + 1) % m_cabecalho->numSlots;
+    CabecalhoSlot* slot = slotFrameShm(m_cabecalho, indice);
+    char* dados = dadosSlotFrameShm(slot);
+    std::vector<uint64_t>& bitmap = m_blocosSujos[indice];
+
+    // 2. Escrita protegida pelo seqlock (ímpar durante a cópia)
+    uint64_t seqlock = slot->seqlock.load(std::memory_order_relaxed);
+    slot->seqlock.store(seqlock + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Copia da sombra apenas os blocos que este slot ainda não tem
+    for (size_t palavra = 0; palavra < bitmap.size(); palavra++) {
+        uint64_t bits = bitmap[palavra];
+        while (bits != 0) {
+            size_t bloco = palavra * 64 + __builtin_ctzll(bits);
+            size_t inicio = bloco * TAMANHO_BLOCO;
+            size_t tamanho = std::min(TAMANHO_BLOCO, m_sombra.size() - inicio);
+            memcpy(dados + inicio, m_sombra.data() + inicio, tamanho);
+            bits &= bits - 1;
+        }
+        bitmap[palavra] = 0;
+    }
+    slot->tamanho = (uint32_t)m_tamanhoSombra;
+    slot->sequencia = ++m_sequencia;
+    slot->timestampNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    slot->seqlock.store(seqlock + 2, std::memory_order_release);
+
+    // 3. Publica o slot (troca atômica do índice)
+    m_cabecalho->slotPublicado.store(indice, std::memory_order_release);
+    m_cabecalho->sequencia.store(m_sequencia, std::memory_order_seq_cst);
+    avisarLeitoresFrameShm(m_cabecalho); // Ex: o ./visor dormindo no futex
+
+    // 4. Avisa a persistência (se houver); ela mesma lê o frame pelo seqlock
+    if (m_threadPersistencia.joinable()) {
+        m_cvPersistencia.notify_one();
+    }
+}
+
+void MmapFrameBuffer::_loopPersistencia() {
+    int fd = open(m_caminhoPersistencia.c_str(), O_CREAT | O_WRONLY | O_TRUNC, (mode_t)0644);
+    if (fd == -1) {
+        return;
+    }
+
+    std::vector<char> frame;
+    std::string texto; // Frames de células: o texto dos glifos
+    uint64_t ultimaSequencia = 0;
+    size_t ultimoTamanho = 0;
+
+    std::unique_lock<std::mutex> lock(m_mutexPersistencia);
+    for (;;) {
+        // Acorda a cada frame novo; se atrasar, pula direto para o mais recente
+        if (!m_encerrar) {
+            m_cvPersistencia.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        const bool ultimaVolta = m_encerrar; // Ainda grava o último frame antes de sair
+        if (m_cabecalho->sequencia.load(std::memory_order_acquire) == ultimaSequencia) {
+            if (ultimaVolta) {
+                break;
+            }
+            continue;
+        }
+
+        // A leitura fica sob o mutex: o redimensionar() troca o mapeamento
+        if (frame.size() < m_cabecalho->tamanhoSlot) {
+            frame.resize(m_cabecalho->tamanhoSlot);
+        }
+        uint64_t sequencia = 0, timestampNs = 0;
+        size_t tamanho = lerFrameShm(m_cabecalho, frame.data(), sequencia, timestampNs);
+        const char* dados = frame.data();
+        if (tamanho > 0 && m_cabecalho->formato == FORMATO_FRAME_CELULAS) {
+            textoDeGlifos(frame.data(), (int)m_cabecalho->largura, (int)m_cabecalho->altura, texto);
+            dados = texto.data();
+            tamanho = texto.size();
+        }
+        lock.unlock();
+        if (tamanho > 0) {
+            // Reescreve no lugar (sem reabrir o arquivo)
+            if (pwrite(fd, dados, tamanho, 0) == (ssize_t)tamanho && tamanho != ultimoTamanho) {
+                if (ftruncate(fd, tamanho) == 0) {
+                    ultimoTamanho = tamanho;
+                }
+            }
+            ultimaSequencia = sequencia;
+        }
+        lock.lock();
+        if (ultimaVolta) {
+            break;
+        }
+    }
+
+    close(fd);
+}
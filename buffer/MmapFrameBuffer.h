@@ -0,0 +1,104 @@
+#ifndef MMAP_FRAMEBUFFER_H
+#define MMAP_FRAMEBUFFER_H
+
+#include "../interface/IFrameBuffer.h"
+#include "FormatoFrameShm.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @class MmapFrameBuffer
+ * @brief Implementação de IFrameBuffer que usa memória mapeada
+ * por arquivo (mmap) para alta performance IPC.
+ *
+ * O arquivo segue o formato de FormatoFrameShm.h: vários slots de
+ * frame publicados por seqlock, para que leitores em outros processos
+ * nunca vejam um frame pela metade. Não há msync no caminho do frame.
+ *
+ * Atualizações parciais vão para uma cópia local ("sombra") do frame;
+ * cada slot guarda um bitmap dos blocos de 64 bytes que mudaram desde
+ * a última vez que ele foi escrito, e só esses blocos são copiados.
+ *
+ * Opcionalmente, uma thread em segundo plano persiste o último frame
+ * completo como texto puro (ex: sim_frame.txt, para o 'watch cat').
+ *
+ * No formato de células (FORMATO_FRAME_CELULAS) os slots guardam os
+ * planos de um FrameCelulas (glifo, frente e fundo); as regiões sujas
+ * viram um trecho em cada plano. Quem manda texto num framebuffer de
+ * células recebe os glifos nas cores padrão, e vice-versa.
+ *
+ * Mudar de tamanho recria o arquivo (rename() por cima do antigo, que é
+ * marcado como substituído): quem o mapeou só precisa reabrir o caminho.
+ */
+class MmapFrameBuffer : public IFrameBuffer {
+public:
+    /**
+     * @param caminhoArquivo Arquivo mapeado (formato FormatoFrameShm.h).
+     * @param largura, altura Dimensões do display (em caracteres).
+     * @param caminhoPersistencia Se não for vazio, o texto do último
+     * frame é gravado neste arquivo de forma assíncrona.
+     * @param formato FORMATO_FRAME_TEXTO ou FORMATO_FRAME_CELULAS.
+     */
+    MmapFrameBuffer(const std::string& caminhoArquivo, int largura, int altura,
+                    const std::string& caminhoPersistencia = "", uint32_t formato = FORMATO_FRAME_TEXTO);
+    ~MmapFrameBuffer() override;
+
+    void limpar() override;
+    void atualizar(const std::string& conteudo) override;
+    void atualizarRegioes(const std::string& conteudo, const RegiaoSuja* regioes, size_t quantidade) override;
+    void atualizarCelulas(const FrameCelulas& celulas) override;
+    void atualizarCelulasRegioes(const FrameCelulas& celulas, const RegiaoSuja* regioes, size_t quantidade) override;
+
+    /**
+     * @brief No formato de texto, empresta a sombra: o frame desenhado
+     * nela vai para os slots pelos mesmos blocos sujos do atualizarRegioes().
+     */
+    char* frameParaDesenho(size_t tamanho) override;
+    void publicarDesenho(const RegiaoSuja* regioes, size_t quantidade) override;
+
+    /**
+     * @brief Troca o arquivo por um do novo tamanho e publica um frame em
+     * branco nele. Chame da mesma thread que atualiza o framebuffer.
+     */
+    void redimensionar(int largura, int altura) override;
+
+private:
+    std::string m_caminhoArquivo;
+    uint32_t m_formato;
+    CabecalhoFrameShm* m_cabecalho; // Protegido por m_mutexPersistencia só na troca de arquivo
+    size_t m_size;
+    uint64_t m_sequencia; // Nº do último frame publicado por nós
+
+    // --- Delta entre frames ---
+    static const size_t TAMANHO_BLOCO = 64;
+    std::vector<char> m_sombra;                             // Frame atual completo
+    size_t m_tamanhoSombra;                                 // Bytes válidos na sombra
+    size_t m_tamanhoDesenho;                                // Do frameParaDesenho() em andamento
+    std::vector<uint64_t> m_blocosSujos[NUM_SLOTS_FRAME_SHM]; // 1 bit por bloco, por slot
+
+    // --- Conversão entre os formatos ---
+    FrameCelulas m_celulasDeTexto; // Texto recebido num framebuffer de células
+    std::string m_textoDeCelulas;  // Células recebidas num framebuffer de texto
+
+    // --- Persistência assíncrona ---
+    std::string m_caminhoPersistencia;
+    std::thread m_threadPersistencia;
+    std::mutex m_mutexPersistencia;
+    std::condition_variable m_cvPersistencia;
+    bool m_encerrar;
+
+    /**
+     * @brief Cria o arquivo largura x altura ao lado do atual, passa a
+     * escrever nele e o coloca no caminho (o antigo é avisado e desmapeado).
+     */
+    bool _criarArquivo(int largura, int altura);
+    void _marcarSujo(size_t inicio, size_t fim);
+    void _copiarCelulas(const FrameCelulas& celulas, size_t inicio, size_t fim); // Células [inicio, fim) para a sombra
+    void _publicar();
+    void _loopPersistencia();
+};
+
+#endif // MMAP_FRAMEBUFFER_H
@@ -0,0 +1,224 @@
+#ifndef NUCLEO_CPU_H
+#define NUCLEO_CPU_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef> // Para size_t
+#include <cstdint>
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+
+/**
+ * @brief Tempo em HLT de uma CPU (igual para qualquer NucleoCPU).
+ */
+struct EstatisticasOcioCPU
+{
+    uint64_t ticksOciosos = 0; // Ticks que terminaram em HLT
+    uint64_t esperas = 0;      // Chamadas a aguardarInterrupcao()
+    uint64_t tempoDormindoNs = 0;
+};
+
+/**
+ * @class NucleoCPU
+ * @brief A CPU (IDT, tick e HLT) com o controlador de IRQ e a aplicação
+ * como parâmetros de tipo.
+ *
+ * Com as interfaces, NucleoCPU<IControladorIRQ, IAplicacao> (a classe
+ * CPU), cada chamada do tick é virtual e a fiação é escolhida em tempo
+ * de execução: SMP, APIC, decoradores, o bench. Com tipos concretos
+ * marcados 'final' (ex: NucleoCPU<ControladorPIC, Escalonador>) as
+ * mesmas chamadas são resolvidas na compilação, e o que estiver no
+ * header (o caminho quente do PIC) vira código inline no tick.
+ *
+ * Controlador precisa de verificarInterrupcoes(), finalizarInterrupcao()
+ * e aguardarInterrupcao(); Aplicacao, de temTrabalho() e executarTick().
+ */
+template <typename Controlador, typename Aplicacao>
+class NucleoCPU
+{
+public:
+    // Uma entrada por linha de IRQ (mesmo tamanho do ControladorPIC)
+    static constexpr size_t TAMANHO_IDT = 256;
+
+    /**
+     * @brief Tipo da rotina guardada na IDT: uma função livre que
+     * recebe de volta o contexto registrado junto com ela.
+     */
+    typedef void (*RotinaISR)(void *contexto);
+
+    typedef EstatisticasOcioCPU EstatisticasOcio;
+
+    explicit NucleoCPU(Controlador &controlador) : m_controlador(controlador)
+    {
+        for (size_t i = 0; i < TAMANHO_IDT; i++)
+        {
+            m_idt[i].rotina = nullptr;
+            m_idt[i].contexto = nullptr;
+        }
+        SIM_LOG(LOG_INFO, "CPU", "CPU inicializada e conectada ao Controlador de IRQ.");
+    }
+
+    /**
+     * @brief Registra uma Rotina de Serviço de Interrupção (ISR)
+     * na "Interrupt Descriptor Table" (IDT) desta CPU.
+     *
+     * @param linha O número da IRQ (ex: 1 para teclado).
+     * @param rotina A função a ser executada (nullptr remove a entrada).
+     * @param contexto Ponteiro repassado à rotina a cada interrupção.
+     */
+    void registrarISR(int linha, RotinaISR rotina, void *contexto)
+    {
+        if (linha < 0 || static_cast<size_t>(linha) >= TAMANHO_IDT)
+        {
+            SIM_LOG(LOG_ERRO, "CPU", "ERRO: Linha IRQ {} fora da IDT. ISR ignorada.", linha);
+            return;
+        }
+        m_idt[linha].rotina = rotina;
+        m_idt[linha].contexto = contexto;
+        SIM_LOG(LOG_INFO, "CPU", "ISR registrada na IDT para a linha IRQ {}.", linha);
+    }
+
+    /**
+     * @brief Registra um objeto chamável (lambda, functor...) como ISR.
+     *
+     * A IDT NÃO copia nem é dona do objeto: guarda só o endereço dele,
+     * então 'isr' precisa viver enquanto estiver registrado (ex: uma
+     * variável local do main). A chamada é resolvida em tempo de
+     * compilação dentro do trampolim, sem std::function nem alocação.
+     */
+    template <typename F>
+    void registrarISR(int linha, F &isr)
+    {
+        registrarISR(linha, &NucleoCPU::_trampolimISR<F>, static_cast<void *>(&isr));
+    }
+
+    // Temporários morreriam antes da interrupção chegar: proibido.
+    template <typename F>
+    void registrarISR(int linha, const F &&isr) = delete;
+
+    /**
+     * @brief Carrega uma aplicação para ser executada pela CPU.
+     * (Simula o S.O. definindo o processo atual).
+     */
+    void carregarAplicacao(Aplicacao *app)
+    {
+        m_aplicacaoAtual = app;
+        SIM_LOG(LOG_INFO, "CPU", "Aplicação carregada na CPU.");
+    }
+
+    /**
+     * @brief Executa um "tick" do clock da CPU.
+     * Em um tick, a CPU primeiro verifica por interrupções.
+     * Se houver uma, ela a executa.
+     * Se não, ela roda um tick da aplicação (ou executa HLT).
+     */
+    void tick()
+    {
+        // A CPU não sabe se é um PIC, um APIC... só que segue o contrato
+        int linhaAtiva = m_controlador.verificarInterrupcoes();
+
+        if (linhaAtiva != -1)
+        {
+            // --- Interrupção Detectada ---
+            SIM_LOG(LOG_DEBUG, "CPU", "Interrupção detectada! (IRQ {}). Pausando trabalho.", linhaAtiva);
+
+            // A CPU consulta a IDT para encontrar o driver
+            // (acesso direto pelo índice: sem busca em árvore nem cópia)
+            const EntradaIDT *entrada = (static_cast<unsigned>(linhaAtiva) < TAMANHO_IDT) ? &m_idt[linhaAtiva] : nullptr;
+            if (__builtin_expect(entrada != nullptr && entrada->rotina != nullptr, 1))
+            {
+                SIM_LOG(LOG_DEBUG, "CPU", "Despachando para ISR...");
+                SIM_SPAN("cpu", "isr");
+                entrada->rotina(entrada->contexto); // Chama a função registrada
+                SIM_LOG(LOG_DEBUG, "CPU", "ISR concluído. Retomando...");
+            }
+            else
+            {
+                _interrupcaoNaoTratada(linhaAtiva);
+            }
+
+            // EOI: libera a linha (e as de menor prioridade) no controlador
+            m_controlador.finalizarInterrupcao(linhaAtiva);
+        }
+        else
+        {
+            // --- Sem Interrupção ---
+            if (m_aplicacaoAtual != nullptr && m_aplicacaoAtual->temTrabalho())
+            {
+                SIM_SPAN("cpu", "aplicacao");
+                m_aplicacaoAtual->executarTick();
+            }
+            else
+            {
+                // CPU ociosa: "HLT". Quem dirige o clock decide se dorme
+                // em aguardarInterrupcao() em vez de continuar girando
+                m_ociosa.store(true, std::memory_order_release);
+                m_ocio.ticksOciosos++;
+            }
+        }
+    }
+
+    /**
+     * @brief true depois de um tick em que não havia IRQ nem trabalho:
+     * a CPU executou "HLT" e só volta a ter o que fazer com uma interrupção.
+     */
+    bool estaOciosa() const { return m_ociosa.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Dorme (sem girar) até o controlador sinalizar uma IRQ
+     * ou o timeout vencer. Sai do estado ocioso.
+     * @return true se há interrupção pendente.
+     */
+    bool aguardarInterrupcao(unsigned timeoutMs)
+    {
+        SIM_SPAN("cpu", "hlt");
+        auto inicio = std::chrono::steady_clock::now();
+        bool pendente = m_controlador.aguardarInterrupcao(timeoutMs);
+        m_ocio.tempoDormindoNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now() - inicio)
+                                      .count();
+        m_ocio.esperas++;
+        m_ociosa.store(false, std::memory_order_release);
+        return pendente;
+    }
+
+    const EstatisticasOcio &estatisticasOcio() const { return m_ocio; }
+
+private:
+    /**
+     * @brief Uma entrada da IDT: um "delegate" não-dono.
+     * Sem ISR registrado, 'rotina' é nullptr.
+     */
+    struct EntradaIDT
+    {
+        RotinaISR rotina;
+        void *contexto;
+    };
+
+    Controlador &m_controlador;
+
+    // Nossa Tabela Descritora de Interrupções (IDT)
+    // Vetor plano indexado diretamente pela linha de IRQ
+    EntradaIDT m_idt[TAMANHO_IDT];
+
+    // O processo/aplicação que está rodando atualmente
+    Aplicacao *m_aplicacaoAtual = nullptr;
+
+    // HLT: lido por outras threads (ex: quem manda IPI para núcleos ociosos)
+    std::atomic<bool> m_ociosa{false};
+    EstatisticasOcio m_ocio;
+
+    template <typename F>
+    static void _trampolimISR(void *contexto)
+    {
+        (*static_cast<F *>(contexto))();
+    }
+
+    // Caminho raro (IRQ sem ISR): fora da linha e do cache quente do tick
+    [[gnu::cold, gnu::noinline]] void _interrupcaoNaoTratada(int linha)
+    {
+        SIM_LOG(LOG_AVISO, "CPU", "AVISO: IRQ {} disparada, mas NENHUM ISR registrado (Kernel Panic!)", linha);
+    }
+};
+
+#endif // NUCLEO_CPU_H
@@ -0,0 +1,125 @@
+#include "DiscoArquivo.h"
+
+#include "../log/Logger.h"
+
+#include <cerrno>
+#include <thread>
+
+// --- DEPENDÊNCIAS POSIX PARA MMAP ---
+#include <sys/mman.h> // mmap, munmap
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, ftruncate
+#include <sys/stat.h> // fstat
+// ------------------------------------
+
+DiscoArquivo::DiscoArquivo(const std::string &caminhoArquivo, ControladorDMA &dma, int canalDMA,
+                           size_t tamanhoBloco, uint64_t blocosSeNovo)
+    : m_dma(dma),
+      m_canalDMA(canalDMA),
+      m_tamanhoBloco(tamanhoBloco > 0 ? tamanhoBloco : 512),
+      m_totalBlocos(0),
+      m_fd(-1),
+      m_midia(nullptr),
+      m_tamanhoMidia(0),
+      m_somenteLeitura(false)
+{
+    // 1. Abre a mídia (leitura e escrita, se der; senão só leitura)
+    m_fd = open(caminhoArquivo.c_str(), O_CREAT | O_RDWR, (mode_t)0600);
+    if (m_fd == -1)
+    {
+        m_fd = open(caminhoArquivo.c_str(), O_RDONLY);
+        m_somenteLeitura = true;
+    }
+    if (m_fd == -1)
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: Falha ao abrir a mídia (errno {}).", errno);
+        return;
+    }
+
+    // 2. Tamanho: o do arquivo, ou 'blocosSeNovo' se ele acabou de ser criado
+    struct stat info;
+    if (fstat(m_fd, &info) == -1)
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: fstat falhou (errno {}).", errno);
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_tamanhoMidia = (size_t)info.st_size;
+    if (m_tamanhoMidia == 0 && blocosSeNovo > 0 && !m_somenteLeitura)
+    {
+        m_tamanhoMidia = (size_t)(blocosSeNovo * m_tamanhoBloco);
+        if (ftruncate(m_fd, (off_t)m_tamanhoMidia) == -1)
+        {
+            SIM_LOG(LOG_ERRO, "DISCO", "ERRO: ftruncate falhou (errno {}).", errno);
+            close(m_fd);
+            m_fd = -1;
+            return;
+        }
+    }
+    // Um bloco final incompleto fica fora do disco
+    m_totalBlocos = m_tamanhoMidia / m_tamanhoBloco;
+    if (m_totalBlocos == 0)
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: Mídia menor que um bloco.");
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    // 3. Mapeia a mídia: o DMA copia direto dela (e para ela)
+    int protecao = m_somenteLeitura ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void *ptr = mmap(0, m_tamanhoMidia, protecao, MAP_SHARED, m_fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: mmap da mídia falhou (errno {}).", errno);
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+    m_midia = static_cast<char *>(ptr);
+
+    SIM_LOG(LOG_INFO, "DISCO", "Disco pronto: {} blocos de {} bytes (canal DMA {}).", m_totalBlocos, m_tamanhoBloco, m_canalDMA);
+}
+
+DiscoArquivo::~DiscoArquivo()
+{
+    // Não desmapeia com o DMA ainda copiando da (ou para a) mídia
+    while (m_midia != nullptr && m_dma.ocupado(m_canalDMA))
+    {
+        std::this_thread::yield();
+    }
+    if (m_midia != nullptr)
+    {
+        munmap(m_midia, m_tamanhoMidia);
+    }
+    if (m_fd != -1)
+    {
+        close(m_fd);
+    }
+}
+
+bool DiscoArquivo::_intervaloValido(uint64_t lba, uint32_t quantidade) const
+{
+    return m_midia != nullptr && quantidade > 0 && lba < m_totalBlocos && quantidade <= m_totalBlocos - lba;
+}
+
+bool DiscoArquivo::lerBlocos(uint64_t lba, uint32_t quantidade, void *destino)
+{
+    if (!_intervaloValido(lba, quantidade))
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: Leitura fora do disco (lba {}, {} blocos).", lba, quantidade);
+        return false;
+    }
+    return m_dma.programar(m_canalDMA, m_midia + lba * m_tamanhoBloco, destino, (size_t)quantidade * m_tamanhoBloco);
+}
+
+bool DiscoArquivo::escreverBlocos(uint64_t lba, uint32_t quantidade, const void *origem)
+{
+    if (m_somenteLeitura || !_intervaloValido(lba, quantidade))
+    {
+        SIM_LOG(LOG_ERRO, "DISCO", "ERRO: Escrita recusada (lba {}, {} blocos).", lba, quantidade);
+        return false;
+    }
+    return m_dma.programar(m_canalDMA, origem, m_midia + lba * m_tamanhoBloco, (size_t)quantidade * m_tamanhoBloco);
+}
@@ -0,0 +1,65 @@
+#ifndef DISCO_ARQUIVO_H
+#define DISCO_ARQUIVO_H
+
+#include "../dma/ControladorDMA.h"
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t, uint64_t
+#include <string>
+
+/**
+ * @class DiscoArquivo
+ * @brief Um disco de blocos simulado, cuja "mídia" é um arquivo local
+ * mapeado em memória (mmap).
+ *
+ * O disco não copia nada: cada comando programa o seu canal no
+ * ControladorDMA, que move os blocos entre a mídia e a memória do SO.
+ * O fim do comando é a IRQ de conclusão do DMA (TC do canal).
+ */
+class DiscoArquivo
+{
+public:
+    /**
+     * @param caminhoArquivo Arquivo da mídia. Se não existir, é criado
+     * com 'blocosSeNovo' blocos zerados.
+     * @param canalDMA Canal do controlador reservado para este disco.
+     */
+    DiscoArquivo(const std::string &caminhoArquivo, ControladorDMA &dma, int canalDMA,
+                 size_t tamanhoBloco = 512, uint64_t blocosSeNovo = 0);
+    ~DiscoArquivo();
+
+    DiscoArquivo(const DiscoArquivo &) = delete;
+    DiscoArquivo &operator=(const DiscoArquivo &) = delete;
+
+    bool valido() const { return m_midia != nullptr; }
+    size_t tamanhoBloco() const { return m_tamanhoBloco; }
+    uint64_t totalBlocos() const { return m_totalBlocos; }
+    int canalDMA() const { return m_canalDMA; }
+
+    /**
+     * @brief Lê 'quantidade' blocos a partir de 'lba' para 'destino'.
+     * Retorna na hora: a conclusão chega pela IRQ do DMA.
+     * @return false se o intervalo é inválido ou o canal está ocupado.
+     */
+    bool lerBlocos(uint64_t lba, uint32_t quantidade, void *destino);
+
+    /**
+     * @brief Grava 'quantidade' blocos de 'origem' a partir de 'lba'.
+     */
+    bool escreverBlocos(uint64_t lba, uint32_t quantidade, const void *origem);
+
+private:
+    ControladorDMA &m_dma;
+    int m_canalDMA;
+    size_t m_tamanhoBloco;
+    uint64_t m_totalBlocos;
+
+    int m_fd;
+    char *m_midia;
+    size_t m_tamanhoMidia;
+    bool m_somenteLeitura;
+
+    bool _intervaloValido(uint64_t lba, uint32_t quantidade) const;
+};
+
+#endif // DISCO_ARQUIVO_H
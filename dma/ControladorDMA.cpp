@@ -0,0 +1,175 @@
+#include "ControladorDMA.h"
+
+#include "../log/Logger.h"
+
+#include <chrono>
+#include <cstring> // Para memcpy
+
+ControladorDMA::ControladorDMA(size_t tamanhoRajada)
+    : m_tamanhoRajada(tamanhoRajada > 0 ? tamanhoRajada : 1),
+      m_status(0),
+      m_sinalIRQAtivo(false),
+      m_controlador(nullptr),
+      m_linhaIRQ(-1),
+      m_encerrar(false)
+{
+    m_motor = std::thread(&ControladorDMA::_loopMotor, this);
+    SIM_LOG(LOG_INFO, "DMA", "Controlador DMA inicializado ({} canais, rajadas de {} bytes).", NUM_CANAIS, m_tamanhoRajada);
+}
+
+ControladorDMA::~ControladorDMA()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_encerrar = true;
+    }
+    m_cvTrabalho.notify_all();
+    m_motor.join();
+}
+
+bool ControladorDMA::programar(int canal, const void *origem, void *destino, size_t bytes)
+{
+    if (canal < 0 || canal >= NUM_CANAIS)
+    {
+        SIM_LOG(LOG_ERRO, "DMA", "ERRO: Canal {} inexistente.", canal);
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Canal &c = m_canais[canal];
+        if (c.ativo)
+        {
+            SIM_LOG(LOG_AVISO, "DMA", "AVISO: Canal {} ocupado. Transferência recusada.", canal);
+            return false;
+        }
+        c.origem = static_cast<const char *>(origem);
+        c.destino = static_cast<char *>(destino);
+        c.restantes = bytes;
+        c.tamanho = bytes;
+        c.ativo = true;
+
+        // TC antigo do canal não vale mais para esta transferência
+        m_status &= (uint8_t)~(1u << canal);
+        _atualizarSinalIRQ();
+    }
+    m_cvTrabalho.notify_one();
+    SIM_LOG(LOG_DEBUG, "DMA", "Canal {} programado: {} bytes.", canal, bytes);
+    return true;
+}
+
+bool ControladorDMA::ocupado(int canal) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return canal >= 0 && canal < NUM_CANAIS && m_canais[canal].ativo;
+}
+
+uint8_t ControladorDMA::lerStatus() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_status;
+}
+
+uint8_t ControladorDMA::reconhecer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint8_t status = m_status;
+    m_status = 0;
+    _atualizarSinalIRQ();
+    return status;
+}
+
+bool ControladorDMA::estaSinalIRQAtivo() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sinalIRQAtivo;
+}
+
+void ControladorDMA::conectarIRQ(IControladorIRQ *controlador, int linha)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_controlador = controlador;
+    m_linhaIRQ = linha;
+}
+
+ControladorDMA::Estatisticas ControladorDMA::estatisticas() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_estatisticas;
+}
+
+void ControladorDMA::_loopMotor()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    int proximo = 0;
+
+    while (true)
+    {
+        m_cvTrabalho.wait(lock, [this]
+                          {
+                              if (m_encerrar)
+                                  return true;
+                              for (const Canal &c : m_canais)
+                                  if (c.ativo)
+                                      return true;
+                              return false; });
+        if (m_encerrar)
+            return;
+
+        // Uma rajada por canal ativo, em rodízio
+        for (int n = 0; n < NUM_CANAIS; n++)
+        {
+            int k = (proximo + n) % NUM_CANAIS;
+            Canal &c = m_canais[k];
+            if (!c.ativo)
+                continue;
+            proximo = (k + 1) % NUM_CANAIS;
+
+            const size_t rajada = c.restantes < m_tamanhoRajada ? c.restantes : m_tamanhoRajada;
+            const char *origem = c.origem;
+            char *destino = c.destino;
+
+            // A cópia acontece fora do lock: o canal ativo não pode ser reprogramado
+            lock.unlock();
+            auto inicio = std::chrono::steady_clock::now();
+            std::memcpy(destino, origem, rajada);
+            uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - inicio)
+                              .count();
+            lock.lock();
+
+            c.origem += rajada;
+            c.destino += rajada;
+            c.restantes -= rajada;
+            m_estatisticas.rajadas++;
+            m_estatisticas.bytes += rajada;
+            m_estatisticas.tempoCopiandoNs += ns;
+
+            if (c.restantes == 0)
+            {
+                c.ativo = false;
+                m_estatisticas.transferencias++;
+                m_status |= (uint8_t)(1u << k);
+                SIM_LOG(LOG_DEBUG, "DMA", "Canal {} concluído ({} bytes). Sinalizando IRQ.", k, c.tamanho);
+                _atualizarSinalIRQ();
+            }
+            break;
+        }
+    }
+}
+
+void ControladorDMA::_atualizarSinalIRQ()
+{
+    bool novoEstadoIRQ = m_status != 0;
+    if (novoEstadoIRQ != m_sinalIRQAtivo)
+    {
+        m_sinalIRQAtivo = novoEstadoIRQ;
+        if (m_controlador != nullptr)
+        {
+            if (m_sinalIRQAtivo)
+                m_controlador->elevarLinha(m_linhaIRQ);
+            else
+                m_controlador->abaixarLinha(m_linhaIRQ);
+        }
+    }
+}
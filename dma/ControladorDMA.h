@@ -0,0 +1,101 @@
+#ifndef CONTROLADOR_DMA_H
+#define CONTROLADOR_DMA_H
+
+#include "../interface/IDispositivoIRQ.h"
+#include "../interface/IControladorIRQ.h"
+
+#include <condition_variable>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint8_t, uint64_t
+#include <mutex>
+#include <thread>
+
+/**
+ * @class ControladorDMA
+ * @brief Simula um controlador de DMA (estilo 8237, com IRQ de conclusão).
+ *
+ * Um dispositivo programa um canal com origem, destino e tamanho; o
+ * motor do DMA (uma thread própria, como um bus master) copia o bloco
+ * em rajadas sem passar pela CPU e, ao terminar, marca o bit TC
+ * ("terminal count") do canal no registrador de status. A linha de IRQ
+ * fica alta enquanto houver algum TC não reconhecido (disparo por nível):
+ * uma única IRQ por bloco, em vez de uma por byte.
+ */
+class ControladorDMA : public IDispositivoIRQ
+{
+public:
+    static const int NUM_CANAIS = 4;
+
+    /**
+     * @param tamanhoRajada Bytes copiados por vez antes de o motor
+     * olhar os outros canais (divide o barramento entre eles).
+     */
+    explicit ControladorDMA(size_t tamanhoRajada = 64 * 1024);
+    ~ControladorDMA() override;
+
+    ControladorDMA(const ControladorDMA &) = delete;
+    ControladorDMA &operator=(const ControladorDMA &) = delete;
+
+    /**
+     * @brief Programa e dispara uma transferência no canal.
+     * As duas regiões precisam viver até o TC do canal.
+     * @return false se o canal é inválido ou ainda está ocupado.
+     */
+    bool programar(int canal, const void *origem, void *destino, size_t bytes);
+
+    bool ocupado(int canal) const;
+
+    /**
+     * @brief Registrador de status: bit k = canal k terminou (TC).
+     */
+    uint8_t lerStatus() const;
+
+    /**
+     * @brief Lido pelo ISR: devolve o status e limpa os TCs lidos
+     * (a linha de IRQ abaixa quando não sobra nenhum).
+     */
+    uint8_t reconhecer();
+
+    bool estaSinalIRQAtivo() const override;
+    void conectarIRQ(IControladorIRQ *controlador, int linha) override;
+
+    struct Estatisticas
+    {
+        uint64_t transferencias = 0;
+        uint64_t bytes = 0;
+        uint64_t rajadas = 0;
+        uint64_t tempoCopiandoNs = 0;
+    };
+    Estatisticas estatisticas() const;
+
+private:
+    struct Canal
+    {
+        const char *origem = nullptr;
+        char *destino = nullptr;
+        size_t restantes = 0;
+        size_t tamanho = 0;
+        bool ativo = false;
+    };
+
+    const size_t m_tamanhoRajada;
+    Canal m_canais[NUM_CANAIS];
+    uint8_t m_status;
+    bool m_sinalIRQAtivo;
+    Estatisticas m_estatisticas;
+
+    // O "fio" até o controlador de interrupções
+    IControladorIRQ *m_controlador;
+    int m_linhaIRQ;
+
+    // --- Motor (bus master) ---
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cvTrabalho;
+    bool m_encerrar;
+    std::thread m_motor;
+
+    void _loopMotor();
+    void _atualizarSinalIRQ();
+};
+
+#endif // CONTROLADOR_DMA_H
@@ -18,6 +18,31 @@ public:
      * @return O número da linha ativa, ou -1 se nenhuma.
      */
     virtual int verificarInterrupcoes() = 0;
+
+    /**
+     * @brief Lado dos dispositivos: o sinal da linha subiu / desceu.
+     * (Chamados pelo próprio dispositivo, quando o seu estado muda)
+     */
+    virtual void elevarLinha(int linha) { (void)linha; }
+    virtual void abaixarLinha(int linha) { (void)linha; }
+
+    /**
+     * @brief Lado da CPU: "End Of Interrupt". O ISR da linha terminou,
+     * e linhas de prioridade igual ou menor podem voltar a disparar.
+     */
+    virtual void finalizarInterrupcao(int linha) { (void)linha; }
+
+    /**
+     * @brief Lado da CPU: "HLT". Bloqueia a thread até alguma linha
+     * ficar pendente (ou o timeout vencer).
+     * @return true se há interrupção pendente. O padrão não sabe
+     * bloquear e retorna false na hora (a CPU volta ao polling).
+     */
+    virtual bool aguardarInterrupcao(unsigned timeoutMs)
+    {
+        (void)timeoutMs;
+        return false;
+    }
 };
 
-#endif // I_CONTROLADOR_IRQ_H
\ No newline at end of file
+#endif // I_CONTROLADOR_IRQ_H
@@ -1,6 +1,8 @@
 #ifndef I_DISPOSITIVO_IRQ_H
 #define I_DISPOSITIVO_IRQ_H
 
+class IControladorIRQ;
+
 /**
  * @class IDispositivoIRQ
  * @brief Interface (contrato) para qualquer hardware que possa
@@ -21,6 +23,19 @@ public:
      * @return true se o sinal está ATIVO, false caso contrário.
      */
     virtual bool estaSinalIRQAtivo() const = 0;
+
+    /**
+     * @brief Chamado pelo controlador ao registrar o dispositivo
+     * ("soldar o fio" da linha). A partir daí o dispositivo deve avisar
+     * as mudanças do seu sinal com controlador->elevarLinha(linha) /
+     * abaixarLinha(linha): o controlador não consulta mais ninguém a
+     * cada tick.
+     */
+    virtual void conectarIRQ(IControladorIRQ *controlador, int linha)
+    {
+        (void)controlador;
+        (void)linha;
+    }
 };
 
-#endif // I_DISPOSITIVO_IRQ_H
\ No newline at end of file
+#endif // I_DISPOSITIVO_IRQ_H
@@ -2,6 +2,20 @@
 #define I_FRAMEBUFFER_H
 
 #include <string>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t
+#include "../buffer/FrameCelulas.h"
+
+/**
+ * @struct RegiaoSuja
+ * @brief Um trecho contínuo do frame que mudou desde a última
+ * atualização (deslocamento e tamanho em bytes dentro do conteúdo).
+ */
+struct RegiaoSuja
+{
+    uint32_t deslocamento;
+    uint32_t tamanho;
+};
 
 class IFrameBuffer
 {
@@ -14,10 +28,79 @@ public:
      */
     virtual void atualizar(const std::string &conteudo) = 0;
 
+    /**
+     * @brief Atualiza apenas os trechos que mudaram.
+     * 'conteudo' é o frame completo; 'regioes' diz quais bytes dele
+     * diferem do frame anterior. Implementações que não sabem
+     * escrever parcialmente caem no atualizar() completo.
+     */
+    virtual void atualizarRegioes(const std::string &conteudo, const RegiaoSuja *regioes, size_t quantidade)
+    {
+        (void)regioes;
+        (void)quantidade;
+        atualizar(conteudo);
+    }
+
+    /**
+     * @brief Atualiza o frame inteiro a partir de células com cor.
+     * Implementações só de texto recebem o texto equivalente (só os glifos).
+     */
+    virtual void atualizarCelulas(const FrameCelulas &celulas)
+    {
+        std::string texto;
+        celulas.paraTexto(texto);
+        atualizar(texto);
+    }
+
+    /**
+     * @brief Como atualizarRegioes(), em células: cada região é um trecho
+     * de linha em índices de célula (linha * largura + coluna).
+     */
+    virtual void atualizarCelulasRegioes(const FrameCelulas &celulas, const RegiaoSuja *regioes, size_t quantidade)
+    {
+        (void)regioes;
+        (void)quantidade;
+        atualizarCelulas(celulas);
+    }
+
+    /**
+     * @brief Desenho direto: empresta a memória do frame atual (o texto
+     * completo, 'tamanho' bytes) para quem quer escrever nela só o que
+     * mudou, sem montar o frame numa string antes. nullptr se este
+     * framebuffer não empresta (decoradores, arquivo, células) ou se o
+     * tamanho não cabe: aí valem o atualizar() e o atualizarRegioes().
+     */
+    virtual char *frameParaDesenho(size_t tamanho)
+    {
+        (void)tamanho;
+        return nullptr;
+    }
+
+    /**
+     * @brief Publica o que foi escrito no frameParaDesenho(); 'regioes'
+     * são os trechos alterados.
+     */
+    virtual void publicarDesenho(const RegiaoSuja *regioes, size_t quantidade)
+    {
+        (void)regioes;
+        (void)quantidade;
+    }
+
+    /**
+     * @brief O display passou a ter outro tamanho (em caracteres): os
+     * próximos frames chegam com a nova geometria. Quem não depende
+     * dela (arquivo de texto, tela nula) não precisa fazer nada.
+     */
+    virtual void redimensionar(int largura, int altura)
+    {
+        (void)largura;
+        (void)altura;
+    }
+
     /**
      * @brief Limpa o framebuffer.
      */
     virtual void limpar() = 0;
 };
 
-#endif
\ No newline at end of file
+#endif
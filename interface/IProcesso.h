@@ -19,6 +19,12 @@ public:
      * (Chamado pela CPU quando não há interrupções).
      */
     virtual void executarTick() = 0;
+
+    /**
+     * @brief O próximo tick faria alguma coisa? Se não, a CPU pode
+     * executar HLT em vez de chamar executarTick() à toa.
+     */
+    virtual bool temTrabalho() const { return true; }
 };
 
 #endif
\ No newline at end of file
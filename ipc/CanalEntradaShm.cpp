@@ -0,0 +1,232 @@
+#include "CanalEntradaShm.h"
+
+#include <iostream>
+#include <ctime>    // clock_gettime, timespec
+
+// --- DEPENDÊNCIAS POSIX / LINUX ---
+#include <sys/mman.h>     // mmap, munmap
+#include <fcntl.h>        // open
+#include <unistd.h>       // close, ftruncate, syscall
+#include <sys/syscall.h>  // SYS_futex
+#include <linux/futex.h>  // FUTEX_WAIT, FUTEX_WAKE
+// ----------------------------------
+
+static const uint32_t MAGIC_CANAL = 0x43454E54; // "CENT"
+static const uint32_t VERSAO_CANAL = 1;
+static const size_t LINHA_CACHE = 64;
+
+/**
+ * @brief Layout do início do arquivo compartilhado.
+ * Os eventos vêm logo depois, em um array de CAPACIDADE posições.
+ */
+struct CanalEntradaShm::Cabecalho
+{
+    std::atomic<uint32_t> magic; // Escrito por último pelo dono (canal pronto)
+    uint32_t versao;
+    uint32_t capacidade;
+
+    alignas(LINHA_CACHE) std::atomic<uint64_t> cauda;  // Só o produtor escreve
+    alignas(LINHA_CACHE) std::atomic<uint64_t> cabeca; // Só o consumidor escreve
+
+    // Palavras de futex: incrementadas a cada publicação / consumo
+    alignas(LINHA_CACHE) std::atomic<uint32_t> sinalDados;
+    std::atomic<uint32_t> consumidorDormindo;
+    std::atomic<uint32_t> sinalEspaco;
+    std::atomic<uint32_t> produtorDormindo;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex precisa de uma palavra de 32 bits");
+
+static long _futex(std::atomic<uint32_t> *palavra, int op, uint32_t valor, const timespec *timeout)
+{
+    // Sem FUTEX_PRIVATE_FLAG: a palavra é compartilhada entre processos
+    return syscall(SYS_futex, reinterpret_cast<uint32_t *>(palavra), op, valor, timeout, nullptr, 0);
+}
+
+CanalEntradaShm::CanalEntradaShm(const std::string &caminhoArquivo, bool dono)
+    : m_caminhoArquivo(caminhoArquivo), m_fd(-1), m_cabecalho(nullptr), m_eventos(nullptr),
+      m_tamanho(sizeof(Cabecalho) + CAPACIDADE * sizeof(EventoTecla))
+{
+    // 1. Abre o arquivo (só o dono pode criá-lo)
+    int flags = dono ? (O_CREAT | O_RDWR) : O_RDWR;
+    m_fd = open(m_caminhoArquivo.c_str(), flags, (mode_t)0600);
+    if (m_fd == -1)
+    {
+        _log("ERRO: Falha ao abrir o canal: " + m_caminhoArquivo);
+        return;
+    }
+
+    // 2. O dono define o tamanho (o listener confia no que já existe)
+    if (dono && ftruncate(m_fd, m_tamanho) == -1)
+    {
+        _log("ERRO: Falha ao definir o tamanho do canal com ftruncate.");
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    // 3. Mapeia o anel
+    void *ptr = mmap(0, m_tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (ptr == MAP_FAILED)
+    {
+        _log("ERRO: Falha ao mapear o canal com mmap.");
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    m_cabecalho = static_cast<Cabecalho *>(ptr);
+    m_eventos = reinterpret_cast<EventoTecla *>(static_cast<char *>(ptr) + sizeof(Cabecalho));
+
+    if (dono)
+    {
+        // 4a. Zera o canal e só então o marca como pronto
+        m_cabecalho->magic.store(0, std::memory_order_relaxed);
+        m_cabecalho->versao = VERSAO_CANAL;
+        m_cabecalho->capacidade = CAPACIDADE;
+        m_cabecalho->cauda.store(0, std::memory_order_relaxed);
+        m_cabecalho->cabeca.store(0, std::memory_order_relaxed);
+        m_cabecalho->sinalDados.store(0, std::memory_order_relaxed);
+        m_cabecalho->consumidorDormindo.store(0, std::memory_order_relaxed);
+        m_cabecalho->sinalEspaco.store(0, std::memory_order_relaxed);
+        m_cabecalho->produtorDormindo.store(0, std::memory_order_relaxed);
+        m_cabecalho->magic.store(MAGIC_CANAL, std::memory_order_release);
+        _log("Canal de entrada criado em " + m_caminhoArquivo + ".");
+    }
+    else if (m_cabecalho->magic.load(std::memory_order_acquire) != MAGIC_CANAL ||
+             m_cabecalho->versao != VERSAO_CANAL || m_cabecalho->capacidade != CAPACIDADE)
+    {
+        // 4b. O simulador ainda não criou o canal (ou é de outra versão)
+        _log("ERRO: Canal inválido. O simulador está rodando?");
+        munmap(m_cabecalho, m_tamanho);
+        close(m_fd);
+        m_fd = -1;
+        m_cabecalho = nullptr;
+        m_eventos = nullptr;
+    }
+}
+
+CanalEntradaShm::~CanalEntradaShm()
+{
+    if (m_cabecalho != nullptr)
+    {
+        munmap(m_cabecalho, m_tamanho);
+    }
+    if (m_fd != -1)
+    {
+        close(m_fd);
+    }
+}
+
+bool CanalEntradaShm::valido() const
+{
+    return m_cabecalho != nullptr;
+}
+
+uint64_t CanalEntradaShm::agoraNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void CanalEntradaShm::publicar(char tecla)
+{
+    if (m_cabecalho == nullptr)
+        return;
+
+    const uint64_t cauda = m_cabecalho->cauda.load(std::memory_order_relaxed);
+
+    // 1. Anel cheio: dorme até o consumidor liberar espaço (sem perda)
+    while (cauda - m_cabecalho->cabeca.load(std::memory_order_acquire) >= CAPACIDADE)
+    {
+        uint32_t sinal = m_cabecalho->sinalEspaco.load(std::memory_order_acquire);
+        m_cabecalho->produtorDormindo.store(1, std::memory_order_seq_cst);
+        if (cauda - m_cabecalho->cabeca.load(std::memory_order_seq_cst) >= CAPACIDADE)
+        {
+            timespec timeout = {0, 10 * 1000 * 1000}; // Rede de segurança: 10 ms
+            _futex(&m_cabecalho->sinalEspaco, FUTEX_WAIT, sinal, &timeout);
+        }
+        m_cabecalho->produtorDormindo.store(0, std::memory_order_relaxed);
+    }
+
+    // 2. Escreve o evento e o publica
+    EventoTecla &evento = m_eventos[cauda & (CAPACIDADE - 1)];
+    evento.timestampNs = agoraNs();
+    evento.tecla = tecla;
+    m_cabecalho->cauda.store(cauda + 1, std::memory_order_release);
+
+    // 3. Acorda o simulador (a syscall só acontece se ele estiver dormindo)
+    m_cabecalho->sinalDados.fetch_add(1, std::memory_order_seq_cst);
+    if (m_cabecalho->consumidorDormindo.load(std::memory_order_seq_cst))
+    {
+        _futex(&m_cabecalho->sinalDados, FUTEX_WAKE, 1, nullptr);
+    }
+}
+
+size_t CanalEntradaShm::consumir(EventoTecla *destino, size_t max)
+{
+    if (m_cabecalho == nullptr)
+        return 0;
+
+    const uint64_t cabeca = m_cabecalho->cabeca.load(std::memory_order_relaxed);
+    const uint64_t cauda = m_cabecalho->cauda.load(std::memory_order_acquire);
+
+    size_t disponiveis = (size_t)(cauda - cabeca);
+    size_t n = disponiveis < max ? disponiveis : max;
+    for (size_t k = 0; k < n; k++)
+    {
+        destino[k] = m_eventos[(cabeca + k) & (CAPACIDADE - 1)];
+    }
+
+    if (n > 0)
+    {
+        m_cabecalho->cabeca.store(cabeca + n, std::memory_order_release);
+        m_cabecalho->sinalEspaco.fetch_add(1, std::memory_order_seq_cst);
+        if (m_cabecalho->produtorDormindo.load(std::memory_order_seq_cst))
+        {
+            _futex(&m_cabecalho->sinalEspaco, FUTEX_WAKE, 1, nullptr);
+        }
+    }
+    return n;
+}
+
+bool CanalEntradaShm::espiarUltimoEvento(EventoTecla &evento, uint64_t &total) const
+{
+    if (m_cabecalho == nullptr)
+        return false;
+
+    // O produtor só reescreve esta posição depois de mais CAPACIDADE eventos
+    total = m_cabecalho->cauda.load(std::memory_order_acquire);
+    if (total == 0)
+        return false;
+    evento = m_eventos[(total - 1) & (CAPACIDADE - 1)];
+    return true;
+}
+
+bool CanalEntradaShm::aguardarEventos(int timeoutMs)
+{
+    if (m_cabecalho == nullptr)
+        return false;
+
+    uint32_t sinal = m_cabecalho->sinalDados.load(std::memory_order_acquire);
+    m_cabecalho->consumidorDormindo.store(1, std::memory_order_seq_cst);
+
+    // Reconfere depois de anunciar que vai dormir (evita perder um wake)
+    bool vazio = m_cabecalho->cauda.load(std::memory_order_seq_cst) ==
+                 m_cabecalho->cabeca.load(std::memory_order_relaxed);
+    if (vazio)
+    {
+        timespec timeout = {timeoutMs / 1000, (long)(timeoutMs % 1000) * 1000000L};
+        _futex(&m_cabecalho->sinalDados, FUTEX_WAIT, sinal, &timeout);
+    }
+
+    m_cabecalho->consumidorDormindo.store(0, std::memory_order_relaxed);
+    return m_cabecalho->cauda.load(std::memory_order_acquire) !=
+           m_cabecalho->cabeca.load(std::memory_order_relaxed);
+}
+
+void CanalEntradaShm::_log(const std::string &mensagem)
+{
+    std::cout << "[CANAL SHM] " << mensagem << std::endl;
+}
@@ -0,0 +1,99 @@
+#ifndef CANAL_ENTRADA_SHM_H
+#define CANAL_ENTRADA_SHM_H
+
+#include <atomic>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t, uint64_t
+#include <string>
+
+/**
+ * @struct EventoTecla
+ * @brief Um evento de teclado como trafega no canal: a tecla e o
+ * instante (CLOCK_MONOTONIC, em ns) em que o listener a leu.
+ */
+struct EventoTecla
+{
+    uint64_t timestampNs;
+    char tecla;
+};
+
+/**
+ * @class CanalEntradaShm
+ * @brief Canal de IPC entre o listener (Produtor) e o simulador
+ * (Consumidor) através de um anel SPSC em memória compartilhada.
+ *
+ * O anel mora num arquivo mapeado com MAP_SHARED pelos dois processos.
+ * O consumidor pode dormir num futex até o produtor publicar algo,
+ * e o produtor espera (em vez de descartar) se o anel encher:
+ * nenhuma tecla é perdida.
+ */
+class CanalEntradaShm
+{
+public:
+    static const uint32_t CAPACIDADE = 4096; // Eventos (potência de 2)
+
+    /**
+     * @param caminhoArquivo O arquivo que dá nome ao canal.
+     * @param dono true no simulador: cria/zera o canal.
+     * false no listener: abre um canal já criado.
+     */
+    CanalEntradaShm(const std::string &caminhoArquivo, bool dono);
+    ~CanalEntradaShm();
+
+    CanalEntradaShm(const CanalEntradaShm &) = delete;
+    CanalEntradaShm &operator=(const CanalEntradaShm &) = delete;
+
+    /**
+     * @brief true se o mapeamento foi bem-sucedido.
+     */
+    bool valido() const;
+
+    // --- Lado do Produtor (listener) ---
+
+    /**
+     * @brief Publica uma tecla com o timestamp atual e acorda o consumidor.
+     * Bloqueia enquanto o anel estiver cheio.
+     */
+    void publicar(char tecla);
+
+    // --- Lado do Consumidor (simulador) ---
+
+    /**
+     * @brief Retira até 'max' eventos de uma vez, sem bloquear.
+     * @return Quantos eventos foram copiados para 'destino'.
+     */
+    size_t consumir(EventoTecla *destino, size_t max);
+
+    /**
+     * @brief Dorme até existir ao menos um evento ou até o timeout.
+     * @return true se há eventos para consumir.
+     */
+    bool aguardarEventos(int timeoutMs);
+
+    // --- Observador (ex: o visor medindo a latência) ---
+
+    /**
+     * @brief Olha o último evento publicado sem consumi-lo.
+     * @param total Recebe quantos eventos já foram publicados no canal.
+     * @return false se nenhum evento foi publicado ainda.
+     */
+    bool espiarUltimoEvento(EventoTecla &evento, uint64_t &total) const;
+
+    /**
+     * @brief Instante atual no mesmo relógio usado nos eventos.
+     */
+    static uint64_t agoraNs();
+
+private:
+    struct Cabecalho;
+
+    std::string m_caminhoArquivo;
+    int m_fd;
+    Cabecalho *m_cabecalho;
+    EventoTecla *m_eventos;
+    size_t m_tamanho;
+
+    void _log(const std::string &mensagem);
+};
+
+#endif // CANAL_ENTRADA_SHM_H
@@ -0,0 +1,172 @@
+#include "Escalonador.h"
+
+#include <chrono>
+#include <iomanip>
+
+#include "../log/Logger.h"
+
+Escalonador::Escalonador(Politica politica, uint32_t quantumBase)
+    : m_politica(politica),
+      m_quantumBase(quantumBase > 0 ? quantumBase : 1),
+      m_atual(0),
+      m_quantumRestante(0),
+      m_trocaPendente(false),
+      m_ticks(0),
+      m_trocas(0)
+{
+    if (m_politica == Politica::Ponderado)
+    {
+        SIM_LOG(LOG_INFO, "ESCALONADOR", "Escalonador ponderado iniciado (quantum base: {} IRQs de timer).", m_quantumBase);
+    }
+    else
+    {
+        SIM_LOG(LOG_INFO, "ESCALONADOR", "Escalonador round-robin iniciado (quantum: {} IRQs de timer).", m_quantumBase);
+    }
+}
+
+int Escalonador::adicionarProcesso(IAplicacao *app, const std::string &nome, uint32_t peso)
+{
+    Processo processo;
+    processo.app = app;
+    processo.nome = nome;
+    processo.peso = peso > 0 ? peso : 1;
+    processo.ultimoTick = m_ticks;
+    m_processos.push_back(processo);
+
+    // O primeiro processo já começa com a CPU
+    if (m_processos.size() == 1)
+    {
+        m_atual = 0;
+        m_processos[0].estatisticas.fatias = 1;
+        m_quantumRestante = _quantumDe(m_processos[0]);
+    }
+
+    int pid = (int)m_processos.size() - 1;
+    SIM_LOG(LOG_INFO, "ESCALONADOR", "Processo PID {} carregado (peso {}).", pid, processo.peso);
+    return pid;
+}
+
+void Escalonador::conectar(BufferDeEntradaOS *bufferEntrada, IFrameBuffer *framebuffer)
+{
+    (void)bufferEntrada;
+    (void)framebuffer;
+}
+
+void Escalonador::executarTick()
+{
+    if (m_processos.empty())
+        return; // CPU ociosa
+
+    if (m_trocaPendente)
+    {
+        _trocarContexto();
+    }
+
+    Processo &processo = m_processos[m_atual];
+
+    auto inicio = std::chrono::steady_clock::now();
+    processo.app->executarTick();
+    auto fim = std::chrono::steady_clock::now();
+
+    processo.estatisticas.ticksExecutados++;
+    processo.estatisticas.tempoCpuNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(fim - inicio).count();
+    processo.ultimoTick = ++m_ticks;
+}
+
+bool Escalonador::temTrabalho() const
+{
+    for (const Processo &processo : m_processos)
+    {
+        if (processo.app->temTrabalho())
+            return true;
+    }
+    return false;
+}
+
+void Escalonador::interrupcaoTimer()
+{
+    if (m_processos.empty())
+        return;
+
+    if (m_quantumRestante > 0)
+        m_quantumRestante--;
+
+    if (m_quantumRestante == 0)
+    {
+        if (m_processos.size() > 1)
+        {
+            // A troca acontece no próximo tick de aplicação, fora do ISR
+            m_trocaPendente = true;
+        }
+        else
+        {
+            m_quantumRestante = _quantumDe(m_processos[m_atual]);
+        }
+    }
+}
+
+uint32_t Escalonador::_quantumDe(const Processo &processo) const
+{
+    return m_politica == Politica::Ponderado ? m_quantumBase * processo.peso : m_quantumBase;
+}
+
+void Escalonador::_trocarContexto()
+{
+    m_trocaPendente = false;
+
+    // O "contexto" de cada processo já vive no seu objeto: trocar é
+    // escolher o próximo da fila circular e dar a ele um quantum novo.
+    m_processos[m_atual].estatisticas.preempcoes++;
+    m_atual = (m_atual + 1) % m_processos.size();
+
+    Processo &proximo = m_processos[m_atual];
+    uint64_t espera = m_ticks - proximo.ultimoTick;
+    if (espera > proximo.estatisticas.esperaMaximaTicks)
+        proximo.estatisticas.esperaMaximaTicks = espera;
+    proximo.estatisticas.fatias++;
+    m_quantumRestante = _quantumDe(proximo);
+    m_trocas++;
+
+    SIM_LOG(LOG_DEBUG, "ESCALONADOR", "Troca de contexto para o PID {} (esperou {} ticks).", m_atual, espera);
+}
+
+double Escalonador::indiceJustica() const
+{
+    if (m_processos.empty())
+        return 1.0;
+
+    // Jain: (soma x)^2 / (n * soma x^2), com x = ticks / peso
+    double soma = 0.0, somaQuadrados = 0.0;
+    for (const Processo &p : m_processos)
+    {
+        double peso = m_politica == Politica::Ponderado ? (double)p.peso : 1.0;
+        double x = (double)p.estatisticas.ticksExecutados / peso;
+        soma += x;
+        somaQuadrados += x * x;
+    }
+    return somaQuadrados > 0.0 ? (soma * soma) / ((double)m_processos.size() * somaQuadrados) : 1.0;
+}
+
+void Escalonador::relatar(std::ostream &saida) const
+{
+    saida << "[ESCALONADOR] politica=" << (m_politica == Politica::Ponderado ? "ponderado" : "round-robin")
+          << " processos=" << m_processos.size()
+          << " ticks=" << m_ticks
+          << " trocas=" << m_trocas
+          << " justica=" << std::fixed << std::setprecision(4) << indiceJustica() << std::defaultfloat << "\n";
+
+    saida << "[ESCALONADOR] " << std::left << std::setw(5) << "PID" << std::setw(16) << "nome" << std::right
+          << std::setw(6) << "peso" << std::setw(10) << "ticks" << std::setw(8) << "fatias"
+          << std::setw(8) << "preemp" << std::setw(12) << "cpu(ms)" << std::setw(12) << "espera max" << "\n";
+    for (size_t pid = 0; pid < m_processos.size(); pid++)
+    {
+        const Processo &p = m_processos[pid];
+        saida << "[ESCALONADOR] " << std::left << std::setw(5) << pid << std::setw(16) << p.nome << std::right
+              << std::setw(6) << p.peso
+              << std::setw(10) << p.estatisticas.ticksExecutados
+              << std::setw(8) << p.estatisticas.fatias
+              << std::setw(8) << p.estatisticas.preempcoes
+              << std::setw(12) << std::fixed << std::setprecision(2) << p.estatisticas.tempoCpuNs / 1e6 << std::defaultfloat
+              << std::setw(12) << p.estatisticas.esperaMaximaTicks << "\n";
+    }
+}
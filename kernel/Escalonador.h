@@ -0,0 +1,116 @@
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../interface/IProcesso.h"
+
+/**
+ * @class Escalonador
+ * @brief O "kernel": reparte a CPU entre vários processos (IAplicacao).
+ *
+ * Para a CPU ele é a aplicação carregada: a cada tick sem interrupção,
+ * executarTick() roda um tick do processo atual. O ISR do timer (IRQ 0)
+ * chama interrupcaoTimer(), que gasta o quantum do processo; quando ele
+ * acaba, o próximo tick troca de contexto para o próximo da fila.
+ *
+ * A fila de prontos é circular (todos os processos estão sempre prontos):
+ *  - RoundRobin: todos recebem 'quantumBase' interrupções de timer;
+ *  - Ponderado: cada um recebe 'quantumBase * peso'.
+ */
+class Escalonador final : public IAplicacao
+{
+public:
+    enum class Politica
+    {
+        RoundRobin,
+        Ponderado
+    };
+
+    struct EstatisticasProcesso
+    {
+        uint64_t ticksExecutados = 0;   // Ticks de CPU que o processo usou
+        uint64_t fatias = 0;            // Vezes que ganhou a CPU
+        uint64_t preempcoes = 0;        // Vezes que perdeu a CPU pelo timer
+        uint64_t tempoCpuNs = 0;        // Tempo real gasto nos seus ticks
+        uint64_t esperaMaximaTicks = 0; // Maior espera na fila (em ticks de CPU)
+    };
+
+    /**
+     * @param politica Round-robin simples ou fatias ponderadas pelo peso.
+     * @param quantumBase Interrupções de timer por fatia (peso 1).
+     */
+    explicit Escalonador(Politica politica = Politica::RoundRobin, uint32_t quantumBase = 1);
+
+    /**
+     * @brief Carrega um processo (já conectado às suas interfaces).
+     * @return O PID (índice) do processo.
+     */
+    int adicionarProcesso(IAplicacao *app, const std::string &nome, uint32_t peso = 1);
+
+    /**
+     * @brief (Contrato IAplicacao) Não usado: cada processo é conectado
+     * ao seu próprio teclado/tela antes de ser carregado.
+     */
+    void conectar(BufferDeEntradaOS *bufferEntrada, IFrameBuffer *framebuffer) override;
+
+    /**
+     * @brief Roda um tick do processo atual (trocando antes, se preciso).
+     */
+    void executarTick() override;
+
+    /**
+     * @brief Há trabalho se algum processo tiver trabalho.
+     */
+    bool temTrabalho() const override;
+
+    /**
+     * @brief Chamado pelo ISR do timer: consome o quantum do processo atual.
+     */
+    void interrupcaoTimer();
+
+    size_t numProcessos() const { return m_processos.size(); }
+    int processoAtual() const { return m_processos.empty() ? -1 : (int)m_atual; }
+    const EstatisticasProcesso &estatisticas(int pid) const { return m_processos[pid].estatisticas; }
+    uint64_t totalTrocas() const { return m_trocas; }
+
+    /**
+     * @brief Índice de justiça de Jain sobre os ticks por unidade de peso.
+     * 1.0 = divisão perfeita; 1/N = um único processo levou tudo.
+     */
+    double indiceJustica() const;
+
+    /**
+     * @brief Escreve a tabela de estatísticas por processo.
+     */
+    void relatar(std::ostream &saida) const;
+
+private:
+    struct Processo
+    {
+        IAplicacao *app;
+        std::string nome;
+        uint32_t peso;
+        uint64_t ultimoTick; // m_ticks na última vez que rodou
+        EstatisticasProcesso estatisticas;
+    };
+
+    Politica m_politica;
+    uint32_t m_quantumBase;
+
+    std::vector<Processo> m_processos;
+    size_t m_atual;
+    uint32_t m_quantumRestante;
+    bool m_trocaPendente;
+
+    uint64_t m_ticks; // Ticks de CPU entregues a processos (o "relógio" do kernel)
+    uint64_t m_trocas;
+
+    uint32_t _quantumDe(const Processo &processo) const;
+    void _trocarContexto();
+};
+
+#endif // ESCALONADOR_H
@@ -0,0 +1,264 @@
+#include "EscalonadorSMP.h"
+
+#include <chrono>
+#include <iomanip>
+
+#include "../log/Logger.h"
+
+// --- Fila de prontos de um núcleo (chamar com o m_mutex do núcleo) ---
+
+void EscalonadorSMP::Nucleo::_empurrar(int pid)
+{
+    m_anel[(m_inicio + m_quantidade) % m_anel.size()] = pid;
+    m_quantidade++;
+}
+
+int EscalonadorSMP::Nucleo::_retirarInicio()
+{
+    if (m_quantidade == 0)
+        return -1;
+    int pid = m_anel[m_inicio];
+    m_inicio = (m_inicio + 1) % m_anel.size();
+    m_quantidade--;
+    return pid;
+}
+
+int EscalonadorSMP::Nucleo::_retirarFim()
+{
+    if (m_quantidade == 0)
+        return -1;
+    m_quantidade--;
+    return m_anel[(m_inicio + m_quantidade) % m_anel.size()];
+}
+
+// --- EscalonadorSMP ---
+
+EscalonadorSMP::EscalonadorSMP(int numNucleos, Escalonador::Politica politica, uint32_t quantumBase)
+    : m_politica(politica),
+      m_quantumBase(quantumBase > 0 ? quantumBase : 1)
+{
+    if (numNucleos < 1)
+        numNucleos = 1;
+    for (int k = 0; k < numNucleos; k++)
+    {
+        m_nucleos.emplace_back(new Nucleo(*this, k));
+    }
+    SIM_LOG(LOG_INFO, "ESCALONADOR SMP", "Kernel SMP iniciado com {} núcleos.", numNucleos);
+}
+
+int EscalonadorSMP::adicionarProcesso(IAplicacao *app, const std::string &nome, uint32_t peso, int nucleo)
+{
+    int pid = (int)m_processos.size();
+
+    Processo processo;
+    processo.app = app;
+    processo.nome = nome;
+    processo.peso = peso > 0 ? peso : 1;
+    processo.ultimoNucleo = -1;
+    processo.enfileiradoNs = _agoraNs();
+    m_processos.push_back(processo);
+
+    // Cada anel comporta todos os processos: roubos nunca estouram a fila
+    for (auto &n : m_nucleos)
+    {
+        std::lock_guard<std::mutex> lock(n->m_mutex);
+        std::vector<int> anel(m_processos.size(), -1);
+        for (size_t k = 0; k < n->m_quantidade; k++)
+            anel[k] = n->m_anel[(n->m_inicio + k) % n->m_anel.size()];
+        n->m_anel.swap(anel);
+        n->m_inicio = 0;
+    }
+
+    if (nucleo < 0 || nucleo >= numNucleos())
+        nucleo = pid % numNucleos();
+    {
+        std::lock_guard<std::mutex> lock(m_nucleos[nucleo]->m_mutex);
+        m_nucleos[nucleo]->_empurrar(pid);
+    }
+
+    SIM_LOG(LOG_INFO, "ESCALONADOR SMP", "Processo PID {} carregado no núcleo {} (peso {}).", pid, nucleo, processo.peso);
+    return pid;
+}
+
+void EscalonadorSMP::interrupcaoTimer(int k)
+{
+    Nucleo &n = *m_nucleos[k];
+    if (n.m_quantumRestante > 0)
+        n.m_quantumRestante--;
+    if (n.m_quantumRestante == 0)
+        n.m_trocaPendente = true; // Troca no próximo tick, fora do ISR
+}
+
+void EscalonadorSMP::_executarTick(int k)
+{
+    Nucleo &n = *m_nucleos[k];
+
+    if (n.m_atual == -1 || n.m_trocaPendente)
+    {
+        _trocarContexto(k, _agoraNs());
+        if (n.m_atual == -1)
+        {
+            n.estatisticas.ticksOciosos++; // Nada para rodar em lugar nenhum
+            return;
+        }
+    }
+
+    Processo &processo = m_processos[n.m_atual];
+    uint64_t inicio = _agoraNs();
+    processo.app->executarTick();
+    processo.estatisticas.tempoCpuNs += _agoraNs() - inicio;
+    processo.estatisticas.ticksExecutados++;
+    n.estatisticas.ticks++;
+}
+
+bool EscalonadorSMP::_temTrabalho(int k) const
+{
+    Nucleo &n = *m_nucleos[k];
+
+    // Processos na fila (própria ou roubável) sempre contam: só o núcleo
+    // que roda um processo pode perguntar a ele se tem trabalho
+    if (n.m_atual != -1 && m_processos[n.m_atual].app->temTrabalho())
+        return true;
+    for (const auto &nucleo : m_nucleos)
+    {
+        std::lock_guard<std::mutex> lock(nucleo->m_mutex);
+        if (nucleo->m_quantidade > 0)
+            return true;
+    }
+    return false;
+}
+
+void EscalonadorSMP::_trocarContexto(int k, uint64_t agoraNs)
+{
+    Nucleo &n = *m_nucleos[k];
+    n.m_trocaPendente = false;
+
+    const int anterior = n.m_atual;
+    int proximo;
+    bool filaVazia;
+    {
+        std::lock_guard<std::mutex> lock(n.m_mutex);
+        proximo = n._retirarInicio();
+        filaVazia = (proximo == -1);
+    }
+
+    // Fila local vazia: tenta equilibrar roubando de outro núcleo
+    if (filaVazia)
+    {
+        proximo = _roubar(k);
+    }
+
+    if (proximo == -1)
+    {
+        // Ninguém esperando: o processo atual (se houver) continua
+        n.m_quantumRestante = anterior == -1 ? 0 : _quantumDe(anterior);
+        return;
+    }
+
+    if (anterior != -1)
+    {
+        Processo &saindo = m_processos[anterior];
+        saindo.estatisticas.preempcoes++;
+        saindo.enfileiradoNs = agoraNs;
+        std::lock_guard<std::mutex> lock(n.m_mutex);
+        n._empurrar(anterior);
+    }
+
+    Processo &entrando = m_processos[proximo];
+    uint64_t espera = agoraNs > entrando.enfileiradoNs ? agoraNs - entrando.enfileiradoNs : 0;
+    if (espera > entrando.estatisticas.esperaMaximaNs)
+        entrando.estatisticas.esperaMaximaNs = espera;
+    if (entrando.ultimoNucleo != -1 && entrando.ultimoNucleo != k)
+        entrando.estatisticas.migracoes++;
+    entrando.ultimoNucleo = k;
+    entrando.estatisticas.fatias++;
+
+    n.m_atual = proximo;
+    n.m_quantumRestante = _quantumDe(proximo);
+    n.estatisticas.trocas++;
+
+    SIM_LOG(LOG_DEBUG, "ESCALONADOR SMP", "Núcleo {}: troca de contexto para o PID {}.", k, proximo);
+}
+
+int EscalonadorSMP::_roubar(int k)
+{
+    // Vítimas em ordem, a partir do vizinho; um mutex por vez (sem deadlock)
+    const int total = numNucleos();
+    for (int d = 1; d < total; d++)
+    {
+        Nucleo &vitima = *m_nucleos[(k + d) % total];
+        int pid;
+        {
+            std::lock_guard<std::mutex> lock(vitima.m_mutex);
+            pid = vitima._retirarFim();
+        }
+        if (pid != -1)
+        {
+            m_nucleos[k]->estatisticas.roubos++;
+            SIM_LOG(LOG_DEBUG, "ESCALONADOR SMP", "Núcleo {} roubou o PID {} do núcleo {}.", k, pid, (k + d) % total);
+            return pid;
+        }
+    }
+    return -1;
+}
+
+uint32_t EscalonadorSMP::_quantumDe(int pid) const
+{
+    return m_politica == Escalonador::Politica::Ponderado ? m_quantumBase * m_processos[pid].peso : m_quantumBase;
+}
+
+uint64_t EscalonadorSMP::_agoraNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+double EscalonadorSMP::indiceJustica() const
+{
+    if (m_processos.empty())
+        return 1.0;
+
+    double soma = 0.0, somaQuadrados = 0.0;
+    for (const Processo &p : m_processos)
+    {
+        double peso = m_politica == Escalonador::Politica::Ponderado ? (double)p.peso : 1.0;
+        double x = (double)p.estatisticas.ticksExecutados / peso;
+        soma += x;
+        somaQuadrados += x * x;
+    }
+    return somaQuadrados > 0.0 ? (soma * soma) / ((double)m_processos.size() * somaQuadrados) : 1.0;
+}
+
+void EscalonadorSMP::relatar(std::ostream &saida) const
+{
+    saida << "[ESCALONADOR SMP] politica=" << (m_politica == Escalonador::Politica::Ponderado ? "ponderado" : "round-robin")
+          << " nucleos=" << m_nucleos.size()
+          << " processos=" << m_processos.size()
+          << " justica=" << std::fixed << std::setprecision(4) << indiceJustica() << std::defaultfloat << "\n";
+
+    for (size_t k = 0; k < m_nucleos.size(); k++)
+    {
+        const EstatisticasNucleo &e = m_nucleos[k]->estatisticas;
+        saida << "[ESCALONADOR SMP] nucleo " << k << ": ticks=" << e.ticks << " ociosos=" << e.ticksOciosos
+              << " trocas=" << e.trocas << " roubos=" << e.roubos << "\n";
+    }
+
+    saida << "[ESCALONADOR SMP] " << std::left << std::setw(5) << "PID" << std::setw(16) << "nome" << std::right
+          << std::setw(6) << "peso" << std::setw(10) << "ticks" << std::setw(8) << "fatias"
+          << std::setw(8) << "preemp" << std::setw(8) << "migr" << std::setw(12) << "cpu(ms)"
+          << std::setw(16) << "espera max(ms)" << "\n";
+    for (size_t pid = 0; pid < m_processos.size(); pid++)
+    {
+        const Processo &p = m_processos[pid];
+        saida << "[ESCALONADOR SMP] " << std::left << std::setw(5) << pid << std::setw(16) << p.nome << std::right
+              << std::setw(6) << p.peso
+              << std::setw(10) << p.estatisticas.ticksExecutados
+              << std::setw(8) << p.estatisticas.fatias
+              << std::setw(8) << p.estatisticas.preempcoes
+              << std::setw(8) << p.estatisticas.migracoes
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << p.estatisticas.tempoCpuNs / 1e6
+              << std::setw(16) << p.estatisticas.esperaMaximaNs / 1e6 << std::defaultfloat << "\n";
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef ESCALONADOR_SMP_H
+#define ESCALONADOR_SMP_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Escalonador.h"
+#include "../interface/IProcesso.h"
+
+/**
+ * @class EscalonadorSMP
+ * @brief O kernel multiprocessado: uma fila de prontos por núcleo.
+ *
+ * Cada núcleo roda a sua "visão" do kernel (nucleo(k), uma IAplicacao)
+ * e só mexe na própria fila no caso comum. Quando a fila de um núcleo
+ * esvazia, ele rouba um processo do fim da fila de outro núcleo
+ * (work stealing). Um processo em execução não está em fila nenhuma,
+ * então nunca roda em dois núcleos ao mesmo tempo.
+ *
+ * Os processos devem ser carregados antes de os núcleos começarem.
+ */
+class EscalonadorSMP
+{
+public:
+    struct EstatisticasProcesso
+    {
+        uint64_t ticksExecutados = 0;
+        uint64_t fatias = 0;
+        uint64_t preempcoes = 0;
+        uint64_t migracoes = 0;        // Vezes que voltou a rodar em outro núcleo
+        uint64_t tempoCpuNs = 0;
+        uint64_t esperaMaximaNs = 0;   // Maior tempo numa fila de prontos
+    };
+
+    struct EstatisticasNucleo
+    {
+        uint64_t ticks = 0;        // Ticks entregues a processos
+        uint64_t ticksOciosos = 0; // Ticks sem nada para rodar
+        uint64_t trocas = 0;
+        uint64_t roubos = 0;       // Processos roubados de outros núcleos
+    };
+
+    EscalonadorSMP(int numNucleos, Escalonador::Politica politica = Escalonador::Politica::RoundRobin,
+                   uint32_t quantumBase = 1);
+
+    /**
+     * @param nucleo Fila inicial (-1 = distribui em rodízio pelo PID).
+     * @return O PID do processo.
+     */
+    int adicionarProcesso(IAplicacao *app, const std::string &nome, uint32_t peso = 1, int nucleo = -1);
+
+    /**
+     * @brief O que a CPU 'k' deve carregar (carregarAplicacao).
+     */
+    IAplicacao *nucleo(int k) { return m_nucleos[k].get(); }
+
+    /**
+     * @brief Chamado pelo ISR do timer local do núcleo 'k'.
+     */
+    void interrupcaoTimer(int k);
+
+    int numNucleos() const { return (int)m_nucleos.size(); }
+    size_t numProcessos() const { return m_processos.size(); }
+    const EstatisticasProcesso &estatisticas(int pid) const { return m_processos[pid].estatisticas; }
+    const EstatisticasNucleo &estatisticasNucleo(int k) const { return m_nucleos[k]->estatisticas; }
+
+    /**
+     * @brief Índice de justiça de Jain sobre os ticks por unidade de peso.
+     * (Leia com os núcleos parados)
+     */
+    double indiceJustica() const;
+
+    void relatar(std::ostream &saida) const;
+
+private:
+    struct Processo
+    {
+        IAplicacao *app;
+        std::string nome;
+        uint32_t peso;
+        int ultimoNucleo;      // -1 = ainda não rodou
+        uint64_t enfileiradoNs; // Quando entrou na fila de prontos
+        EstatisticasProcesso estatisticas;
+    };
+
+    /**
+     * @brief A parte do kernel de um núcleo: fila de prontos (anel de
+     * PIDs, protegido por mutex) e o processo atual (só do núcleo).
+     */
+    class Nucleo : public IAplicacao
+    {
+    public:
+        Nucleo(EscalonadorSMP &kernel, int indice) : m_kernel(kernel), m_indice(indice) {}
+
+        void conectar(BufferDeEntradaOS *, IFrameBuffer *) override {}
+        void executarTick() override { m_kernel._executarTick(m_indice); }
+        bool temTrabalho() const override { return m_kernel._temTrabalho(m_indice); }
+
+        EstatisticasNucleo estatisticas;
+
+    private:
+        friend class EscalonadorSMP;
+
+        EscalonadorSMP &m_kernel;
+        int m_indice;
+
+        // --- Fila de prontos (qualquer núcleo pode roubar daqui) ---
+        alignas(64) mutable std::mutex m_mutex;
+        std::vector<int> m_anel; // Capacidade = total de processos
+        size_t m_inicio = 0;
+        size_t m_quantidade = 0;
+
+        // --- Só o próprio núcleo mexe ---
+        alignas(64) int m_atual = -1;
+        uint32_t m_quantumRestante = 0;
+        bool m_trocaPendente = false;
+
+        void _empurrar(int pid);   // No fim (com o mutex)
+        int _retirarInicio();      // Próximo da vez (com o mutex)
+        int _retirarFim();         // Para roubo (com o mutex)
+    };
+
+    Escalonador::Politica m_politica;
+    uint32_t m_quantumBase;
+    std::vector<Processo> m_processos;
+    std::vector<std::unique_ptr<Nucleo>> m_nucleos;
+
+    void _executarTick(int k);
+    bool _temTrabalho(int k) const;
+    void _trocarContexto(int k, uint64_t agoraNs);
+    int _roubar(int k);
+    uint32_t _quantumDe(int pid) const;
+    static uint64_t _agoraNs();
+};
+
+#endif // ESCALONADOR_SMP_H
@@ -1,7 +1,12 @@
 #include <iostream>
 #include <fstream>
+#include <string>
 #include <unistd.h>    // Para read(), STDIN_FILENO, tcsetattr, tcgetattr
 #include <termios.h>   // Para a mágica do terminal (modo raw)
+#include <thread>      // Para sleep_for
+#include <chrono>
+
+#include "./ipc/CanalEntradaShm.h"
 
 /**
  * @struct RawMode
@@ -34,36 +39,63 @@ struct RawMode {
     }
 };
 
-int main() {
-    // 1. Ativa o modo raw.
+/**
+ * @brief Modo "arquivo" (legado): escreve a tecla no sim_input.txt,
+ * que o simulador lê a cada tick.
+ */
+static void enviarPorArquivo(char c) {
+    // Abre o arquivo, apagando o conteúdo anterior (trunc)
+    std::ofstream out("sim_input.txt", std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Erro: Não foi possível abrir sim_input.txt" << std::endl;
+        return;
+    }
+    out << c; // Escreve o único caractere
+    out.close();
+}
+
+int main(int argc, char* argv[]) {
+    // --entrada=arquivo : usa o sim_input.txt (modo legado) em vez do canal shm
+    bool entradaPorArquivo = (argc > 1 && std::string(argv[1]) == "--entrada=arquivo");
+
+    // 1. Conecta ao canal criado pelo simulador (aguarda ele subir)
+    CanalEntradaShm* canal = nullptr;
+    while (!entradaPorArquivo) {
+        canal = new CanalEntradaShm("sim_input.shm", false);
+        if (canal->valido()) break;
+        delete canal;
+        canal = nullptr;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    // 2. Ativa o modo raw.
     // O destrutor será chamado automaticamente no fim do 'main'.
     RawMode raw; 
 
-    std::cout << "Ouvindo teclas... Pressione '.' (ponto) para sair." << std::endl;
+    std::cout << "Ouvindo teclas (" << (entradaPorArquivo ? "arquivo" : "shm")
+              << ")... Pressione '.' (ponto) para sair." << std::endl;
 
     char c = 0;
-    // 2. Loop principal: lê 1 byte (um char) do STDIN
+    // 3. Loop principal: lê 1 byte (um char) do STDIN
     while (read(STDIN_FILENO, &c, 1) == 1) {
         
-        // 3. Condição de saída
+        // 4. Condição de saída
         if (c == '.') {
             std::cout << "Saindo..." << std::endl;
             break;
         }
 
-        // 4. Abre o arquivo, apagando o conteúdo anterior (trunc)
-        std::ofstream out("sim_input.txt", std::ios::trunc);
-        if (!out.is_open()) {
-            std::cerr << "Erro: Não foi possível abrir sim_input.txt" << std::endl;
-            continue; 
+        // 5. Envia a tecla (o canal registra o timestamp e acorda o simulador)
+        if (canal != nullptr) {
+            canal->publicar(c);
+        } else {
+            enviarPorArquivo(c);
         }
-        
-        out << c; // 5. Escreve o único caractere
-        out.close();
 
         // Feedback visual no console (opcional)
         std::cout << "-> '" << c << "' enviado." << std::endl;
     }
 
+    delete canal;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,262 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// --- DEPENDÊNCIAS POSIX ---
+#include <fcntl.h>  // open
+#include <unistd.h> // write, close
+// --------------------------
+
+namespace
+{
+    const size_t CAPACIDADE_ANEL = 8192; // Registros por thread (potência de 2)
+    const size_t LINHA_CACHE = 64;
+
+    /**
+     * @brief Anel SPSC de uma thread: ela produz, a drenagem consome.
+     */
+    struct AnelLog
+    {
+        alignas(LINHA_CACHE) std::atomic<size_t> cauda{0};  // Só a thread dona escreve
+        std::atomic<uint64_t> perdidos{0};
+        std::atomic<bool> aposentado{false}; // A thread dona terminou
+        alignas(LINHA_CACHE) std::atomic<size_t> cabeca{0}; // Só a drenagem escreve
+        RegistroLog registros[CAPACIDADE_ANEL];
+    };
+
+    // --- Estado global (protegido por g_mutex, exceto os anéis em si) ---
+    std::mutex g_mutex;
+    std::condition_variable g_cv;
+    std::vector<AnelLog *> g_aneis;
+    std::thread g_threadDrenagem;
+    bool g_encerrar = false;
+    int g_fd = -1;
+
+    thread_local AnelLog *t_anel = nullptr;
+
+    /**
+     * @brief Amarra o anel à vida da thread: ao sair, ela só marca o anel
+     * como aposentado; a drenagem grava o que sobrou e o libera.
+     */
+    struct DonoDoAnel
+    {
+        AnelLog *anel = nullptr;
+
+        ~DonoDoAnel()
+        {
+            if (anel != nullptr)
+                anel->aposentado.store(true, std::memory_order_release);
+            t_anel = nullptr;
+        }
+    };
+
+    AnelLog *_anelDaThread()
+    {
+        if (t_anel == nullptr)
+        {
+            // Primeira vez desta thread: cria e registra o anel (uma única alocação)
+            static thread_local DonoDoAnel t_dono;
+            AnelLog *anel = new AnelLog();
+            {
+                std::lock_guard<std::mutex> lock(g_mutex);
+                g_aneis.push_back(anel);
+            }
+            t_dono.anel = anel;
+            t_anel = anel;
+        }
+        return t_anel;
+    }
+
+    // --- Serialização para o arquivo ---
+
+    template <typename T>
+    void _escrever(std::vector<char> &saida, T valor)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&valor);
+        saida.insert(saida.end(), bytes, bytes + sizeof(T));
+    }
+
+    void _escreverTexto(std::vector<char> &saida, const char *texto)
+    {
+        uint16_t tamanho = (uint16_t)strlen(texto);
+        _escrever(saida, tamanho);
+        saida.insert(saida.end(), texto, texto + tamanho);
+    }
+
+    void _gravarTudo(const std::vector<char> &saida)
+    {
+        size_t escrito = 0;
+        while (escrito < saida.size())
+        {
+            ssize_t n = write(g_fd, saida.data() + escrito, saida.size() - escrito);
+            if (n <= 0)
+                return;
+            escrito += (size_t)n;
+        }
+    }
+
+    /**
+     * @brief Uma passada de drenagem: recolhe todos os anéis, ordena
+     * por tempo e grava tudo com um único write().
+     */
+    void _drenar(std::vector<RegistroLog> &lote, std::vector<char> &saida,
+                 std::unordered_set<const DescritorLog *> &conhecidos)
+    {
+        lote.clear();
+        saida.clear();
+        uint64_t perdidos = 0;
+
+        std::vector<AnelLog *> aneis;
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            aneis = g_aneis;
+        }
+
+        std::vector<AnelLog *> aposentados;
+        for (AnelLog *anel : aneis)
+        {
+            // Lido antes da cauda: aposentado, a cauda já é a última
+            const bool aposentado = anel->aposentado.load(std::memory_order_acquire);
+            size_t cabeca = anel->cabeca.load(std::memory_order_relaxed);
+            size_t cauda = anel->cauda.load(std::memory_order_acquire);
+            for (; cabeca != cauda; cabeca++)
+                lote.push_back(anel->registros[cabeca & (CAPACIDADE_ANEL - 1)]);
+            anel->cabeca.store(cabeca, std::memory_order_release);
+            perdidos += anel->perdidos.exchange(0, std::memory_order_relaxed);
+            if (aposentado)
+                aposentados.push_back(anel);
+        }
+
+        if (!aposentados.empty())
+        {
+            // Threads que já terminaram (pool de render, núcleos SMP...): anel vazio, liberado
+            std::lock_guard<std::mutex> lock(g_mutex);
+            for (AnelLog *anel : aposentados)
+            {
+                g_aneis.erase(std::find(g_aneis.begin(), g_aneis.end(), anel));
+                delete anel;
+            }
+        }
+
+        std::stable_sort(lote.begin(), lote.end(), [](const RegistroLog &a, const RegistroLog &b)
+                         { return a.timestampNs < b.timestampNs; });
+
+        for (const RegistroLog &registro : lote)
+        {
+            // Na primeira vez que um descritor aparece, grava o seu texto
+            if (conhecidos.insert(registro.descritor).second)
+            {
+                _escrever(saida, (uint8_t)ENTRADA_DEFINICAO);
+                _escrever(saida, (uint64_t)(uintptr_t)registro.descritor);
+                _escrever(saida, (uint8_t)registro.descritor->nivel);
+                _escreverTexto(saida, registro.descritor->componente);
+                _escreverTexto(saida, registro.descritor->formato);
+            }
+            _escrever(saida, (uint8_t)ENTRADA_REGISTRO);
+            _escrever(saida, registro.timestampNs);
+            _escrever(saida, (uint64_t)(uintptr_t)registro.descritor);
+            _escrever(saida, (uint8_t)registro.numArgs);
+            for (uint32_t k = 0; k < registro.numArgs; k++)
+                _escrever(saida, registro.args[k]);
+        }
+
+        if (perdidos > 0)
+        {
+            _escrever(saida, (uint8_t)ENTRADA_PERDIDOS);
+            _escrever(saida, perdidos);
+        }
+
+        if (!saida.empty())
+            _gravarTudo(saida);
+    }
+
+    void _loopDrenagem()
+    {
+        std::vector<RegistroLog> lote;
+        std::vector<char> saida;
+        std::unordered_set<const DescritorLog *> conhecidos;
+        lote.reserve(CAPACIDADE_ANEL);
+
+        std::unique_lock<std::mutex> lock(g_mutex);
+        while (!g_encerrar)
+        {
+            // Lotes a cada 10 ms: o caminho quente nunca acorda esta thread
+            g_cv.wait_for(lock, std::chrono::milliseconds(10));
+            lock.unlock();
+            _drenar(lote, saida, conhecidos);
+            lock.lock();
+        }
+        lock.unlock();
+        _drenar(lote, saida, conhecidos); // O que sobrou
+    }
+}
+
+std::atomic<bool> Logger::s_ativo{false};
+
+bool Logger::iniciar(const std::string &caminhoArquivo)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_fd != -1)
+        return true;
+
+    g_fd = open(caminhoArquivo.c_str(), O_CREAT | O_WRONLY | O_TRUNC, (mode_t)0644);
+    if (g_fd == -1)
+        return false;
+
+    std::vector<char> cabecalho(MAGIC_ARQUIVO_LOG, MAGIC_ARQUIVO_LOG + sizeof(MAGIC_ARQUIVO_LOG));
+    _gravarTudo(cabecalho);
+
+    g_encerrar = false;
+    g_threadDrenagem = std::thread(_loopDrenagem);
+    s_ativo.store(true, std::memory_order_release);
+    return true;
+}
+
+void Logger::encerrar()
+{
+    s_ativo.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        if (g_fd == -1)
+            return;
+        g_encerrar = true;
+    }
+    g_cv.notify_one();
+    g_threadDrenagem.join();
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    close(g_fd);
+    g_fd = -1;
+}
+
+RegistroLog *Logger::_reservar()
+{
+    AnelLog *anel = _anelDaThread();
+    size_t cauda = anel->cauda.load(std::memory_order_relaxed);
+    if (cauda - anel->cabeca.load(std::memory_order_acquire) >= CAPACIDADE_ANEL)
+    {
+        anel->perdidos.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &anel->registros[cauda & (CAPACIDADE_ANEL - 1)];
+}
+
+void Logger::_confirmar()
+{
+    AnelLog *anel = t_anel;
+    anel->cauda.store(anel->cauda.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+uint64_t Logger::_agoraNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
@@ -0,0 +1,140 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint64_t
+#include <string>
+#include <type_traits>
+
+/**
+ * Logger binário assíncrono do simulador.
+ *
+ * Cada ponto de log tem um DescritorLog estático (componente, nível e
+ * formato). No caminho quente só se grava um RegistroLog de tamanho
+ * fixo (timestamp + ponteiro do descritor + argumentos inteiros) no
+ * anel SPSC da própria thread: sem locks, sem alocação, sem formatação.
+ *
+ * Uma thread de drenagem junta os anéis em lotes e os grava no arquivo
+ * binário (sim_logs.bin). O texto só é montado offline pelo
+ * 'logdecoder'.
+ *
+ * Placeholders do formato: {} = inteiro decimal, {x} = hexadecimal,
+ * {c} = caractere.
+ */
+
+enum NivelLog : uint8_t
+{
+    LOG_DEBUG = 0,
+    LOG_INFO = 1,
+    LOG_AVISO = 2,
+    LOG_ERRO = 3
+};
+
+// Nível mínimo compilado. Ex: -DSIM_LOG_NIVEL=1 remove todos os LOG_DEBUG do binário.
+#ifndef SIM_LOG_NIVEL
+#define SIM_LOG_NIVEL 0
+#endif
+
+struct DescritorLog
+{
+    const char *componente;
+    const char *formato;
+    NivelLog nivel;
+};
+
+static const size_t MAX_ARGS_LOG = 5;
+
+struct RegistroLog
+{
+    uint64_t timestampNs;
+    const DescritorLog *descritor;
+    uint32_t numArgs;
+    uint32_t reservado;
+    uint64_t args[MAX_ARGS_LOG];
+};
+
+static_assert(sizeof(RegistroLog) == 64, "RegistroLog deve ocupar uma linha de cache");
+
+// --- Formato do arquivo (lido pelo logdecoder) ---
+static const char MAGIC_ARQUIVO_LOG[8] = {'S', 'I', 'M', 'L', 'O', 'G', '1', '\0'};
+
+enum TipoEntradaLog : uint8_t
+{
+    ENTRADA_DEFINICAO = 1, // id(u64) nivel(u8) tamComp(u16) comp tamFmt(u16) fmt
+    ENTRADA_REGISTRO = 2,  // ts(u64) id(u64) numArgs(u8) args(u64 * numArgs)
+    ENTRADA_PERDIDOS = 3   // quantidade(u64) de registros descartados com o anel cheio
+};
+
+class Logger
+{
+public:
+    /**
+     * @brief Abre o arquivo binário e inicia a thread de drenagem.
+     * Antes disso (e depois de encerrar()), os logs são ignorados.
+     */
+    static bool iniciar(const std::string &caminhoArquivo);
+
+    /**
+     * @brief Drena o que falta, para a thread e fecha o arquivo.
+     */
+    static void encerrar();
+
+    static bool ativo() { return s_ativo.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Grava um registro no anel desta thread (caminho quente).
+     */
+    template <typename... Args>
+    static void registrar(const DescritorLog *descritor, Args... args)
+    {
+        static_assert(sizeof...(Args) <= MAX_ARGS_LOG, "Argumentos demais para um registro de log");
+
+        if (!ativo())
+            return;
+
+        RegistroLog *registro = _reservar();
+        if (registro == nullptr)
+            return; // Anel cheio: contado como perdido
+
+        registro->timestampNs = _agoraNs();
+        registro->descritor = descritor;
+        registro->numArgs = sizeof...(Args);
+        size_t k = 0;
+        ((registro->args[k++] = _paraArg(args)), ...);
+        (void)k;
+
+        _confirmar();
+    }
+
+private:
+    static std::atomic<bool> s_ativo;
+
+    static RegistroLog *_reservar();
+    static void _confirmar();
+    static uint64_t _agoraNs();
+
+    template <typename T>
+    static uint64_t _paraArg(T valor)
+    {
+        static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                      "O logger binário só aceita argumentos inteiros");
+        return (uint64_t)(int64_t)valor;
+    }
+};
+
+/**
+ * @brief Ponto de log. O descritor é estático (criado uma vez) e o
+ * 'if constexpr' some com a chamada inteira abaixo de SIM_LOG_NIVEL.
+ */
+#define SIM_LOG(nivel, componente, formato, ...)                                 \
+    do                                                                           \
+    {                                                                            \
+        if constexpr ((nivel) >= SIM_LOG_NIVEL)                                  \
+        {                                                                        \
+            static const DescritorLog _descritorLog = {componente, formato, nivel}; \
+            Logger::registrar(&_descritorLog, ##__VA_ARGS__);                    \
+        }                                                                        \
+    } while (0)
+
+#endif // LOGGER_H
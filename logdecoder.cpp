@@ -0,0 +1,208 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+
+#include "./log/Logger.h" // Formato do arquivo (MAGIC_ARQUIVO_LOG, TipoEntradaLog)
+
+/**
+ * @brief Decodificador offline do sim_logs.bin gerado pelo Logger.
+ *
+ * Uso: ./logdecoder [-f] [sim_logs.bin]
+ *   -f : continua lendo o arquivo conforme ele cresce (como 'tail -f').
+ */
+
+struct Definicao {
+    uint8_t nivel;
+    std::string componente;
+    std::string formato;
+};
+
+static const char* NOMES_NIVEL[] = {"DEBUG", "INFO", "AVISO", "ERRO"};
+
+/**
+ * @brief Leitor sequencial sobre os bytes pendentes.
+ * Se uma entrada estiver incompleta (arquivo ainda crescendo), 'ok' vira false.
+ */
+struct Leitor {
+    const std::vector<char>& dados;
+    size_t pos;
+    bool ok;
+
+    template <typename T>
+    T ler() {
+        T valor{};
+        if (pos + sizeof(T) > dados.size()) {
+            ok = false;
+            return valor;
+        }
+        memcpy(&valor, dados.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return valor;
+    }
+
+    std::string lerTexto() {
+        uint16_t tamanho = ler<uint16_t>();
+        if (!ok || pos + tamanho > dados.size()) {
+            ok = false;
+            return std::string();
+        }
+        std::string texto(dados.data() + pos, tamanho);
+        pos += tamanho;
+        return texto;
+    }
+};
+
+/**
+ * @brief Monta a mensagem trocando {}, {x} e {c} pelos argumentos.
+ */
+static std::string formatar(const std::string& formato, const uint64_t* args, size_t numArgs) {
+    std::string saida;
+    size_t proximo = 0;
+    char tmp[32];
+
+    for (size_t i = 0; i < formato.size(); i++) {
+        if (formato[i] == '{') {
+            size_t fim = formato.find('}', i);
+            if (fim != std::string::npos && fim - i <= 2) {
+                std::string tipo = formato.substr(i + 1, fim - i - 1);
+                if (proximo < numArgs) {
+                    uint64_t v = args[proximo++];
+                    if (tipo == "x") {
+                        snprintf(tmp, sizeof(tmp), "%02llx", (unsigned long long)v);
+                    } else if (tipo == "c") {
+                        snprintf(tmp, sizeof(tmp), "%c", (char)v);
+                    } else {
+                        snprintf(tmp, sizeof(tmp), "%lld", (long long)(int64_t)v);
+                    }
+                    saida += tmp;
+                } else {
+                    saida += "{?}";
+                }
+                i = fim;
+                continue;
+            }
+        }
+        saida += formato[i];
+    }
+    return saida;
+}
+
+int main(int argc, char* argv[]) {
+    bool seguir = false;
+    std::string caminho = "sim_logs.bin";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-f") {
+            seguir = true;
+        } else {
+            caminho = arg;
+        }
+    }
+
+    std::ifstream in;
+    while (true) {
+        in.open(caminho, std::ios::binary);
+        if (in.is_open() || !seguir) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    if (!in.is_open()) {
+        std::cerr << "Erro: Não foi possível abrir " << caminho << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint64_t, Definicao> definicoes;
+    std::vector<char> pendente;
+    bool cabecalhoLido = false;
+    uint64_t inicioNs = 0;
+    char bloco[64 * 1024];
+
+    while (true) {
+        // 1. Lê o que houver de novo no arquivo
+        in.read(bloco, sizeof(bloco));
+        std::streamsize lidos = in.gcount();
+        if (lidos > 0) {
+            pendente.insert(pendente.end(), bloco, bloco + lidos);
+        }
+        if (in.eof()) {
+            in.clear(); // Permite continuar lendo se o arquivo crescer
+        }
+
+        // 2. Confere o cabeçalho do arquivo
+        if (!cabecalhoLido) {
+            if (pendente.size() < sizeof(MAGIC_ARQUIVO_LOG)) {
+                if (!seguir) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            if (memcmp(pendente.data(), MAGIC_ARQUIVO_LOG, sizeof(MAGIC_ARQUIVO_LOG)) != 0) {
+                std::cerr << "Erro: " << caminho << " não é um log do simulador." << std::endl;
+                return 1;
+            }
+            pendente.erase(pendente.begin(), pendente.begin() + sizeof(MAGIC_ARQUIVO_LOG));
+            cabecalhoLido = true;
+        }
+
+        // 3. Decodifica todas as entradas completas
+        Leitor leitor{pendente, 0, true};
+        size_t consumido = 0;
+        while (leitor.ok && leitor.pos < pendente.size()) {
+            uint8_t tipo = leitor.ler<uint8_t>();
+
+            if (tipo == ENTRADA_DEFINICAO) {
+                uint64_t id = leitor.ler<uint64_t>();
+                Definicao def;
+                def.nivel = leitor.ler<uint8_t>();
+                def.componente = leitor.lerTexto();
+                def.formato = leitor.lerTexto();
+                if (!leitor.ok) break;
+                definicoes[id] = def;
+            } else if (tipo == ENTRADA_REGISTRO) {
+                uint64_t ts = leitor.ler<uint64_t>();
+                uint64_t id = leitor.ler<uint64_t>();
+                uint8_t numArgs = leitor.ler<uint8_t>();
+                uint64_t args[MAX_ARGS_LOG] = {};
+                for (uint8_t k = 0; k < numArgs && k < MAX_ARGS_LOG; k++) {
+                    args[k] = leitor.ler<uint64_t>();
+                }
+                if (!leitor.ok) break;
+
+                if (inicioNs == 0) inicioNs = ts;
+                auto it = definicoes.find(id);
+                if (it == definicoes.end()) {
+                    std::cout << "[?] Registro sem definição (id " << id << ")\n";
+                } else {
+                    const Definicao& def = it->second;
+                    char prefixo[64];
+                    snprintf(prefixo, sizeof(prefixo), "%12.6f %-5s ",
+                             (double)(ts - inicioNs) / 1e9, NOMES_NIVEL[def.nivel & 3]);
+                    std::cout << prefixo << "[" << def.componente << "] "
+                              << formatar(def.formato, args, numArgs) << "\n";
+                }
+            } else if (tipo == ENTRADA_PERDIDOS) {
+                uint64_t quantidade = leitor.ler<uint64_t>();
+                if (!leitor.ok) break;
+                std::cout << "*** " << quantidade << " registro(s) de log perdido(s) (anel cheio) ***\n";
+            } else {
+                std::cerr << "Erro: entrada desconhecida (" << (int)tipo << ") no arquivo." << std::endl;
+                return 1;
+            }
+            consumido = leitor.pos;
+        }
+        pendente.erase(pendente.begin(), pendente.begin() + consumido);
+        std::cout.flush();
+
+        if (!seguir && lidos == 0) break;
+        if (seguir && lidos == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+#ifndef FORMATO_METRICAS_SHM_H
+#define FORMATO_METRICAS_SHM_H
+
+#include <atomic>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint32_t, uint64_t
+
+/**
+ * Formato da página de métricas em memória compartilhada (sim_metricas.shm).
+ *
+ * Só contadores e histogramas atômicos, atualizados no lugar (relaxed):
+ * o simulador nunca espera por um leitor, e o leitor (simtop) não usa
+ * locks. Cada campo sozinho é sempre consistente; entre campos, um
+ * leitor pode ver uma atualização pela metade (ex: 'amostras' já
+ * incrementado e 'somaNs' ainda não), o que some na leitura seguinte.
+ *
+ * Taxas (ticks/s, IRQs/s) não são guardadas: o leitor calcula pela
+ * diferença entre duas leituras.
+ */
+
+static const uint32_t MAGIC_METRICAS_SHM = 0x3154454D; // "MET1"
+static const uint32_t VERSAO_METRICAS_SHM = 1;
+static const size_t LINHA_CACHE_METRICAS_SHM = 64;
+
+static const uint32_t MAX_NUCLEOS_METRICAS = 64;  // Núcleos além disso não têm contador próprio
+static const uint32_t NUM_LINHAS_METRICAS = 256;  // Igual ao ControladorPIC::NUM_LINHAS
+static const uint32_t NUM_BALDES_METRICAS = 160;  // 4 baldes por potência de 2, até 2^41 ns
+
+/**
+ * @brief Os histogramas da página (índice em PaginaMetricasShm::histogramas).
+ */
+enum HistogramaMetrica : uint32_t
+{
+    HIST_LATENCIA_ISR = 0, // Da linha subir no PIC até a CPU reconhecer a IRQ
+    HIST_RENDER = 1,       // AppDonut: um frame
+    HIST_PUBLICACAO = 2,   // MmapFrameBuffer: uma publicação no shm
+    HIST_ATRASO_TICK = 3,  // Despertar do tick - prazo da grade (só no modo ritmado)
+    NUM_HISTOGRAMAS_METRICAS = 4
+};
+
+static const char *const NOMES_HISTOGRAMAS_METRICAS[NUM_HISTOGRAMAS_METRICAS] = {
+    "latencia_isr", "render", "publicacao", "atraso_tick"};
+
+/**
+ * @brief Histograma de tempos em ns, com baldes log-lineares: cada
+ * potência de 2 é dividida em 4 (erro de no máximo 25% no percentil).
+ */
+struct HistogramaShm
+{
+    std::atomic<uint64_t> amostras;
+    std::atomic<uint64_t> somaNs;
+    std::atomic<uint64_t> maximoNs;
+    std::atomic<uint64_t> baldes[NUM_BALDES_METRICAS];
+};
+
+/**
+ * @brief Contador com uma linha de cache só para ele (um escritor por
+ * núcleo, sem "false sharing" entre os núcleos).
+ */
+struct alignas(LINHA_CACHE_METRICAS_SHM) ContadorNucleoShm
+{
+    std::atomic<uint64_t> ticks;
+};
+
+struct PaginaMetricasShm
+{
+    uint32_t magic;
+    uint32_t versao;
+    uint32_t pid;           // Do simulador (o leitor confere se ainda está vivo)
+    uint32_t nucleos;       // Núcleos simulados
+    uint64_t periodoAlvoNs; // Período do tick no modo ritmado (0 = headless)
+    uint64_t inicioNs;      // CLOCK_MONOTONIC de quando a página foi criada
+
+    ContadorNucleoShm ticksPorNucleo[MAX_NUCLEOS_METRICAS];
+
+    alignas(LINHA_CACHE_METRICAS_SHM) std::atomic<uint64_t> irqsPorLinha[NUM_LINHAS_METRICAS];
+
+    // --- Entrada (amostrada periodicamente pela thread de input) ---
+    alignas(LINHA_CACHE_METRICAS_SHM) std::atomic<uint64_t> tecladoRetidas; // Teclas no HardwareTeclado agora
+    std::atomic<uint64_t> tecladoEntregues;
+    std::atomic<uint64_t> tecladoDescartadas;
+    std::atomic<uint64_t> entradaOSPendentes; // Teclas no BufferDeEntradaOS agora
+    std::atomic<uint64_t> entradaOSEnfileiradas;
+    std::atomic<uint64_t> entradaOSDescartadas;
+    std::atomic<uint64_t> entradaAmostradaNs; // CLOCK_MONOTONIC da última amostra
+
+    alignas(LINHA_CACHE_METRICAS_SHM) HistogramaShm histogramas[NUM_HISTOGRAMAS_METRICAS];
+};
+
+/**
+ * @brief Balde de um valor: 0..3 exatos; depois, 4 por potência de 2.
+ */
+inline uint32_t baldeMetricaShm(uint64_t ns)
+{
+    if (ns < 4)
+        return (uint32_t)ns;
+    const uint32_t expoente = 63 - (uint32_t)__builtin_clzll(ns); // >= 2
+    const uint32_t sub = (uint32_t)(ns >> (expoente - 2)) & 3;
+    const uint32_t balde = (expoente - 1) * 4 + sub;
+    return balde < NUM_BALDES_METRICAS ? balde : NUM_BALDES_METRICAS - 1;
+}
+
+/**
+ * @brief Menor valor que cai no balde (o maior é o início do próximo - 1).
+ */
+inline uint64_t inicioBaldeMetricaShm(uint32_t balde)
+{
+    if (balde < 4)
+        return balde;
+    const uint32_t expoente = balde / 4 + 1;
+    return (uint64_t)(4 + balde % 4) << (expoente - 2);
+}
+
+/**
+ * @brief Lado do escritor: uma amostra (pode vir de várias threads).
+ */
+inline void registrarHistogramaShm(HistogramaShm &histograma, uint64_t ns)
+{
+    histograma.baldes[baldeMetricaShm(ns)].fetch_add(1, std::memory_order_relaxed);
+    histograma.somaNs.fetch_add(ns, std::memory_order_relaxed);
+    histograma.amostras.fetch_add(1, std::memory_order_relaxed);
+
+    // Máximo: quase sempre uma leitura só (o CAS é raro)
+    uint64_t maximo = histograma.maximoNs.load(std::memory_order_relaxed);
+    while (ns > maximo && !histograma.maximoNs.compare_exchange_weak(maximo, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+/**
+ * @brief Cópia simples de um histograma (lado do leitor), para calcular
+ * percentis de um intervalo pela diferença entre duas cópias.
+ */
+struct CopiaHistogramaMetrica
+{
+    uint64_t amostras = 0;
+    uint64_t somaNs = 0;
+    uint64_t maximoNs = 0;
+    uint64_t baldes[NUM_BALDES_METRICAS] = {};
+
+    void copiar(const HistogramaShm &histograma)
+    {
+        amostras = histograma.amostras.load(std::memory_order_relaxed);
+        somaNs = histograma.somaNs.load(std::memory_order_relaxed);
+        maximoNs = histograma.maximoNs.load(std::memory_order_relaxed);
+        for (uint32_t b = 0; b < NUM_BALDES_METRICAS; b++)
+            baldes[b] = histograma.baldes[b].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Percentil 'p' (0..1) das amostras entre 'anterior' e esta
+     * cópia: o fim do balde onde ele cai (nunca subestima).
+     */
+    uint64_t percentilDesde(const CopiaHistogramaMetrica &anterior, double p) const
+    {
+        uint64_t total = 0;
+        for (uint32_t b = 0; b < NUM_BALDES_METRICAS; b++)
+            total += baldes[b] - anterior.baldes[b];
+        if (total == 0)
+            return 0;
+
+        const uint64_t alvo = (uint64_t)(p * (double)(total - 1)) + 1;
+        uint64_t acumulado = 0;
+        for (uint32_t b = 0; b < NUM_BALDES_METRICAS; b++)
+        {
+            acumulado += baldes[b] - anterior.baldes[b];
+            if (acumulado >= alvo)
+                return b + 1 < NUM_BALDES_METRICAS ? inicioBaldeMetricaShm(b + 1) - 1 : maximoNs;
+        }
+        return maximoNs;
+    }
+};
+
+#endif // FORMATO_METRICAS_SHM_H
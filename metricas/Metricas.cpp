@@ -0,0 +1,82 @@
+#include "Metricas.h"
+#include "../log/Logger.h"
+
+#include <cstring> // Para memset
+
+// --- DEPENDÊNCIAS POSIX ---
+#include <sys/mman.h> // mmap, munmap
+#include <fcntl.h>    // open
+#include <unistd.h>   // close, ftruncate, getpid
+// --------------------------
+
+std::atomic<PaginaMetricasShm *> Metricas::s_pagina{nullptr};
+
+bool Metricas::iniciar(const std::string &caminhoArquivo, uint64_t periodoAlvoNs, uint32_t nucleos)
+{
+    encerrar();
+
+    // Sem O_TRUNC: um simtop que ainda mapeia a página antiga levaria
+    // SIGBUS se o arquivo encolhesse, mesmo que só por um instante
+    int fd = open(caminhoArquivo.c_str(), O_CREAT | O_RDWR, (mode_t)0644);
+    if (fd == -1)
+    {
+        SIM_LOG(LOG_ERRO, "METRICAS", "ERRO: Falha ao criar a página de métricas.");
+        return false;
+    }
+    if (ftruncate(fd, sizeof(PaginaMetricasShm)) == -1)
+    {
+        SIM_LOG(LOG_ERRO, "METRICAS", "ERRO: Falha ao definir o tamanho da página com ftruncate.");
+        close(fd);
+        return false;
+    }
+    void *ptr = mmap(0, sizeof(PaginaMetricasShm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // O mapeamento continua válido
+    if (ptr == MAP_FAILED)
+    {
+        SIM_LOG(LOG_ERRO, "METRICAS", "ERRO: Falha ao mapear a página de métricas.");
+        return false;
+    }
+
+    // Zera tudo com o magic apagado: o leitor vê a página recomeçar
+    PaginaMetricasShm *pagina = static_cast<PaginaMetricasShm *>(ptr);
+    pagina->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    memset(static_cast<void *>(pagina), 0, sizeof(PaginaMetricasShm));
+    pagina->versao = VERSAO_METRICAS_SHM;
+    pagina->pid = (uint32_t)getpid();
+    pagina->nucleos = nucleos;
+    pagina->periodoAlvoNs = periodoAlvoNs;
+    pagina->inicioNs = agoraNs();
+
+    // O magic por último: o leitor só confia numa página completa
+    std::atomic_thread_fence(std::memory_order_release);
+    pagina->magic = MAGIC_METRICAS_SHM;
+
+    s_pagina.store(pagina, std::memory_order_release);
+    SIM_LOG(LOG_INFO, "METRICAS", "Página de métricas criada ({} bytes).", sizeof(PaginaMetricasShm));
+    return true;
+}
+
+void Metricas::encerrar()
+{
+    PaginaMetricasShm *pagina = s_pagina.exchange(nullptr, std::memory_order_acq_rel);
+    if (pagina != nullptr)
+    {
+        // O arquivo fica: o simtop mostra os últimos valores
+        munmap(pagina, sizeof(PaginaMetricasShm));
+    }
+}
+
+void Metricas::publicarEntrada(const AmostraEntrada &amostra)
+{
+    PaginaMetricasShm *pagina = s_pagina.load(std::memory_order_relaxed);
+    if (pagina == nullptr)
+        return;
+    pagina->tecladoRetidas.store(amostra.tecladoRetidas, std::memory_order_relaxed);
+    pagina->tecladoEntregues.store(amostra.tecladoEntregues, std::memory_order_relaxed);
+    pagina->tecladoDescartadas.store(amostra.tecladoDescartadas, std::memory_order_relaxed);
+    pagina->entradaOSPendentes.store(amostra.entradaOSPendentes, std::memory_order_relaxed);
+    pagina->entradaOSEnfileiradas.store(amostra.entradaOSEnfileiradas, std::memory_order_relaxed);
+    pagina->entradaOSDescartadas.store(amostra.entradaOSDescartadas, std::memory_order_relaxed);
+    pagina->entradaAmostradaNs.store(agoraNs(), std::memory_order_relaxed);
+}
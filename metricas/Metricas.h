@@ -0,0 +1,121 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <atomic>
+#include <cstdint> // Para uint32_t, uint64_t
+#include <ctime>   // clock_gettime, timespec
+#include <string>
+
+#include "FormatoMetricasShm.h"
+
+/**
+ * Métricas ao vivo do simulador, numa página em memória compartilhada
+ * (sim_metricas.shm) que o 'simtop' lê sem locks.
+ *
+ * Cada atualização é um store ou um fetch_add relaxed no próprio campo:
+ * sem formatação, sem syscalls e sem fila. Com a página desligada (ou
+ * antes de iniciar()), cada ponto custa uma leitura atômica.
+ */
+
+/**
+ * @brief Os contadores de entrada, amostrados de tempos em tempos.
+ */
+struct AmostraEntrada
+{
+    uint64_t tecladoRetidas = 0;
+    uint64_t tecladoEntregues = 0;
+    uint64_t tecladoDescartadas = 0;
+    uint64_t entradaOSPendentes = 0;
+    uint64_t entradaOSEnfileiradas = 0;
+    uint64_t entradaOSDescartadas = 0;
+};
+
+class Metricas
+{
+public:
+    /**
+     * @brief Cria (ou recria) e mapeia a página.
+     * @param periodoAlvoNs Período do tick no modo ritmado (0 = headless).
+     */
+    static bool iniciar(const std::string &caminhoArquivo, uint64_t periodoAlvoNs, uint32_t nucleos);
+
+    /**
+     * @brief Desliga as métricas e desmapeia a página. Chame depois de
+     * parar as threads que as atualizam.
+     */
+    static void encerrar();
+
+    static bool ativo() { return s_pagina.load(std::memory_order_relaxed) != nullptr; }
+
+    static uint64_t agoraNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+
+    /**
+     * @brief Total de ticks do núcleo (só a thread do núcleo escreve).
+     */
+    static void publicarTicks(uint32_t nucleo, uint64_t ticks)
+    {
+        PaginaMetricasShm *pagina = s_pagina.load(std::memory_order_relaxed);
+        if (pagina != nullptr && nucleo < MAX_NUCLEOS_METRICAS)
+            pagina->ticksPorNucleo[nucleo].ticks.store(ticks, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief A CPU reconheceu uma IRQ da 'linha'.
+     * @param latenciaNs Desde a linha subir (0 = desconhecida, não entra no histograma).
+     */
+    static void registrarIRQ(int linha, uint64_t latenciaNs)
+    {
+        PaginaMetricasShm *pagina = s_pagina.load(std::memory_order_relaxed);
+        if (pagina == nullptr || linha < 0 || (uint32_t)linha >= NUM_LINHAS_METRICAS)
+            return;
+        pagina->irqsPorLinha[linha].fetch_add(1, std::memory_order_relaxed);
+        if (latenciaNs != 0)
+            registrarHistogramaShm(pagina->histogramas[HIST_LATENCIA_ISR], latenciaNs);
+    }
+
+    static void registrar(HistogramaMetrica histograma, uint64_t ns)
+    {
+        PaginaMetricasShm *pagina = s_pagina.load(std::memory_order_relaxed);
+        if (pagina != nullptr)
+            registrarHistogramaShm(pagina->histogramas[histograma], ns);
+    }
+
+    static void publicarEntrada(const AmostraEntrada &amostra);
+
+private:
+    static std::atomic<PaginaMetricasShm *> s_pagina;
+};
+
+/**
+ * @class CronometroMetrica
+ * @brief Mede do construtor ao destrutor e registra no histograma
+ * (só se as métricas estavam ligadas na entrada).
+ */
+class CronometroMetrica
+{
+public:
+    explicit CronometroMetrica(HistogramaMetrica histograma)
+        : m_histograma(histograma), m_inicioNs(Metricas::ativo() ? Metricas::agoraNs() : 0)
+    {
+    }
+
+    ~CronometroMetrica()
+    {
+        if (m_inicioNs != 0)
+            Metricas::registrar(m_histograma, Metricas::agoraNs() - m_inicioNs);
+    }
+
+    CronometroMetrica(const CronometroMetrica &) = delete;
+    CronometroMetrica &operator=(const CronometroMetrica &) = delete;
+
+private:
+    HistogramaMetrica m_histograma;
+    uint64_t m_inicioNs; // 0: métricas desligadas na entrada
+};
+
+#endif // METRICAS_H
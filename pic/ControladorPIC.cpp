@@ -1,42 +1,214 @@
 #include "ControladorPIC.h"
-#include <string> // Para std::to_string
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+
+#include <climits>        // INT_MAX
+#include <ctime>          // clock_gettime, timespec
+#include <unistd.h>       // syscall
+#include <sys/syscall.h>  // SYS_futex
+#include <linux/futex.h>  // FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+
+static inline uint64_t _agoraNs()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
 
 ControladorPIC::ControladorPIC()
 {
-    _log("Controlador PIC inicializado.");
+    for (int w = 0; w < NUM_PALAVRAS; w++)
+    {
+        m_irr[w].store(0, std::memory_order_relaxed);
+        m_nivel[w].store(0, std::memory_order_relaxed);
+        m_imr[w].store(0, std::memory_order_relaxed);
+        m_isr[w] = 0;
+        m_borda[w] = 0;
+    }
+    for (int linha = 0; linha < NUM_LINHAS; linha++)
+    {
+        m_canaisIRQ[linha] = nullptr;
+        m_pendenteDesdeNs[linha].store(0, std::memory_order_relaxed);
+    }
+    SIM_LOG(LOG_INFO, "PIC", "Controlador PIC inicializado.");
 }
 
-void ControladorPIC::registrarDispositivo(int linha, IDispositivoIRQ *dispositivo)
+void ControladorPIC::registrarDispositivo(int linha, IDispositivoIRQ *dispositivo, TipoDisparo tipo)
 {
-    if (dispositivo != nullptr)
+    if (dispositivo != nullptr && linha >= 0 && linha < NUM_LINHAS)
     {
         m_canaisIRQ[linha] = dispositivo;
-        _log("Dispositivo registrado no canal IRQ " + std::to_string(linha) + ".");
+        configurarDisparo(linha, tipo);
+
+        // "Solda o fio": daqui em diante o dispositivo avisa as mudanças
+        dispositivo->conectarIRQ(this, linha);
+        if (dispositivo->estaSinalIRQAtivo())
+        {
+            elevarLinha(linha);
+        }
+        if (tipo == TipoDisparo::Borda)
+            SIM_LOG(LOG_INFO, "PIC", "Dispositivo registrado no canal IRQ {} (disparo por borda).", linha);
+        else
+            SIM_LOG(LOG_INFO, "PIC", "Dispositivo registrado no canal IRQ {} (disparo por nível).", linha);
+    }
+}
+
+void ControladorPIC::configurarDisparo(int linha, TipoDisparo tipo)
+{
+    if (linha < 0 || linha >= NUM_LINHAS)
+        return;
+    if (tipo == TipoDisparo::Borda)
+        m_borda[_palavra(linha)] |= _bit(linha);
+    else
+        m_borda[_palavra(linha)] &= ~_bit(linha);
+}
+
+void ControladorPIC::elevarLinha(int linha)
+{
+    if (linha < 0 || linha >= NUM_LINHAS)
+        return;
+    const int w = _palavra(linha);
+    const uint64_t bit = _bit(linha);
+    uint64_t anterior = m_nivel[w].fetch_or(bit, std::memory_order_acq_rel);
+
+    // Nível: pendente enquanto alto. Borda: só a subida (0 -> 1) conta.
+    if (!(m_borda[w] & bit) || !(anterior & bit))
+    {
+        // seq_cst: pareado com o m_cpuDormindo do HLT (nenhum wake se perde)
+        uint64_t pendentes = m_irr[w].fetch_or(bit, std::memory_order_seq_cst);
+        if (!(pendentes & bit) && Metricas::ativo())
+        {
+            m_pendenteDesdeNs[linha].store(Metricas::agoraNs(), std::memory_order_relaxed);
+        }
+        if (m_cpuDormindo.load(std::memory_order_seq_cst))
+        {
+            _acordarCPU();
+        }
     }
 }
 
-int ControladorPIC::verificarInterrupcoes()
+void ControladorPIC::abaixarLinha(int linha)
 {
-    // Itera por todos os canais registrados
-    // (Um PIC real prioriza, mas vamos apenas pegar o primeiro que virmos)
-    for (const auto &par : m_canaisIRQ)
+    if (linha < 0 || linha >= NUM_LINHAS)
+        return;
+    const int w = _palavra(linha);
+    const uint64_t bit = _bit(linha);
+    m_nivel[w].fetch_and(~bit, std::memory_order_acq_rel);
+
+    // Nível: a requisição some com o sinal. Borda: continua latched até o reconhecimento.
+    if (!(m_borda[w] & bit))
     {
-        int linha = par.first;
-        IDispositivoIRQ *dispositivo = par.second;
+        m_irr[w].fetch_and(~bit, std::memory_order_release);
+    }
+}
 
-        // Pergunta ao dispositivo (sem saber o que ele é): "Sinal ativo?"
-        if (dispositivo != nullptr && dispositivo->estaSinalIRQAtivo())
+int ControladorPIC::_reconhecerInterrupcao()
+{
+    // 1. Prioridade em serviço: nada de prioridade igual ou menor
+    // (número maior ou igual) interrompe um ISR que ainda não deu EOI.
+    int emServico = NUM_LINHAS;
+    for (int w = 0; w < NUM_PALAVRAS; w++)
+    {
+        if (m_isr[w] != 0)
         {
-            _log("IRQ " + std::to_string(linha) + " ATIVA! Sinalizando CPU...");
-            return linha; // Retorna a linha que precisa de atenção
+            emServico = w * 64 + __builtin_ctzll(m_isr[w]);
+            break;
         }
     }
 
+    // 2. Linha pendente e não mascarada de maior prioridade
+    for (int w = 0; w < NUM_PALAVRAS && w * 64 < emServico; w++)
+    {
+        uint64_t candidatas = m_irr[w].load(std::memory_order_acquire) & ~m_imr[w].load(std::memory_order_relaxed);
+        if (candidatas == 0)
+            continue;
+
+        int linha = w * 64 + __builtin_ctzll(candidatas);
+        if (linha >= emServico)
+            break;
+
+        // 3. Reconhece: vai para "em serviço"; borda consome a requisição
+        const uint64_t bit = _bit(linha);
+        m_isr[w] |= bit;
+        if (m_borda[w] & bit)
+        {
+            m_irr[w].fetch_and(~bit, std::memory_order_acq_rel);
+        }
+
+        if (Metricas::ativo())
+        {
+            // Latência da IRQ: da linha ficar pendente até este reconhecimento
+            uint64_t desde = m_pendenteDesdeNs[linha].exchange(0, std::memory_order_relaxed);
+            Metricas::registrarIRQ(linha, desde != 0 ? Metricas::agoraNs() - desde : 0);
+        }
+
+        SIM_LOG(LOG_DEBUG, "PIC", "IRQ {} ATIVA! Sinalizando CPU...", linha);
+        return linha;
+    }
+
     // Nenhum canal ativo
     return -1;
 }
 
-void ControladorPIC::_log(const std::string &mensagem)
+void ControladorPIC::mascararLinha(int linha)
 {
-    std::cout << "[PIC] " << mensagem << std::endl;
+    if (linha >= 0 && linha < NUM_LINHAS)
+    {
+        m_imr[_palavra(linha)].fetch_or(_bit(linha), std::memory_order_relaxed);
+    }
+}
+
+void ControladorPIC::desmascararLinha(int linha)
+{
+    if (linha >= 0 && linha < NUM_LINHAS)
+    {
+        m_imr[_palavra(linha)].fetch_and(~_bit(linha), std::memory_order_seq_cst);
+        if (m_cpuDormindo.load(std::memory_order_seq_cst))
+        {
+            _acordarCPU();
+        }
+    }
+}
+
+bool ControladorPIC::_temPendente() const
+{
+    for (int w = 0; w < NUM_PALAVRAS; w++)
+    {
+        if (m_irr[w].load(std::memory_order_seq_cst) & ~m_imr[w].load(std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void ControladorPIC::_acordarCPU()
+{
+    m_instanteSinalNs.store(_agoraNs(), std::memory_order_relaxed);
+    m_sinalIRQ.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_sinalIRQ), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+bool ControladorPIC::aguardarInterrupcao(unsigned timeoutMs)
+{
+    uint32_t sinal = m_sinalIRQ.load(std::memory_order_acquire);
+    m_cpuDormindo.store(1, std::memory_order_seq_cst);
+
+    // Reconfere depois de anunciar que vai dormir (evita perder um wake)
+    if (!_temPendente())
+    {
+        timespec timeout = {(time_t)(timeoutMs / 1000), (long)(timeoutMs % 1000) * 1000000L};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&m_sinalIRQ), FUTEX_WAIT_PRIVATE, sinal, &timeout, nullptr, 0);
+
+        if (m_sinalIRQ.load(std::memory_order_acquire) != sinal)
+        {
+            uint64_t latencia = _agoraNs() - m_instanteSinalNs.load(std::memory_order_relaxed);
+            m_despertar.despertares++;
+            m_despertar.latenciaTotalNs += latencia;
+            if (latencia > m_despertar.latenciaMaximaNs)
+                m_despertar.latenciaMaximaNs = latencia;
+        }
+    }
+
+    m_cpuDormindo.store(0, std::memory_order_relaxed);
+    return _temPendente();
 }
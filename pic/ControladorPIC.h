@@ -1,21 +1,46 @@
 #ifndef CONTROLADOR_PIC_H
 #define CONTROLADOR_PIC_H
 
-#include <map> // Para mapear: Linha IRQ -> Dispositivo
-#include <string>
-#include <iostream>
+#include <atomic>
+#include <cstdint>
 #include "../interface/IDispositivoIRQ.h" // Depende da ABSTRAÇÃO, não do teclado!
 #include "../interface/IControladorIRQ.h"
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+
+/**
+ * @brief Como uma linha vira uma requisição de interrupção.
+ */
+enum class TipoDisparo
+{
+    Nivel, // Pendente enquanto o sinal estiver alto (ex: teclado com dado pronto)
+    Borda  // Pendente a cada subida do sinal, até a CPU reconhecer
+};
+
 /**
  * @class ControladorPIC
- * @brief Simula o Programmable Interrupt Controller (PIC).
- * * Responsabilidade: Monitora "canais" de IRQ ligados a dispositivos
- * (que implementam IDispositivoIRQ) e sinaliza a CPU quando um
- * canal fica ativo.
+ * @brief Simula o Programmable Interrupt Controller (PIC), no estilo 8259/APIC.
+ * * Responsabilidade: Recebe os sinais das linhas de IRQ (os dispositivos
+ * avisam quando o sinal muda) e sinaliza a CPU qual linha atender.
+ *
+ * Cada registrador é um bitmap de NUM_LINHAS bits:
+ *  - IRR (pendentes): linhas pedindo atenção;
+ *  - IMR (máscara): linhas desabilitadas pela CPU;
+ *  - ISR (em serviço): linhas cujo ISR ainda não mandou EOI.
+ * A linha de menor número tem a maior prioridade e é achada com
+ * count-trailing-zeros: verificarInterrupcoes() custa o mesmo com
+ * 1 ou 256 dispositivos.
+ *
+ * 'final', e com o que roda a cada tick (verificarInterrupcoes e
+ * finalizarInterrupcao) aqui no header: numa NucleoCPU<ControladorPIC, ...>
+ * essas chamadas não passam pela vtable e entram inline no tick.
  */
-class ControladorPIC : public IControladorIRQ
+class ControladorPIC final : public IControladorIRQ
 {
 public:
+    static const int NUM_LINHAS = 256;
+
     ControladorPIC();
 
     /**
@@ -25,21 +50,115 @@ public:
      * @param linha O número da linha (ex: 1 para teclado, 12 para mouse)
      * @param dispositivo Um ponteiro para o dispositivo (que deve
      * implementar IDispositivoIRQ).
+     * @param tipo Disparo por nível (padrão) ou por borda.
      */
-    void registrarDispositivo(int linha, IDispositivoIRQ *dispositivo);
+    void registrarDispositivo(int linha, IDispositivoIRQ *dispositivo, TipoDisparo tipo = TipoDisparo::Nivel);
 
     /**
-     * @brief Simula o "clock" do PIC, verificando todos os canais.
-     * @return O número da linha da primeira interrupção ativa,
-     * ou -1 se nenhuma estiver ativa.
+     * @brief Só configura o disparo da linha, sem ligar dispositivo.
+     * (Para quando o fio vem de outro controlador, ex: DistribuidorAPIC)
      */
-    int verificarInterrupcoes();
+    void configurarDisparo(int linha, TipoDisparo tipo);
+
+    /**
+     * @brief Escolhe a linha pendente de maior prioridade, e a marca
+     * como "em serviço" (a CPU deve chamar finalizarInterrupcao depois).
+     * @return O número da linha, ou -1 se nenhuma puder ser atendida.
+     */
+    int verificarInterrupcoes() override;
+
+    // --- Lado dos dispositivos (podem vir de qualquer thread) ---
+    void elevarLinha(int linha) override;
+    void abaixarLinha(int linha) override;
+
+    // --- Lado da CPU ---
+    void finalizarInterrupcao(int linha) override;
+    void mascararLinha(int linha);
+    void desmascararLinha(int linha);
+
+    /**
+     * @brief HLT: dorme num futex até uma linha não mascarada ficar
+     * pendente. Quem eleva a linha só faz a syscall de wake se a CPU
+     * estiver mesmo dormindo.
+     */
+    bool aguardarInterrupcao(unsigned timeoutMs) override;
+
+    /**
+     * @brief Latência entre a linha subir e a CPU acordar do HLT.
+     */
+    struct EstatisticasDespertar
+    {
+        uint64_t despertares = 0;
+        uint64_t latenciaTotalNs = 0;
+        uint64_t latenciaMaximaNs = 0;
+    };
+    const EstatisticasDespertar &estatisticasDespertar() const { return m_despertar; }
 
 private:
-    // Mapeia o canal (int) ao dispositivo (IDispositivoIRQ*)
-    std::map<int, IDispositivoIRQ *> m_canaisIRQ;
+    static const int NUM_PALAVRAS = NUM_LINHAS / 64;
+
+    static int _palavra(int linha) { return linha >> 6; }
+    static uint64_t _bit(int linha) { return 1ull << (linha & 63); }
+
+    std::atomic<uint64_t> m_irr[NUM_PALAVRAS];   // Requisições pendentes
+    std::atomic<uint64_t> m_nivel[NUM_PALAVRAS]; // Estado elétrico atual de cada linha
+    std::atomic<uint64_t> m_imr[NUM_PALAVRAS];   // Máscara de interrupções
+    uint64_t m_isr[NUM_PALAVRAS];                // Em serviço (só a CPU mexe)
+    uint64_t m_borda[NUM_PALAVRAS];              // 1 = disparo por borda (fixo após o registro)
+
+    // Quem está em cada canal (só para a fiação; não é consultado por tick)
+    IDispositivoIRQ *m_canaisIRQ[NUM_LINHAS];
 
-    void _log(const std::string &mensagem);
+    // Quando cada linha ficou pendente (só com as Metricas ligadas; 0 = desconhecido)
+    std::atomic<uint64_t> m_pendenteDesdeNs[NUM_LINHAS];
+
+    // --- HLT ---
+    alignas(64) std::atomic<uint32_t> m_sinalIRQ{0};      // Palavra do futex
+    std::atomic<uint32_t> m_cpuDormindo{0};
+    std::atomic<uint64_t> m_instanteSinalNs{0};          // Quando a CPU foi acordada
+    EstatisticasDespertar m_despertar;                   // Só a CPU mexe
+
+    bool _temPendente() const;
+    void _acordarCPU();
+
+    /**
+     * @brief O resto do verificarInterrupcoes(), com alguma linha
+     * pendente: prioridade, reconhecimento e métricas.
+     */
+    int _reconhecerInterrupcao();
 };
 
-#endif // CONTROLADOR_PIC_H
\ No newline at end of file
+// --- Caminho quente (a cada tick da CPU) ---
+
+inline int ControladorPIC::verificarInterrupcoes()
+{
+    SIM_SPAN("pic", "verificarInterrupcoes");
+
+    // Caminho comum, nenhuma linha pendente e não mascarada: sem sair do tick
+    uint64_t candidatas = 0;
+    for (int w = 0; w < NUM_PALAVRAS; w++)
+    {
+        candidatas |= m_irr[w].load(std::memory_order_acquire) & ~m_imr[w].load(std::memory_order_relaxed);
+    }
+    if (candidatas == 0)
+        return -1;
+    return _reconhecerInterrupcao();
+}
+
+inline void ControladorPIC::finalizarInterrupcao(int linha)
+{
+    if (linha >= 0 && linha < NUM_LINHAS)
+    {
+        const int w = _palavra(linha);
+        const uint64_t bit = _bit(linha);
+        m_isr[w] &= ~bit;
+
+        // Nível ainda alto depois do ISR: a próxima requisição começa agora
+        if (Metricas::ativo() && !(m_borda[w] & bit) && (m_irr[w].load(std::memory_order_relaxed) & bit))
+        {
+            m_pendenteDesdeNs[linha].store(Metricas::agoraNs(), std::memory_order_relaxed);
+        }
+    }
+}
+
+#endif // CONTROLADOR_PIC_H
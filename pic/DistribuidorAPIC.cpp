@@ -0,0 +1,96 @@
+#include "DistribuidorAPIC.h"
+#include "../log/Logger.h"
+
+DistribuidorAPIC::DistribuidorAPIC() : m_numNucleos(0)
+{
+    for (int k = 0; k < MAX_NUCLEOS; k++)
+    {
+        m_nucleos[k] = nullptr;
+        m_entregues[k].store(0, std::memory_order_relaxed);
+    }
+    for (int linha = 0; linha < NUM_LINHAS; linha++)
+    {
+        m_afinidade[linha].store(0, std::memory_order_relaxed);
+        m_modo[linha].store((uint8_t)ModoEntrega::Fixo, std::memory_order_relaxed);
+        m_giro[linha].store(0, std::memory_order_relaxed);
+        m_destino[linha].store(-1, std::memory_order_relaxed);
+    }
+    SIM_LOG(LOG_INFO, "APIC", "Distribuidor de interrupções inicializado.");
+}
+
+int DistribuidorAPIC::conectarNucleo(ControladorPIC *picLocal)
+{
+    if (picLocal == nullptr || m_numNucleos == MAX_NUCLEOS)
+        return -1;
+
+    m_nucleos[m_numNucleos] = picLocal;
+    SIM_LOG(LOG_INFO, "APIC", "Núcleo {} conectado ao distribuidor.", m_numNucleos);
+    return m_numNucleos++;
+}
+
+void DistribuidorAPIC::registrarDispositivo(int linha, IDispositivoIRQ *dispositivo, TipoDisparo tipo)
+{
+    if (dispositivo == nullptr || linha < 0 || linha >= NUM_LINHAS)
+        return;
+
+    // O disparo (nível/borda) é de cada PIC local, que é quem guarda a requisição
+    for (int k = 0; k < m_numNucleos; k++)
+    {
+        m_nucleos[k]->configurarDisparo(linha, tipo);
+    }
+
+    dispositivo->conectarIRQ(this, linha);
+    if (dispositivo->estaSinalIRQAtivo())
+    {
+        elevarLinha(linha);
+    }
+    SIM_LOG(LOG_INFO, "APIC", "Dispositivo registrado no canal IRQ {} ({} núcleos).", linha, m_numNucleos);
+}
+
+void DistribuidorAPIC::definirAfinidade(int linha, uint64_t mascaraNucleos, ModoEntrega modo)
+{
+    if (linha < 0 || linha >= NUM_LINHAS)
+        return;
+
+    m_afinidade[linha].store(mascaraNucleos, std::memory_order_relaxed);
+    m_modo[linha].store((uint8_t)modo, std::memory_order_relaxed);
+    SIM_LOG(LOG_INFO, "APIC", "Afinidade da IRQ {}: máscara 0x{x}.", linha, mascaraNucleos);
+}
+
+int DistribuidorAPIC::_escolherNucleo(int linha)
+{
+    uint64_t existentes = m_numNucleos == MAX_NUCLEOS ? ~0ull : ((1ull << m_numNucleos) - 1);
+    uint64_t candidatos = m_afinidade[linha].load(std::memory_order_relaxed) & existentes;
+    if (candidatos == 0)
+        candidatos = existentes; // Sem afinidade (ou só núcleos inexistentes): qualquer um
+
+    if (m_modo[linha].load(std::memory_order_relaxed) == (uint8_t)ModoEntrega::Fixo)
+        return __builtin_ctzll(candidatos);
+
+    // RoundRobin: o n-ésimo bit ligado da máscara
+    uint32_t vez = m_giro[linha].fetch_add(1, std::memory_order_relaxed) % (uint32_t)__builtin_popcountll(candidatos);
+    for (uint32_t k = 0; k < vez; k++)
+        candidatos &= candidatos - 1; // Apaga o bit mais baixo
+    return __builtin_ctzll(candidatos);
+}
+
+void DistribuidorAPIC::elevarLinha(int linha)
+{
+    if (linha < 0 || linha >= NUM_LINHAS || m_numNucleos == 0)
+        return;
+
+    int nucleo = _escolherNucleo(linha);
+    m_destino[linha].store(nucleo, std::memory_order_relaxed);
+    m_entregues[nucleo].fetch_add(1, std::memory_order_relaxed);
+    m_nucleos[nucleo]->elevarLinha(linha);
+}
+
+void DistribuidorAPIC::abaixarLinha(int linha)
+{
+    if (linha < 0 || linha >= NUM_LINHAS)
+        return;
+
+    int nucleo = m_destino[linha].load(std::memory_order_relaxed);
+    if (nucleo >= 0)
+        m_nucleos[nucleo]->abaixarLinha(linha);
+}
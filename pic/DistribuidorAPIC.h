@@ -0,0 +1,82 @@
+#ifndef DISTRIBUIDOR_APIC_H
+#define DISTRIBUIDOR_APIC_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "ControladorPIC.h"
+#include "../interface/IDispositivoIRQ.h"
+#include "../interface/IControladorIRQ.h"
+
+/**
+ * @class DistribuidorAPIC
+ * @brief Roteador de interrupções entre núcleos, no estilo do I/O APIC.
+ *
+ * Os dispositivos são ligados aqui (e não no PIC de um núcleo). Cada
+ * linha tem uma afinidade (máscara de núcleos) e um modo de entrega:
+ *  - Fixo: sempre o núcleo de menor índice da afinidade;
+ *  - RoundRobin: gira entre os núcleos da afinidade a cada subida.
+ * A subida da linha é repassada ao ControladorPIC local do núcleo
+ * escolhido; a descida vai para o mesmo núcleo que recebeu a subida.
+ *
+ * Pode ser chamado de qualquer thread (os PICs locais são atômicos).
+ */
+class DistribuidorAPIC : public IControladorIRQ
+{
+public:
+    static const int NUM_LINHAS = ControladorPIC::NUM_LINHAS;
+    static const int MAX_NUCLEOS = 64; // Uma máscara de afinidade de 64 bits
+
+    enum class ModoEntrega
+    {
+        Fixo,
+        RoundRobin
+    };
+
+    DistribuidorAPIC();
+
+    /**
+     * @brief Liga o PIC local de mais um núcleo.
+     * @return O índice do núcleo, ou -1 se já há MAX_NUCLEOS.
+     */
+    int conectarNucleo(ControladorPIC *picLocal);
+
+    /**
+     * @brief Liga um dispositivo a uma linha (em todos os PICs locais).
+     * A afinidade padrão é "qualquer núcleo", modo Fixo (núcleo 0).
+     */
+    void registrarDispositivo(int linha, IDispositivoIRQ *dispositivo, TipoDisparo tipo = TipoDisparo::Nivel);
+
+    /**
+     * @brief Define para quais núcleos a linha pode ser entregue.
+     * @param mascaraNucleos Bit k = núcleo k (0 = qualquer núcleo).
+     */
+    void definirAfinidade(int linha, uint64_t mascaraNucleos, ModoEntrega modo = ModoEntrega::Fixo);
+
+    /**
+     * @brief O distribuidor não atende CPU nenhuma: cada núcleo pergunta
+     * ao seu PIC local. Sempre -1.
+     */
+    int verificarInterrupcoes() override { return -1; }
+
+    // --- Lado dos dispositivos ---
+    void elevarLinha(int linha) override;
+    void abaixarLinha(int linha) override;
+
+    int numNucleos() const { return m_numNucleos; }
+    uint64_t totalEntregues(int nucleo) const { return m_entregues[nucleo].load(std::memory_order_relaxed); }
+
+private:
+    ControladorPIC *m_nucleos[MAX_NUCLEOS];
+    int m_numNucleos;
+
+    std::atomic<uint64_t> m_afinidade[NUM_LINHAS];
+    std::atomic<uint8_t> m_modo[NUM_LINHAS];
+    std::atomic<uint32_t> m_giro[NUM_LINHAS];   // Próxima vez do RoundRobin
+    std::atomic<int> m_destino[NUM_LINHAS];     // Núcleo que recebeu a última subida
+    std::atomic<uint64_t> m_entregues[MAX_NUCLEOS];
+
+    int _escolherNucleo(int linha);
+};
+
+#endif // DISTRIBUIDOR_APIC_H
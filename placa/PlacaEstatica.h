@@ -0,0 +1,111 @@
+#ifndef PLACA_ESTATICA_H
+#define PLACA_ESTATICA_H
+
+#include <cstddef> // Para size_t
+#include <tuple>
+#include <type_traits>
+#include <utility> // Para std::index_sequence
+
+#include "../cpu/NucleoCPU.h"
+#include "../pic/ControladorPIC.h" // TipoDisparo
+
+/**
+ * @brief Um dispositivo soldado numa linha fixa do controlador
+ * (a "fiação da placa-mãe", decidida na compilação).
+ */
+template <int Linha, typename Dispositivo, TipoDisparo Disparo = TipoDisparo::Nivel>
+struct NaLinha
+{
+    typedef Dispositivo Tipo;
+    static constexpr int linha = Linha;
+    static constexpr TipoDisparo disparo = Disparo;
+};
+
+/**
+ * @brief O dispositivo é pulsado pelo oscilador da placa (tem eventoClock())?
+ */
+template <typename D, typename = void>
+struct TemRelogio : std::false_type
+{
+};
+template <typename D>
+struct TemRelogio<D, std::void_t<decltype(std::declval<D &>().eventoClock())>> : std::true_type
+{
+};
+
+/**
+ * @class PlacaEstatica
+ * @brief Uma máquina de um núcleo montada em tempo de compilação:
+ * controlador, aplicação e dispositivos (cada um com a sua linha) são
+ * parâmetros de tipo.
+ *
+ *   PlacaEstatica<ControladorPIC, Escalonador,
+ *                 NaLinha<0, TimerPIT, TipoDisparo::Borda>,
+ *                 NaLinha<1, HardwareTeclado>> placa(escalonador, pit, teclado);
+ *
+ * A placa é dona do controlador e da CPU (uma NucleoCPU<Controlador,
+ * Aplicacao>); aplicação e dispositivos são de quem a monta. O tick()
+ * pulsa os dispositivos que têm relógio e roda um tick da CPU, sem
+ * nenhuma chamada virtual no caminho: a CPU chama o controlador e a
+ * aplicação pelos tipos concretos.
+ *
+ * Os dispositivos continuam avisando o controlador pelo IControladorIRQ*
+ * que recebem na fiação: isso só acontece quando um sinal muda, e não
+ * a cada tick. Para fiação escolhida em tempo de execução (SMP, APIC),
+ * a CPU das interfaces continua valendo.
+ */
+template <typename Controlador, typename Aplicacao, typename... Linhas>
+class PlacaEstatica
+{
+public:
+    typedef NucleoCPU<Controlador, Aplicacao> CPUEstatica;
+
+    explicit PlacaEstatica(Aplicacao &aplicacao, typename Linhas::Tipo &...dispositivos)
+        : m_cpu(m_controlador), m_dispositivos(dispositivos...)
+    {
+        _soldar(std::index_sequence_for<Linhas...>{});
+        m_cpu.carregarAplicacao(&aplicacao);
+    }
+
+    PlacaEstatica(const PlacaEstatica &) = delete;
+    PlacaEstatica &operator=(const PlacaEstatica &) = delete;
+
+    Controlador &controlador() { return m_controlador; }
+    CPUEstatica &cpu() { return m_cpu; }
+
+    /**
+     * @brief Um ciclo do oscilador da placa: os dispositivos com relógio
+     * (na ordem das linhas) e depois um tick da CPU.
+     */
+    void tick()
+    {
+        _pulsarRelogios(std::index_sequence_for<Linhas...>{});
+        m_cpu.tick();
+    }
+
+private:
+    Controlador m_controlador; // Antes da CPU: a CPU guarda uma referência
+    CPUEstatica m_cpu;
+    std::tuple<typename Linhas::Tipo &...> m_dispositivos;
+
+    template <size_t... I>
+    void _soldar(std::index_sequence<I...>)
+    {
+        (m_controlador.registrarDispositivo(Linhas::linha, &std::get<I>(m_dispositivos), Linhas::disparo), ...);
+    }
+
+    template <size_t... I>
+    void _pulsarRelogios(std::index_sequence<I...>)
+    {
+        (_pulsar(std::get<I>(m_dispositivos)), ...);
+    }
+
+    template <typename D>
+    static void _pulsar(D &dispositivo)
+    {
+        if constexpr (TemRelogio<D>::value)
+            dispositivo.eventoClock();
+    }
+};
+
+#endif // PLACA_ESTATICA_H
@@ -0,0 +1,212 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <csignal>
+
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h>    // open
+#include <unistd.h>   // write, close
+
+#include "./buffer/FormatoGravacao.h" // Formato do arquivo e o RLE
+
+/**
+ * @brief Reprodutor das gravações do GravadorFrameBuffer (--gravar=ARQUIVO).
+ *
+ * Uso: ./player [--velocidade=X] [--inicio=N] [--info] [sim_gravacao.bin]
+ *   --velocidade=X : 1 = tempo real, 4 = 4x mais rápido, 0 = sem esperar
+ *   --inicio=N     : começa no frame N (salta pelo índice até o keyframe anterior)
+ *   --info         : só mostra o resumo da gravação
+ *
+ * O arquivo é mapeado em memória (mmap): nada é lido além do que é tocado.
+ */
+
+static volatile std::sig_atomic_t g_executando = 1;
+
+static void tratarSinalDeParada(int) {
+    g_executando = 0;
+}
+
+/**
+ * @brief A gravação mapeada, com o índice de keyframes.
+ */
+struct Gravacao {
+    const uint8_t* dados = nullptr;
+    size_t tamanho = 0;
+    const CabecalhoGravacao* cabecalho = nullptr;
+    size_t fimRegistros = 0; // Onde acabam os registros (início do índice, se houver)
+    std::vector<EntradaIndiceGravacao> indice;
+    uint64_t totalFrames = 0;
+    bool indiceDoRodape = false;
+
+    /**
+     * @brief Lê o registro em 'pos'. @return false se não há registro completo ali.
+     */
+    bool lerRegistro(size_t pos, RegistroFrame& registro) const {
+        if (pos + sizeof(RegistroFrame) > fimRegistros) return false;
+        memcpy(&registro, dados + pos, sizeof(RegistroFrame));
+        if (registro.tipo != REGISTRO_KEYFRAME && registro.tipo != REGISTRO_DELTA) return false;
+        return pos + sizeof(RegistroFrame) + registro.tamanhoDados <= fimRegistros;
+    }
+};
+
+static bool abrirGravacao(const std::string& caminho, Gravacao& g) {
+    int fd = open(caminho.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat info;
+    if (fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(CabecalhoGravacao)) {
+        close(fd);
+        return false;
+    }
+    g.tamanho = (size_t)info.st_size;
+    void* ptr = mmap(0, g.tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // O mapeamento continua válido
+    if (ptr == MAP_FAILED) return false;
+
+    g.dados = static_cast<const uint8_t*>(ptr);
+    g.cabecalho = reinterpret_cast<const CabecalhoGravacao*>(g.dados);
+    if (g.cabecalho->magic != MAGIC_GRAVACAO || g.cabecalho->versao != VERSAO_GRAVACAO) {
+        std::cerr << "Erro: " << caminho << " não é uma gravação do simulador (versão " << VERSAO_GRAVACAO << ")." << std::endl;
+        return false;
+    }
+
+    // 1. Índice do rodapé (gravação fechada normalmente)
+    g.fimRegistros = g.tamanho;
+    if (g.tamanho >= sizeof(CabecalhoGravacao) + sizeof(RodapeGravacao)) {
+        RodapeGravacao rodape;
+        memcpy(&rodape, g.dados + g.tamanho - sizeof(RodapeGravacao), sizeof(RodapeGravacao));
+        size_t bytesIndice = rodape.entradasIndice * sizeof(EntradaIndiceGravacao);
+        if (rodape.magic == MAGIC_RODAPE_GRAVACAO &&
+            rodape.deslocamentoIndice + bytesIndice + sizeof(RodapeGravacao) == g.tamanho) {
+            g.indice.resize(rodape.entradasIndice);
+            if (bytesIndice > 0) memcpy(g.indice.data(), g.dados + rodape.deslocamentoIndice, bytesIndice);
+            g.fimRegistros = rodape.deslocamentoIndice;
+            g.totalFrames = rodape.totalFrames;
+            g.indiceDoRodape = true;
+            return true;
+        }
+    }
+
+    // 2. Sem rodapé (gravação interrompida): reconstrói percorrendo os registros
+    size_t pos = sizeof(CabecalhoGravacao);
+    RegistroFrame registro;
+    while (g.lerRegistro(pos, registro)) {
+        if (registro.tipo == REGISTRO_KEYFRAME) {
+            g.indice.push_back({registro.numeroFrame, (uint64_t)pos});
+        }
+        g.totalFrames = registro.numeroFrame + 1;
+        pos += sizeof(RegistroFrame) + registro.tamanhoDados;
+    }
+    g.fimRegistros = pos; // Um registro final incompleto é ignorado
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string caminho = "sim_gravacao.bin";
+    double velocidade = 1.0;
+    uint64_t inicio = 0;
+    bool soInfo = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--velocidade=", 0) == 0) {
+            velocidade = std::atof(arg.c_str() + 13);
+        } else if (arg.rfind("--inicio=", 0) == 0) {
+            inicio = std::strtoull(arg.c_str() + 9, nullptr, 10);
+        } else if (arg == "--info") {
+            soInfo = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Uso: " << argv[0] << " [--velocidade=X] [--inicio=N] [--info] [sim_gravacao.bin]" << std::endl;
+            return 1;
+        } else {
+            caminho = arg;
+        }
+    }
+
+    Gravacao g;
+    if (!abrirGravacao(caminho, g)) {
+        std::cerr << "Erro: Não foi possível abrir " << caminho << std::endl;
+        return 1;
+    }
+
+    if (soInfo) {
+        uint64_t bytesBrutos = 0;
+        uint64_t ultimoInstante = 0;
+        size_t pos = g.indice.empty() ? g.fimRegistros : (size_t)g.indice.front().deslocamento;
+        RegistroFrame registro;
+        while (g.lerRegistro(pos, registro)) {
+            bytesBrutos += registro.tamanhoFrame;
+            ultimoInstante = registro.instanteNs;
+            pos += sizeof(RegistroFrame) + registro.tamanhoDados;
+        }
+        std::cout << "Gravação: " << caminho << " (" << g.cabecalho->largura << "x" << g.cabecalho->altura << ")\n"
+                  << "Frames: " << g.totalFrames << " | keyframes: " << g.indice.size()
+                  << " (a cada " << g.cabecalho->intervaloKeyframe << ")"
+                  << " | índice: " << (g.indiceDoRodape ? "rodapé" : "reconstruído") << "\n"
+                  << "Duração: " << ultimoInstante / 1e9 << " s\n"
+                  << "Tamanho: " << g.tamanho << " bytes (frames brutos: " << bytesBrutos << " bytes, "
+                  << (g.tamanho > 0 ? (double)bytesBrutos / (double)g.tamanho : 0.0) << "x menor)" << std::endl;
+        return 0;
+    }
+    if (g.indice.empty()) {
+        std::cerr << "Gravação vazia." << std::endl;
+        return 0;
+    }
+
+    // Salto: o último keyframe antes (ou em cima) do frame pedido
+    size_t k = 0;
+    while (k + 1 < g.indice.size() && g.indice[k + 1].numeroFrame <= inicio) k++;
+    size_t pos = (size_t)g.indice[k].deslocamento;
+
+    std::signal(SIGINT, tratarSinalDeParada);
+    std::signal(SIGTERM, tratarSinalDeParada);
+
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> delta;
+    uint64_t mostrados = 0;
+    uint64_t instanteBase = 0;
+    bool sincronizado = false;
+    auto partida = std::chrono::steady_clock::now();
+    RegistroFrame registro;
+
+    while (g_executando && g.lerRegistro(pos, registro)) {
+        const uint8_t* comprimido = g.dados + pos + sizeof(RegistroFrame);
+        pos += sizeof(RegistroFrame) + registro.tamanhoDados;
+
+        // 1. Decodifica (keyframe: o frame; delta: XOR com o anterior)
+        if (registro.tipo == REGISTRO_KEYFRAME) {
+            frame.resize(registro.tamanhoFrame);
+            if (descomprimirRLE(comprimido, registro.tamanhoDados, frame.data(), frame.size()) != frame.size()) break;
+        } else {
+            if (frame.size() != registro.tamanhoFrame) break; // Delta sem o keyframe dele
+            delta.resize(registro.tamanhoFrame);
+            if (descomprimirRLE(comprimido, registro.tamanhoDados, delta.data(), delta.size()) != delta.size()) break;
+            for (size_t b = 0; b < frame.size(); b++) frame[b] ^= delta[b];
+        }
+        if (registro.numeroFrame < inicio) continue; // Só avançando até o ponto pedido
+
+        // 2. Espera o instante do frame, na velocidade pedida
+        if (!sincronizado) {
+            instanteBase = registro.instanteNs;
+            partida = std::chrono::steady_clock::now();
+            sincronizado = true;
+        } else if (velocidade > 0.0) {
+            double ns = (double)(registro.instanteNs - instanteBase) / velocidade;
+            std::this_thread::sleep_until(partida + std::chrono::nanoseconds((int64_t)ns));
+        }
+
+        // 3. Mostra (o frame já começa com "\x1b[H")
+        if (write(STDOUT_FILENO, frame.data(), frame.size()) < 0) break;
+        mostrados++;
+    }
+
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - partida).count();
+    std::cerr << "\n[PLAYER] frames=" << mostrados << " tempo=" << segundos << "s"
+              << " fps=" << (segundos > 0.0 ? (double)mostrados / segundos : 0.0) << std::endl;
+    munmap(const_cast<uint8_t*>(g.dados), g.tamanho);
+    return 0;
+}
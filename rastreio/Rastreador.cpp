@@ -0,0 +1,220 @@
+#include "Rastreador.h"
+
+#include <cstdio> // Para snprintf
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Um span. Campos atômicos (relaxed, sem custo no x86) porque
+     * o exportarChrome() pode lê-los enquanto a thread dona grava.
+     */
+    struct RegistroSpan
+    {
+        std::atomic<uint64_t> inicio; // Em Rastreador::agoraTicks()
+        std::atomic<uint64_t> duracao;
+        std::atomic<const DescritorSpan *> descritor;
+    };
+
+    /**
+     * @brief Buffer circular de uma thread: só ela escreve.
+     */
+    struct BufferSpans
+    {
+        uint32_t id = 0;
+        std::string nome; // Protegido por g_mutex
+        size_t capacidade = 0;
+        std::unique_ptr<RegistroSpan[]> registros;
+        std::atomic<uint64_t> escritos{0};
+    };
+
+    // --- Estado global (protegido por g_mutex, exceto os buffers em si) ---
+    std::mutex g_mutex;
+    std::vector<BufferSpans *> g_buffers; // Nunca liberados: uma thread pode gravar até o fim
+    size_t g_capacidade = Rastreador::CAPACIDADE_PADRAO;
+    // Calibração do relógio dos spans: ts = 0 no JSON é o iniciar()
+    uint64_t g_origemNs = 0;
+    uint64_t g_origemTicks = 0;
+
+    thread_local BufferSpans *t_buffer = nullptr;
+
+    size_t _potenciaDe2(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    BufferSpans *_bufferDaThread()
+    {
+        if (t_buffer == nullptr)
+        {
+            // Primeira vez desta thread: cria e registra o buffer (uma única alocação)
+            BufferSpans *buffer = new BufferSpans();
+            std::lock_guard<std::mutex> lock(g_mutex);
+            buffer->id = (uint32_t)g_buffers.size() + 1;
+            buffer->capacidade = g_capacidade;
+            buffer->registros.reset(new RegistroSpan[g_capacidade]);
+            g_buffers.push_back(buffer);
+            t_buffer = buffer;
+        }
+        return t_buffer;
+    }
+
+    void _escreverTextoJSON(std::string &saida, const char *texto)
+    {
+        saida.push_back('"');
+        for (const char *c = texto; *c != '\0'; c++)
+        {
+            if (*c == '"' || *c == '\\')
+                saida.push_back('\\');
+            saida.push_back(*c);
+        }
+        saida.push_back('"');
+    }
+}
+
+std::atomic<bool> Rastreador::s_ativo{false};
+
+void Rastreador::iniciar(size_t capacidadePorThread)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_buffers.empty())
+    {
+        g_capacidade = _potenciaDe2(capacidadePorThread < 64 ? 64 : capacidadePorThread);
+        g_origemNs = agoraNs();
+        g_origemTicks = agoraTicks();
+    }
+    s_ativo.store(true, std::memory_order_release);
+}
+
+void Rastreador::encerrar()
+{
+    s_ativo.store(false, std::memory_order_release);
+}
+
+void Rastreador::nomearThread(const std::string &nome)
+{
+    BufferSpans *buffer = _bufferDaThread();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    buffer->nome = nome;
+}
+
+void Rastreador::registrar(const DescritorSpan *descritor, uint64_t inicio, uint64_t fim)
+{
+    BufferSpans *buffer = t_buffer != nullptr ? t_buffer : _bufferDaThread();
+    const uint64_t n = buffer->escritos.load(std::memory_order_relaxed);
+    RegistroSpan &registro = buffer->registros[n & (buffer->capacidade - 1)];
+    registro.inicio.store(inicio, std::memory_order_relaxed);
+    registro.duracao.store(fim - inicio, std::memory_order_relaxed);
+    registro.descritor.store(descritor, std::memory_order_relaxed);
+    buffer->escritos.store(n + 1, std::memory_order_release);
+}
+
+Rastreador::Estatisticas Rastreador::estatisticas()
+{
+    Estatisticas e;
+    std::lock_guard<std::mutex> lock(g_mutex);
+    e.threads = g_buffers.size();
+    for (BufferSpans *buffer : g_buffers)
+    {
+        uint64_t escritos = buffer->escritos.load(std::memory_order_acquire);
+        e.spans += escritos;
+        if (escritos > buffer->capacidade)
+            e.sobrescritos += escritos - buffer->capacidade;
+    }
+    return e;
+}
+
+bool Rastreador::exportarChrome(const std::string &caminhoArquivo)
+{
+    std::vector<BufferSpans *> buffers;
+    std::vector<std::string> nomes;
+    uint64_t origemTicks;
+    double nsPorTick = 1.0;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        buffers = g_buffers;
+        for (BufferSpans *buffer : buffers)
+            nomes.push_back(buffer->nome);
+        origemTicks = g_origemTicks;
+
+        // Ticks -> ns medido sobre todo o intervalo desde o iniciar()
+        uint64_t ticks = agoraTicks() - g_origemTicks;
+        uint64_t ns = agoraNs() - g_origemNs;
+        if (ticks > 0 && ns > 0)
+            nsPorTick = (double)ns / (double)ticks;
+    }
+
+    std::string saida = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool primeiro = true;
+    char numeros[128];
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        BufferSpans *buffer = buffers[b];
+
+        // Metadados: o nome da thread na linha do tempo
+        if (!nomes[b].empty())
+        {
+            if (!primeiro)
+                saida += ",\n";
+            primeiro = false;
+            std::snprintf(numeros, sizeof(numeros), "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":", buffer->id);
+            saida += numeros;
+            _escreverTextoJSON(saida, nomes[b].c_str());
+            saida += "}}";
+        }
+
+        // Cópia sem parar a thread: o que ela sobrescreveu durante a
+        // leitura (ou pode estar sobrescrevendo agora) é descartado depois
+        const uint64_t fim = buffer->escritos.load(std::memory_order_acquire);
+        const uint64_t inicio = fim > buffer->capacidade ? fim - buffer->capacidade : 0;
+        struct Copia
+        {
+            uint64_t inicio, duracao;
+            const DescritorSpan *descritor;
+        };
+        std::vector<Copia> copia;
+        copia.reserve((size_t)(fim - inicio));
+        for (uint64_t k = inicio; k < fim; k++)
+        {
+            const RegistroSpan &registro = buffer->registros[k & (buffer->capacidade - 1)];
+            copia.push_back({registro.inicio.load(std::memory_order_relaxed),
+                             registro.duracao.load(std::memory_order_relaxed),
+                             registro.descritor.load(std::memory_order_relaxed)});
+        }
+        const uint64_t fimDepois = buffer->escritos.load(std::memory_order_acquire);
+        uint64_t primeiroValido = inicio;
+        if (fimDepois + 1 > buffer->capacidade && fimDepois + 1 - buffer->capacidade > primeiroValido)
+            primeiroValido = fimDepois + 1 - buffer->capacidade;
+
+        for (uint64_t k = primeiroValido; k < fim; k++)
+        {
+            const Copia &span = copia[(size_t)(k - inicio)];
+            if (span.descritor == nullptr || span.inicio < origemTicks)
+                continue;
+            if (!primeiro)
+                saida += ",\n";
+            primeiro = false;
+            saida += "{\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(buffer->id) + ",\"cat\":";
+            _escreverTextoJSON(saida, span.descritor->categoria);
+            saida += ",\"name\":";
+            _escreverTextoJSON(saida, span.descritor->nome);
+            // Microssegundos com 3 casas: resolução de ns
+            std::snprintf(numeros, sizeof(numeros), ",\"ts\":%.3f,\"dur\":%.3f}",
+                          (double)(span.inicio - origemTicks) * nsPorTick / 1e3, (double)span.duracao * nsPorTick / 1e3);
+            saida += numeros;
+        }
+    }
+    saida += "\n]}\n";
+
+    std::ofstream out(caminhoArquivo, std::ios::trunc);
+    if (!out.is_open())
+        return false;
+    out << saida;
+    return (bool)out;
+}
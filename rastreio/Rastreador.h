@@ -0,0 +1,156 @@
+#ifndef RASTREADOR_H
+#define RASTREADOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint64_t
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // __rdtsc
+#endif
+
+/**
+ * Rastreio por spans (trechos com início e duração), para ver onde foi
+ * o tempo de um tick lento.
+ *
+ * Cada ponto de rastreio tem um DescritorSpan estático (categoria e
+ * nome). No caminho quente só se lê o relógio duas vezes e se grava um
+ * registro de 24 bytes no buffer da própria thread: sem locks, sem
+ * alocação (o buffer é alocado uma vez, no primeiro span da thread).
+ *
+ * O buffer é circular ("gravador de voo"): guarda os últimos spans de
+ * cada thread, e pode ficar ligado o tempo todo. exportarChrome() grava
+ * o JSON do Chrome (chrome://tracing, ui.perfetto.dev).
+ *
+ * No x86 o relógio do span é o TSC (rdtsc custa metade de um
+ * steady_clock::now()); a conversão para ns é feita só na exportação.
+ *
+ * Desligado em tempo de execução, um span custa uma leitura atômica;
+ * com -DSIM_TRACE=0, nada.
+ */
+
+// -DSIM_TRACE=0 remove todos os SIM_SPAN do binário
+#ifndef SIM_TRACE
+#define SIM_TRACE 1
+#endif
+
+struct DescritorSpan
+{
+    const char *categoria;
+    const char *nome;
+};
+
+class Rastreador
+{
+public:
+    static const size_t CAPACIDADE_PADRAO = 65536; // Spans por thread (arredonda para potência de 2)
+
+    /**
+     * @brief Liga o rastreio. Os buffers das threads são criados no
+     * primeiro span de cada uma, com 'capacidadePorThread' registros.
+     */
+    static void iniciar(size_t capacidadePorThread = CAPACIDADE_PADRAO);
+
+    /**
+     * @brief Desliga o rastreio. Os spans já gravados continuam
+     * disponíveis para exportarChrome().
+     */
+    static void encerrar();
+
+    static bool ativo() { return s_ativo.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Nome da thread atual no trace exportado (ex: "cpu 0").
+     */
+    static void nomearThread(const std::string &nome);
+
+    /**
+     * @brief Grava os spans guardados no formato JSON do Chrome.
+     * Pode ser chamado com as threads ainda gravando (snapshot).
+     */
+    static bool exportarChrome(const std::string &caminhoArquivo);
+
+    struct Estatisticas
+    {
+        uint64_t spans = 0;        // Gravados desde iniciar()
+        uint64_t sobrescritos = 0; // Perdidos por volta do buffer
+        size_t threads = 0;
+    };
+    static Estatisticas estatisticas();
+
+    static uint64_t agoraNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief O relógio dos spans: TSC no x86, ns nos outros.
+     */
+    static uint64_t agoraTicks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return agoraNs();
+#endif
+    }
+
+    /**
+     * @brief Grava um span no buffer desta thread (caminho quente).
+     * Instantes em agoraTicks().
+     */
+    static void registrar(const DescritorSpan *descritor, uint64_t inicio, uint64_t fim);
+
+private:
+    static std::atomic<bool> s_ativo;
+};
+
+/**
+ * @class SpanEscopo
+ * @brief Mede do construtor ao destrutor (use pelo SIM_SPAN).
+ */
+class SpanEscopo
+{
+public:
+    explicit SpanEscopo(const DescritorSpan *descritor)
+        : m_descritor(descritor), m_inicio(Rastreador::ativo() ? Rastreador::agoraTicks() : 0)
+    {
+    }
+
+    ~SpanEscopo()
+    {
+        if (m_inicio != 0)
+            Rastreador::registrar(m_descritor, m_inicio, Rastreador::agoraTicks());
+    }
+
+    SpanEscopo(const SpanEscopo &) = delete;
+    SpanEscopo &operator=(const SpanEscopo &) = delete;
+
+private:
+    const DescritorSpan *m_descritor;
+    uint64_t m_inicio; // 0: rastreio estava desligado na entrada
+};
+
+#define SIM_SPAN_CONCAT_(a, b) a##b
+#define SIM_SPAN_CONCAT(a, b) SIM_SPAN_CONCAT_(a, b)
+
+/**
+ * @brief Span do ponto atual até o fim do escopo. O descritor é estático
+ * (criado uma vez) e, com SIM_TRACE=0, a linha some.
+ */
+#if SIM_TRACE
+#define SIM_SPAN(categoria, nome)                                                                  \
+    static const DescritorSpan SIM_SPAN_CONCAT(_descritorSpan, __LINE__) = {categoria, nome}; \
+    SpanEscopo SIM_SPAN_CONCAT(_span, __LINE__)(&SIM_SPAN_CONCAT(_descritorSpan, __LINE__))
+#else
+#define SIM_SPAN(categoria, nome) \
+    do                            \
+    {                             \
+    } while (0)
+#endif
+
+#endif // RASTREADOR_H
@@ -0,0 +1,141 @@
+#include "RelogioSimulacao.h"
+
+#include <cmath>
+#include <thread>
+
+#include "../log/Logger.h"
+#include "../metricas/Metricas.h"
+
+// --- AcumuladorJitter ---
+
+void AcumuladorJitter::adicionar(int64_t valorNs)
+{
+    if (amostras == 0 || valorNs < minimoNs)
+        minimoNs = valorNs;
+    if (amostras == 0 || valorNs > maximoNs)
+        maximoNs = valorNs;
+
+    amostras++;
+    double delta = (double)valorNs - mediaNs;
+    mediaNs += delta / (double)amostras;
+    m2 += delta * ((double)valorNs - mediaNs);
+}
+
+double AcumuladorJitter::desvioPadraoNs() const
+{
+    return amostras > 1 ? std::sqrt(m2 / (double)(amostras - 1)) : 0.0;
+}
+
+// --- RelogioSimulacao ---
+
+RelogioSimulacao::RelogioSimulacao(Modo modo, uint64_t periodoNs, PoliticaAtraso politica, uint32_t maxRecuperacao)
+    : m_modo(modo),
+      m_politica(politica),
+      m_periodo(std::chrono::nanoseconds(periodoNs > 0 ? periodoNs : 1)),
+      m_maxRecuperacao(maxRecuperacao)
+{
+    if (m_modo == Modo::Livre)
+    {
+        SIM_LOG(LOG_INFO, "RELOGIO", "Relógio em modo LIVRE (headless): ticks sem espera.");
+    }
+    else
+    {
+        SIM_LOG(LOG_INFO, "RELOGIO", "Relógio em modo RITMADO: período de {} ns.", periodoNs);
+    }
+}
+
+uint32_t RelogioSimulacao::aguardarProximoTick()
+{
+    Relogio::time_point agora = Relogio::now();
+
+    // O primeiro tick sai na hora e ancora a grade
+    if (!m_iniciado)
+    {
+        m_iniciado = true;
+        m_inicio = agora;
+        m_proximoPrazo = agora + m_periodo;
+        m_ultimoDespertar = agora;
+        m_estatisticas.ticks = 1;
+        return 1;
+    }
+
+    uint32_t ticks = 1;
+
+    if (m_modo == Modo::Ritmado)
+    {
+        // Prazo absoluto: o tempo gasto no tick anterior já está descontado
+        if (agora < m_proximoPrazo)
+        {
+            std::this_thread::sleep_until(m_proximoPrazo);
+            agora = Relogio::now();
+        }
+
+        Relogio::duration atraso = agora - m_proximoPrazo;
+        const int64_t atrasoNs = std::chrono::duration_cast<std::chrono::nanoseconds>(atraso).count();
+        m_estatisticas.atraso.adicionar(atrasoNs);
+        Metricas::registrar(HIST_ATRASO_TICK, atrasoNs > 0 ? (uint64_t)atrasoNs : 0);
+
+        // Quantos prazos inteiros passaram além deste
+        uint64_t perdidos = (uint64_t)(atraso / m_periodo);
+        if (perdidos > 0)
+        {
+            uint64_t extras = 0;
+            if (m_politica == PoliticaAtraso::Recuperar)
+            {
+                extras = perdidos < m_maxRecuperacao ? perdidos : m_maxRecuperacao;
+            }
+            ticks += (uint32_t)extras;
+            m_estatisticas.ticksRecuperados += extras;
+            m_estatisticas.ticksPulados += perdidos - extras;
+            if (perdidos > extras)
+            {
+                SIM_LOG(LOG_DEBUG, "RELOGIO", "Atraso de {} ns: {} prazo(s) descartado(s).",
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(atraso).count(), perdidos - extras);
+            }
+            // Continua na mesma grade, só que depois dos prazos perdidos
+            m_proximoPrazo += m_periodo * perdidos;
+        }
+        m_proximoPrazo += m_periodo;
+    }
+
+    m_estatisticas.intervalo.adicionar(std::chrono::duration_cast<std::chrono::nanoseconds>(agora - m_ultimoDespertar).count());
+    m_ultimoDespertar = agora;
+    m_estatisticas.ticks += ticks;
+    return ticks;
+}
+
+void RelogioSimulacao::reancorar()
+{
+    if (!m_iniciado)
+        return;
+    Relogio::time_point agora = Relogio::now();
+    m_proximoPrazo = agora;
+    m_ultimoDespertar = agora;
+}
+
+void RelogioSimulacao::relatar(std::ostream &saida) const
+{
+    const Estatisticas &e = m_estatisticas;
+    double segundos = m_iniciado ? std::chrono::duration<double>(m_ultimoDespertar - m_inicio).count() : 0.0;
+    double ticksPorSegundo = segundos > 0.0 ? (double)e.ticks / segundos : 0.0;
+
+    saida << "[RELOGIO] modo=" << (m_modo == Modo::Livre ? "livre" : "ritmado")
+          << " ticks=" << e.ticks
+          << " duracao=" << segundos << "s"
+          << " taxa=" << ticksPorSegundo << " ticks/s"
+          << " recuperados=" << e.ticksRecuperados
+          << " pulados=" << e.ticksPulados << "\n";
+
+    saida << "[RELOGIO] intervalo (us): min=" << e.intervalo.minimoNs / 1e3
+          << " media=" << e.intervalo.mediaNs / 1e3
+          << " max=" << e.intervalo.maximoNs / 1e3
+          << " desvio=" << e.intervalo.desvioPadraoNs() / 1e3 << "\n";
+
+    if (m_modo == Modo::Ritmado)
+    {
+        saida << "[RELOGIO] jitter/atraso no prazo (us): min=" << e.atraso.minimoNs / 1e3
+              << " media=" << e.atraso.mediaNs / 1e3
+              << " max=" << e.atraso.maximoNs / 1e3
+              << " desvio=" << e.atraso.desvioPadraoNs() / 1e3 << "\n";
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef RELOGIO_SIMULACAO_H
+#define RELOGIO_SIMULACAO_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @struct AcumuladorJitter
+ * @brief Estatística incremental (Welford) de uma série de tempos em ns.
+ * Não guarda as amostras: custo e memória constantes por tick.
+ */
+struct AcumuladorJitter
+{
+    uint64_t amostras = 0;
+    int64_t minimoNs = 0;
+    int64_t maximoNs = 0;
+    double mediaNs = 0.0;
+    double m2 = 0.0; // Soma dos quadrados dos desvios
+
+    void adicionar(int64_t valorNs);
+    double desvioPadraoNs() const;
+};
+
+/**
+ * @class RelogioSimulacao
+ * @brief O "clock" do sistema: decide QUANDO e QUANTOS ticks rodar.
+ *
+ * Modo Ritmado: ticks em passo fixo contra o std::chrono::steady_clock.
+ * Os prazos ficam numa grade absoluta (inicio + n * periodo), então o
+ * custo do tick não se acumula como com sleep_for(33ms).
+ * Se um tick atrasar mais que um período, a PoliticaAtraso decide:
+ *  - Recuperar: roda os ticks perdidos em sequência (até um limite);
+ *  - PularQuadros: roda só um tick e descarta os prazos perdidos.
+ *
+ * Modo Livre (headless): não dorme; roda ticks o mais rápido possível,
+ * para execuções em lote e benchmarks.
+ */
+class RelogioSimulacao
+{
+public:
+    enum class Modo
+    {
+        Ritmado,
+        Livre
+    };
+
+    enum class PoliticaAtraso
+    {
+        Recuperar,
+        PularQuadros
+    };
+
+    struct Estatisticas
+    {
+        uint64_t ticks = 0;            // Total de ticks liberados
+        uint64_t ticksRecuperados = 0; // Ticks extras rodados para alcançar a grade
+        uint64_t ticksPulados = 0;     // Prazos descartados
+        AcumuladorJitter atraso;       // Despertar real - prazo (só Ritmado)
+        AcumuladorJitter intervalo;    // Tempo entre despertares consecutivos
+    };
+
+    /**
+     * @param modo Ritmado (passo fixo) ou Livre (sem espera).
+     * @param periodoNs Duração de um tick no modo Ritmado.
+     * @param politica O que fazer quando a grade atrasar.
+     * @param maxRecuperacao Máximo de ticks extras por despertar (Recuperar).
+     */
+    RelogioSimulacao(Modo modo, uint64_t periodoNs,
+                     PoliticaAtraso politica = PoliticaAtraso::Recuperar,
+                     uint32_t maxRecuperacao = 4);
+
+    /**
+     * @brief Espera até o próximo prazo (Ritmado) e diz quantos ticks rodar.
+     * @return Número de ticks a executar agora (>= 1).
+     */
+    uint32_t aguardarProximoTick();
+
+    /**
+     * @brief Recomeça a grade a partir de agora: o próximo tick sai na
+     * hora e os prazos que venceram enquanto a CPU dormia (HLT) não são
+     * recuperados nem contados como atraso.
+     */
+    void reancorar();
+
+    const Estatisticas &estatisticas() const { return m_estatisticas; }
+    Modo modo() const { return m_modo; }
+
+    /**
+     * @brief Escreve um resumo legível das estatísticas (ex: no std::cerr).
+     */
+    void relatar(std::ostream &saida) const;
+
+private:
+    typedef std::chrono::steady_clock Relogio;
+
+    Modo m_modo;
+    PoliticaAtraso m_politica;
+    Relogio::duration m_periodo;
+    uint32_t m_maxRecuperacao;
+
+    bool m_iniciado = false;
+    Relogio::time_point m_inicio;
+    Relogio::time_point m_proximoPrazo;
+    Relogio::time_point m_ultimoDespertar;
+
+    Estatisticas m_estatisticas;
+};
+
+#endif // RELOGIO_SIMULACAO_H
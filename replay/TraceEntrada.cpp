@@ -0,0 +1,236 @@
+#include "TraceEntrada.h"
+#include "../log/Logger.h"
+
+#include <cerrno>
+#include <cstring> // Para memcpy
+#include <fstream>
+#include <iterator>
+
+// --- DEPENDÊNCIAS POSIX ---
+#include <fcntl.h>    // open
+#include <unistd.h>   // write, close
+#include <sys/stat.h> // mode_t
+// --------------------------
+
+// ---------------------------------------------------------------
+// GravadorTrace
+// ---------------------------------------------------------------
+
+GravadorTrace::GravadorTrace(const std::string &caminhoArquivo, const std::string &configuracao)
+    : m_fd(-1), m_ultimoTick(0), m_eventos(0), m_bytesGravados(0)
+{
+    m_fd = open(caminhoArquivo.c_str(), O_CREAT | O_WRONLY | O_TRUNC, (mode_t)0644);
+    if (m_fd == -1)
+    {
+        SIM_LOG(LOG_ERRO, "TRACE", "ERRO: Falha ao criar o trace de entrada (errno {}).", errno);
+        return;
+    }
+
+    CabecalhoTrace cabecalho = {};
+    cabecalho.magic = MAGIC_TRACE_ENTRADA;
+    cabecalho.versao = VERSAO_TRACE_ENTRADA;
+    cabecalho.tamanhoConfiguracao = (uint32_t)configuracao.size();
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&cabecalho);
+    m_pendente.insert(m_pendente.end(), bytes, bytes + sizeof(cabecalho));
+    m_pendente.insert(m_pendente.end(), configuracao.begin(), configuracao.end());
+    _descarregar();
+    SIM_LOG(LOG_INFO, "TRACE", "Gravando a entrada ({} bytes de configuração).", configuracao.size());
+}
+
+GravadorTrace::~GravadorTrace()
+{
+    fechar(m_ultimoTick);
+}
+
+void GravadorTrace::registrarTeclas(uint64_t tick, const char *teclas, size_t quantidade)
+{
+    if (m_fd == -1 || quantidade == 0)
+        return;
+    _cabecalhoRegistro(TRACE_TECLAS, tick);
+    _varint(quantidade);
+    m_pendente.insert(m_pendente.end(), teclas, teclas + quantidade);
+    m_eventos++;
+    if (m_pendente.size() >= TAMANHO_BLOCO_ESCRITA)
+        _descarregar();
+}
+
+void GravadorTrace::registrarChecksum(uint64_t tick, uint64_t checksum)
+{
+    if (m_fd == -1)
+        return;
+    _cabecalhoRegistro(TRACE_CHECKSUM, tick);
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&checksum);
+    m_pendente.insert(m_pendente.end(), bytes, bytes + sizeof(checksum));
+    if (m_pendente.size() >= TAMANHO_BLOCO_ESCRITA)
+        _descarregar();
+}
+
+void GravadorTrace::fechar(uint64_t totalTicks)
+{
+    if (m_fd == -1)
+        return;
+    _cabecalhoRegistro(TRACE_FIM, totalTicks < m_ultimoTick ? m_ultimoTick : totalTicks);
+    _descarregar();
+    close(m_fd);
+    m_fd = -1;
+    SIM_LOG(LOG_INFO, "TRACE", "Trace fechado: {} eventos de teclado, {} ticks, {} bytes.", m_eventos, totalTicks, m_bytesGravados);
+}
+
+void GravadorTrace::_cabecalhoRegistro(TipoRegistroTrace tipo, uint64_t tick)
+{
+    if (tick < m_ultimoTick)
+        tick = m_ultimoTick; // Ticks nunca voltam
+    m_pendente.push_back(tipo);
+    _varint(tick - m_ultimoTick);
+    m_ultimoTick = tick;
+}
+
+void GravadorTrace::_varint(uint64_t valor)
+{
+    // LEB128: 7 bits por byte, o bit alto diz "tem mais"
+    while (valor >= 0x80)
+    {
+        m_pendente.push_back((uint8_t)(valor | 0x80));
+        valor >>= 7;
+    }
+    m_pendente.push_back((uint8_t)valor);
+}
+
+void GravadorTrace::_descarregar()
+{
+    size_t escrito = 0;
+    while (escrito < m_pendente.size())
+    {
+        ssize_t n = write(m_fd, m_pendente.data() + escrito, m_pendente.size() - escrito);
+        if (n <= 0)
+        {
+            if (n == -1 && errno == EINTR)
+                continue;
+            SIM_LOG(LOG_ERRO, "TRACE", "ERRO: Falha ao gravar o trace (errno {}).", errno);
+            close(m_fd);
+            m_fd = -1;
+            break;
+        }
+        escrito += (size_t)n;
+    }
+    m_bytesGravados += escrito;
+    m_pendente.clear();
+}
+
+// ---------------------------------------------------------------
+// LeitorTrace
+// ---------------------------------------------------------------
+
+LeitorTrace::LeitorTrace(const std::string &caminhoArquivo)
+    : m_valido(false), m_totalTicks(0), m_proximoEvento(0), m_proximoChecksum(0),
+      m_temChecksum(false), m_checksumAtual(0)
+{
+    std::ifstream in(caminhoArquivo, std::ios::binary);
+    if (!in.is_open())
+        return;
+    std::vector<uint8_t> dados((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    CabecalhoTrace cabecalho;
+    if (dados.size() < sizeof(cabecalho))
+        return;
+    memcpy(&cabecalho, dados.data(), sizeof(cabecalho));
+    if (cabecalho.magic != MAGIC_TRACE_ENTRADA || cabecalho.versao != VERSAO_TRACE_ENTRADA ||
+        sizeof(cabecalho) + cabecalho.tamanhoConfiguracao > dados.size())
+        return;
+    size_t pos = sizeof(cabecalho);
+    m_configuracao.assign(reinterpret_cast<const char *>(dados.data() + pos), cabecalho.tamanhoConfiguracao);
+    pos += cabecalho.tamanhoConfiguracao;
+
+    bool ok = true;
+    auto lerVarint = [&]() {
+        uint64_t valor = 0;
+        for (int deslocamento = 0; deslocamento < 64; deslocamento += 7)
+        {
+            if (pos >= dados.size())
+                break;
+            uint8_t b = dados[pos++];
+            valor |= (uint64_t)(b & 0x7f) << deslocamento;
+            if (!(b & 0x80))
+                return valor;
+        }
+        ok = false;
+        return valor;
+    };
+
+    uint64_t tick = 0;
+    bool fim = false;
+    while (ok && !fim && pos < dados.size())
+    {
+        uint8_t tipo = dados[pos++];
+        tick += lerVarint();
+        if (!ok)
+            break;
+        switch (tipo)
+        {
+        case TRACE_TECLAS:
+        {
+            uint64_t n = lerVarint();
+            if (!ok || pos + n > dados.size())
+            {
+                ok = false;
+                break;
+            }
+            Evento evento = {tick, m_teclas.size(), (size_t)n};
+            m_teclas.insert(m_teclas.end(), dados.begin() + pos, dados.begin() + pos + n);
+            m_eventos.push_back(evento);
+            pos += n;
+            break;
+        }
+        case TRACE_CHECKSUM:
+        {
+            MarcaChecksum marca;
+            if (pos + sizeof(marca.checksum) > dados.size())
+            {
+                ok = false;
+                break;
+            }
+            marca.tick = tick;
+            memcpy(&marca.checksum, dados.data() + pos, sizeof(marca.checksum));
+            m_checksums.push_back(marca);
+            pos += sizeof(marca.checksum);
+            break;
+        }
+        case TRACE_FIM:
+            m_totalTicks = tick;
+            fim = true;
+            break;
+        default:
+            ok = false;
+        }
+    }
+
+    // Trace truncado (simulador morto sem fechar): vale até o último tick visto
+    if (!fim)
+    {
+        m_totalTicks = tick;
+        SIM_LOG(LOG_AVISO, "TRACE", "AVISO: Trace sem registro FIM; usando até o tick {}.", tick);
+    }
+    m_valido = true;
+}
+
+size_t LeitorTrace::teclasDoTick(uint64_t tick, std::vector<char> &destino)
+{
+    destino.clear();
+    while (m_proximoEvento < m_eventos.size() && m_eventos[m_proximoEvento].tick <= tick)
+    {
+        const Evento &evento = m_eventos[m_proximoEvento++];
+        destino.insert(destino.end(), m_teclas.begin() + evento.inicio, m_teclas.begin() + evento.inicio + evento.quantidade);
+    }
+    return destino.size();
+}
+
+bool LeitorTrace::checksumEsperado(uint64_t tick, uint64_t &checksum)
+{
+    while (m_proximoChecksum < m_checksums.size() && m_checksums[m_proximoChecksum].tick <= tick)
+    {
+        m_checksumAtual = m_checksums[m_proximoChecksum++].checksum;
+        m_temChecksum = true;
+    }
+    checksum = m_checksumAtual;
+    return m_temChecksum;
+}
@@ -0,0 +1,150 @@
+#ifndef TRACE_ENTRADA_H
+#define TRACE_ENTRADA_H
+
+#include <cstddef> // Para size_t
+#include <cstdint> // Para uint8_t, uint64_t
+#include <string>
+#include <vector>
+
+/**
+ * Trace de entrada (sim_entrada.trc): tudo o que entrou pelo
+ * HardwareTeclado::eventoUsuarioDigitou, com o nº do tick em que
+ * entrou, mais o checksum do frame a cada tick em que ele mudou.
+ *
+ * [CabecalhoTrace][configuração (texto)] e depois registros:
+ *   TECLAS:   [tipo][varint deltaTick][varint n][n bytes]
+ *   CHECKSUM: [tipo][varint deltaTick][8 bytes]
+ *   FIM:      [tipo][varint deltaTick]            (total de ticks)
+ * 'deltaTick' é relativo ao registro anterior: um trace de horas
+ * com pouca digitação ocupa poucos KB.
+ */
+
+static const uint32_t MAGIC_TRACE_ENTRADA = 0x31435254; // "TRC1"
+static const uint32_t VERSAO_TRACE_ENTRADA = 1;
+
+enum TipoRegistroTrace : uint8_t
+{
+    TRACE_TECLAS = 1,
+    TRACE_CHECKSUM = 2,
+    TRACE_FIM = 3
+};
+
+struct CabecalhoTrace
+{
+    uint32_t magic;
+    uint32_t versao;
+    uint32_t tamanhoConfiguracao; // Bytes de texto logo depois do cabeçalho
+    uint32_t reservado;
+};
+
+/**
+ * @brief Checksum (FNV-1a de 64 bits) do conteúdo de um frame.
+ */
+inline uint64_t checksumFrame(const char *dados, size_t tamanho)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t k = 0; k < tamanho; k++)
+    {
+        hash ^= (uint8_t)dados[k];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * @class GravadorTrace
+ * @brief Escreve o trace. Os registros ficam em memória e vão para o
+ * arquivo em blocos (e no fechar()).
+ */
+class GravadorTrace
+{
+public:
+    /**
+     * @param configuracao Texto livre com os argumentos que afetam a
+     * simulação: o reprodutor avisa se rodar com outros.
+     */
+    GravadorTrace(const std::string &caminhoArquivo, const std::string &configuracao);
+    ~GravadorTrace();
+
+    GravadorTrace(const GravadorTrace &) = delete;
+    GravadorTrace &operator=(const GravadorTrace &) = delete;
+
+    bool valido() const { return m_fd != -1; }
+
+    void registrarTeclas(uint64_t tick, const char *teclas, size_t quantidade);
+    void registrarChecksum(uint64_t tick, uint64_t checksum);
+
+    /**
+     * @brief Escreve o FIM (com o total de ticks) e fecha o arquivo.
+     */
+    void fechar(uint64_t totalTicks);
+
+    uint64_t totalEventos() const { return m_eventos; }
+    uint64_t bytesGravados() const { return m_bytesGravados; }
+
+private:
+    static const size_t TAMANHO_BLOCO_ESCRITA = 64 * 1024;
+
+    int m_fd;
+    uint64_t m_ultimoTick;
+    uint64_t m_eventos;
+    uint64_t m_bytesGravados;
+    std::vector<uint8_t> m_pendente;
+
+    void _cabecalhoRegistro(TipoRegistroTrace tipo, uint64_t tick);
+    void _varint(uint64_t valor);
+    void _descarregar();
+};
+
+/**
+ * @class LeitorTrace
+ * @brief Carrega um trace inteiro e o percorre tick a tick.
+ */
+class LeitorTrace
+{
+public:
+    explicit LeitorTrace(const std::string &caminhoArquivo);
+
+    bool valido() const { return m_valido; }
+    const std::string &configuracao() const { return m_configuracao; }
+    uint64_t totalTicks() const { return m_totalTicks; }
+
+    /**
+     * @brief Teclas que entraram antes do tick 'tick' (chame em ordem
+     * crescente de tick). @return Quantas foram copiadas para 'destino'.
+     */
+    size_t teclasDoTick(uint64_t tick, std::vector<char> &destino);
+
+    /**
+     * @brief Checksum esperado do frame depois do tick 'tick'
+     * (o último registrado até ele). @return false se não há nenhum ainda.
+     */
+    bool checksumEsperado(uint64_t tick, uint64_t &checksum);
+
+private:
+    struct Evento
+    {
+        uint64_t tick;
+        size_t inicio; // Em m_teclas
+        size_t quantidade;
+    };
+    struct MarcaChecksum
+    {
+        uint64_t tick;
+        uint64_t checksum;
+    };
+
+    bool m_valido;
+    std::string m_configuracao;
+    uint64_t m_totalTicks;
+
+    std::vector<char> m_teclas;
+    std::vector<Evento> m_eventos;
+    std::vector<MarcaChecksum> m_checksums;
+    size_t m_proximoEvento;
+    size_t m_proximoChecksum;
+    bool m_temChecksum;
+    uint64_t m_checksumAtual;
+};
+
+#endif // TRACE_ENTRADA_H
@@ -0,0 +1,256 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+
+#include "./metricas/FormatoMetricasShm.h" // Layout da página e os histogramas
+
+/**
+ * @brief Monitor ao vivo do simulador (no lugar de grep no sim_logs.txt).
+ *
+ * Uso: ./simtop [--intervalo=MS] [--uma-vez] [sim_metricas.shm]
+ *   --intervalo=MS : de quanto em quanto tempo redesenhar (padrão 1000)
+ *   --uma-vez      : espera um intervalo, imprime um quadro sem ANSI e sai
+ *
+ * Mapeia a página de métricas só para leitura e nunca bloqueia o
+ * simulador: cada quadro é a diferença entre duas cópias da página
+ * (taxas por segundo e percentis do intervalo).
+ */
+
+static volatile std::sig_atomic_t g_executando = 1;
+
+static void tratarSinalDeParada(int) {
+    g_executando = 0;
+}
+
+/**
+ * @brief A página de métricas mapeada (só leitura).
+ */
+struct PaginaMapeada {
+    const PaginaMetricasShm* pagina = nullptr;
+
+    bool abrir(const std::string& caminho) {
+        int fd = open(caminho.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+
+        struct stat info;
+        if (fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(PaginaMetricasShm)) {
+            close(fd);
+            return false;
+        }
+        void* ptr = mmap(0, sizeof(PaginaMetricasShm), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) return false;
+
+        const PaginaMetricasShm* p = static_cast<const PaginaMetricasShm*>(ptr);
+        if (p->magic != MAGIC_METRICAS_SHM || p->versao != VERSAO_METRICAS_SHM) {
+            munmap(ptr, sizeof(PaginaMetricasShm));
+            return false;
+        }
+        pagina = p;
+        return true;
+    }
+
+    ~PaginaMapeada() {
+        if (pagina != nullptr) munmap(const_cast<PaginaMetricasShm*>(pagina), sizeof(PaginaMetricasShm));
+    }
+};
+
+/**
+ * @brief Uma cópia da página num instante (o simulador segue escrevendo).
+ */
+struct Leitura {
+    uint32_t pid = 0;
+    uint64_t inicioNs = 0;
+    std::chrono::steady_clock::time_point instante;
+    uint64_t ticks[MAX_NUCLEOS_METRICAS] = {};
+    uint64_t irqs[NUM_LINHAS_METRICAS] = {};
+    CopiaHistogramaMetrica histogramas[NUM_HISTOGRAMAS_METRICAS];
+
+    void copiar(const PaginaMetricasShm& p) {
+        pid = p.pid;
+        inicioNs = p.inicioNs;
+        instante = std::chrono::steady_clock::now();
+        for (uint32_t k = 0; k < MAX_NUCLEOS_METRICAS; k++) {
+            ticks[k] = p.ticksPorNucleo[k].ticks.load(std::memory_order_relaxed);
+        }
+        for (uint32_t l = 0; l < NUM_LINHAS_METRICAS; l++) {
+            irqs[l] = p.irqsPorLinha[l].load(std::memory_order_relaxed);
+        }
+        for (uint32_t h = 0; h < NUM_HISTOGRAMAS_METRICAS; h++) {
+            histogramas[h].copiar(p.histogramas[h]);
+        }
+    }
+
+    uint64_t totalTicks() const {
+        uint64_t total = 0;
+        for (uint32_t k = 0; k < MAX_NUCLEOS_METRICAS; k++) total += ticks[k];
+        return total;
+    }
+};
+
+/**
+ * @brief ns em texto curto com a unidade que couber (ex: "850ns", "4.56ms").
+ */
+static std::string formatarNs(double ns) {
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(ns < 1e3 ? 0 : 2);
+    if (ns < 1e3) s << ns << "ns";
+    else if (ns < 1e6) s << ns / 1e3 << "us";
+    else if (ns < 1e9) s << ns / 1e6 << "ms";
+    else s << ns / 1e9 << "s";
+    return s.str();
+}
+
+static bool processoVivo(uint32_t pid) {
+    return pid != 0 && (kill((pid_t)pid, 0) == 0 || errno == EPERM);
+}
+
+/**
+ * @brief Monta um quadro com o que mudou entre 'antes' e 'agora'.
+ */
+static void montarQuadro(const PaginaMetricasShm& p, const Leitura& antes, const Leitura& agora, std::ostream& saida) {
+    const double segundos = std::chrono::duration<double>(agora.instante - antes.instante).count();
+    const double porSegundo = segundos > 0.0 ? 1.0 / segundos : 0.0;
+    const uint32_t nucleos = p.nucleos < MAX_NUCLEOS_METRICAS ? p.nucleos : MAX_NUCLEOS_METRICAS;
+
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t agoraNs = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+
+    saida << std::fixed << std::setprecision(1);
+    saida << "simtop - pid " << p.pid << (processoVivo(p.pid) ? "" : " (encerrado)")
+          << " | " << p.nucleos << " nucleo(s)"
+          << " | " << (p.periodoAlvoNs > 0 ? "alvo " + formatarNs((double)p.periodoAlvoNs) + "/tick" : std::string("headless"))
+          << " | ha " << formatarNs((double)(agoraNs - p.inicioNs)) << "\n\n";
+
+    // --- Ticks ---
+    saida << "ticks/s   " << std::setw(12) << (double)(agora.totalTicks() - antes.totalTicks()) * porSegundo
+          << "   total " << agora.totalTicks() << "\n";
+    if (nucleos > 1) {
+        for (uint32_t k = 0; k < nucleos; k++) {
+            saida << "  nucleo " << std::setw(2) << k << std::setw(12) << (double)(agora.ticks[k] - antes.ticks[k]) * porSegundo
+                  << "   total " << agora.ticks[k] << "\n";
+        }
+    }
+
+    // --- IRQs (só as linhas que já dispararam) ---
+    saida << "\nIRQ   por segundo       total\n";
+    for (uint32_t l = 0; l < NUM_LINHAS_METRICAS; l++) {
+        if (agora.irqs[l] == 0) continue;
+        saida << std::setw(3) << l << std::setw(14) << (double)(agora.irqs[l] - antes.irqs[l]) * porSegundo
+              << std::setw(12) << agora.irqs[l] << "\n";
+    }
+
+    // --- Histogramas (percentis do intervalo, máximo desde o início) ---
+    saida << "\n" << std::left << std::setw(14) << "tempo" << std::right << std::setw(10) << "por seg"
+          << std::setw(11) << "media" << std::setw(11) << "p50" << std::setw(11) << "p99" << std::setw(11) << "max" << "\n";
+    for (uint32_t h = 0; h < NUM_HISTOGRAMAS_METRICAS; h++) {
+        const CopiaHistogramaMetrica& a = antes.histogramas[h];
+        const CopiaHistogramaMetrica& b = agora.histogramas[h];
+        const uint64_t amostras = b.amostras - a.amostras;
+        saida << std::left << std::setw(14) << NOMES_HISTOGRAMAS_METRICAS[h] << std::right
+              << std::setw(10) << (double)amostras * porSegundo;
+        if (amostras > 0) {
+            saida << std::setw(11) << formatarNs((double)(b.somaNs - a.somaNs) / (double)amostras)
+                  << std::setw(11) << formatarNs((double)b.percentilDesde(a, 0.50))
+                  << std::setw(11) << formatarNs((double)b.percentilDesde(a, 0.99));
+        } else {
+            saida << std::setw(11) << "-" << std::setw(11) << "-" << std::setw(11) << "-";
+        }
+        saida << std::setw(11) << (b.amostras > 0 ? formatarNs((double)b.maximoNs) : std::string("-")) << "\n";
+    }
+
+    // --- Entrada ---
+    const uint64_t amostradaNs = p.entradaAmostradaNs.load(std::memory_order_relaxed);
+    saida << "\nteclado    retidas " << p.tecladoRetidas.load(std::memory_order_relaxed)
+          << "  entregues " << p.tecladoEntregues.load(std::memory_order_relaxed)
+          << "  descartadas " << p.tecladoDescartadas.load(std::memory_order_relaxed) << "\n";
+    saida << "buffer OS  pendentes " << p.entradaOSPendentes.load(std::memory_order_relaxed)
+          << "  enfileiradas " << p.entradaOSEnfileiradas.load(std::memory_order_relaxed)
+          << "  descartadas " << p.entradaOSDescartadas.load(std::memory_order_relaxed);
+    if (amostradaNs != 0 && agoraNs > amostradaNs) {
+        saida << "  (amostra de " << formatarNs((double)(agoraNs - amostradaNs)) << " atras)";
+    }
+    saida << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string caminho = "sim_metricas.shm";
+    int intervaloMs = 1000;
+    bool umaVez = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--intervalo=", 0) == 0 && std::atoi(arg.c_str() + 12) > 0) {
+            intervaloMs = std::atoi(arg.c_str() + 12);
+        } else if (arg == "--uma-vez") {
+            umaVez = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Uso: " << argv[0] << " [--intervalo=MS] [--uma-vez] [sim_metricas.shm]" << std::endl;
+            return 1;
+        } else {
+            caminho = arg;
+        }
+    }
+
+    std::signal(SIGINT, tratarSinalDeParada);
+    std::signal(SIGTERM, tratarSinalDeParada);
+
+    // 1. Espera o simulador criar a página
+    PaginaMapeada mapeada;
+    bool avisou = false;
+    while (g_executando && !mapeada.abrir(caminho)) {
+        if (!avisou) {
+            std::cerr << "Aguardando o simulador (" << caminho << ")..." << std::endl;
+            avisou = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    if (!g_executando) return 0;
+    const PaginaMetricasShm& pagina = *mapeada.pagina;
+
+    // 2. Um quadro por intervalo: diferença entre a leitura anterior e a atual
+    std::unique_ptr<Leitura> antes(new Leitura()), agora(new Leitura());
+    antes->copiar(pagina);
+    bool primeiroQuadro = true;
+    while (g_executando) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervaloMs));
+        agora->copiar(pagina);
+        if (agora->pid != antes->pid || agora->inicioNs != antes->inicioNs) {
+            // O simulador reiniciou e recriou a página: recomeça a base
+            std::swap(antes, agora);
+            continue;
+        }
+
+        std::ostringstream quadro;
+        montarQuadro(pagina, *antes, *agora, quadro);
+        if (umaVez) {
+            std::cout << quadro.str() << std::flush;
+            break;
+        }
+        // Cursor no início, e cada linha limpa o resto dela: sem piscar a tela inteira
+        std::string texto = quadro.str();
+        std::string saida = primeiroQuadro ? "\x1b[2J\x1b[H" : "\x1b[H";
+        for (char c : texto) {
+            if (c == '\n') saida += "\x1b[K";
+            saida += c;
+        }
+        std::cout << saida << "\x1b[J" << std::flush;
+        primeiroQuadro = false;
+        std::swap(antes, agora);
+    }
+    return 0;
+}
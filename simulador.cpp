@@ -1,203 +1,712 @@
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <string>
 #include <thread>
 #include <chrono>
-#include <cstring> // Para memcpy
-
-// --- DEPENDÊNCIAS POSIX PARA MMAP ---
-#include <sys/mman.h> // mmap, munmap
-#include <fcntl.h>    // open
-#include <unistd.h>   // close, ftruncate
-#include <sys/stat.h> // stat
-// ------------------------------------
+#include <csignal> // Para SIGINT/SIGTERM
+#include <cstdlib> // Para atoi, strtoull
+#include <cstdio>  // Para sscanf
+#include <cstdint>
+#include <atomic>
+#include <memory> // Para std::unique_ptr
+#include <mutex>
+#include <vector>
 
 // Nossas classes de simulação
 #include "./cpu/cpu.h"
+#include "./placa/PlacaEstatica.h"
 #include "./pic/ControladorPIC.h"
 #include "./teclado/teclado.h"
 #include "./buffer/BufferDeEntradaOS.h"
+#include "./ipc/CanalEntradaShm.h"
+#include "./log/Logger.h"
+#include "./rastreio/Rastreador.h"
+#include "./metricas/Metricas.h"
+#include "./timer/TimerPIT.h"
+#include "./kernel/Escalonador.h"
+#include "./kernel/EscalonadorSMP.h"
+#include "./smp/MaquinaSMP.h"
+#include "./relogio/RelogioSimulacao.h"
+#include "./bench/SuiteBench.h"
 
 // Nossas implementações concretas (vamos ignorar FileFrameBuffer.h)
 #include "./app/donut.h"
-#include "./interface/IFrameBuffer.h" // A interface que vamos implementar
+#include "./buffer/MmapFrameBuffer.h"
+#include "./buffer/FrameBufferNulo.h"
+#include "./buffer/GravadorFrameBuffer.h"
+#include "./buffer/FrameBufferDuplo.h"
+#include "./buffer/FrameBufferChecksum.h"
+#include "./replay/TraceEntrada.h"
 
 // --- Constantes dos nossos arquivos de interface ---
 const std::string ARQUIVO_LOGS = "sim_logs.txt";
+const std::string ARQUIVO_LOGS_BIN = "sim_logs.bin";
 const std::string ARQUIVO_FRAME = "sim_frame.txt";
+const std::string ARQUIVO_FRAME_SHM = "sim_frame.shm";
 const std::string ARQUIVO_INPUT = "sim_input.txt";
+const std::string ARQUIVO_CANAL_INPUT = "sim_input.shm";
+const std::string ARQUIVO_METRICAS = "sim_metricas.shm";
 
-// Define o tamanho do buffer de frame. 
-// W * H + H newlines (80 * 24 + 24) = 1944.
-#define FRAME_BUFFER_SIZE (W * H + H) 
+// Maior --resolucao aceita, por eixo (4096x4096 já dá 16 MB por slot do frame)
+const int LIMITE_RESOLUCAO = 4096;
 
 /**
- * @class MmapFrameBuffer
- * @brief Implementação de IFrameBuffer que usa memória mapeada
- * por arquivo (mmap) para alta performance IPC.
+ * @brief Modo "arquivo" (legado): a 'main' faz o papel do "socket"
+ * lendo o arquivo de input, enviando para o teclado e limpando o arquivo.
+ * 'Destino' é o HardwareTeclado ou, gravando o trace, a EntradaPendente.
  */
-class MmapFrameBuffer : public IFrameBuffer {
-private:
-    std::string m_caminhoArquivo;
-    int m_fd;
-    char* m_map_ptr;
-    size_t m_size;
+template <typename Destino>
+void pollerDeInput(Destino& teclado) {
+    std::ifstream in(ARQUIVO_INPUT);
+    if (!in.is_open()) return;
 
-    void _log(const std::string& msg) {
-        std::cout << "[MMAP FB] " << msg << std::endl;
-    }
+    std::string input;
+    // Lê a primeira linha de input
+    std::getline(in, input); 
+    in.close();
 
-public:
-    MmapFrameBuffer(const std::string& caminhoArquivo)
-        : m_caminhoArquivo(caminhoArquivo), m_fd(-1), m_map_ptr(nullptr), m_size(FRAME_BUFFER_SIZE) {
+    if (!input.empty()) {
+        // Envia o input para o hardware do teclado
+        teclado.eventoUsuarioDigitou(input);
         
-        _log("Inicializando MmapFrameBuffer...");
+        // Limpa o arquivo de input (truncando)
+        std::ofstream out(ARQUIVO_INPUT, std::ios::trunc);
+        out.close();
+    }
+}
 
-        // 1. Abre/Cria o arquivo
-        // O_CREAT: Cria se não existir. O_RDWR: Leitura e Escrita.
-        m_fd = open(m_caminhoArquivo.c_str(), O_CREAT | O_RDWR, (mode_t)0600);
-        if (m_fd == -1) {
-            _log("ERRO: Falha ao abrir/criar o arquivo: " + m_caminhoArquivo);
-            return;
-        }
+/**
+ * @brief Modo "shm" (padrão): drena o anel compartilhado com o listener.
+ * Sem syscalls quando não há teclas, e nenhuma tecla é perdida.
+ */
+template <typename Destino>
+void pollerDeInput(CanalEntradaShm& canal, Destino& teclado) {
+    EventoTecla eventos[64];
+    char teclas[64];
+    size_t n;
 
-        // 2. Define o tamanho do arquivo (Crucial para MMAP)
-        if (ftruncate(m_fd, m_size) == -1) {
-            _log("ERRO: Falha ao definir o tamanho do arquivo com ftruncate.");
-            close(m_fd);
-            m_fd = -1;
-            return;
+    while ((n = canal.consumir(eventos, 64)) > 0) {
+        for (size_t k = 0; k < n; k++) {
+            teclas[k] = eventos[k].tecla;
         }
+        teclado.eventoUsuarioDigitou(teclas, n);
+    }
+}
 
-        // 3. Mapeia o arquivo para a memória
-        m_map_ptr = (char*)mmap(0, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
-        if (m_map_ptr == MAP_FAILED) {
-            _log("ERRO: Falha ao mapear o arquivo para a memória com mmap.");
-            close(m_fd);
-            m_fd = -1;
-            m_map_ptr = nullptr;
-            return;
-        }
-        
-        // Limpa o conteúdo inicial do buffer de memória (frame em branco)
-        memset(m_map_ptr, ' ', m_size);
-        _log("Mmap bem-sucedido. Framebuffer pronto.");
+/**
+ * @brief Gravando o trace (--gravar-entrada): as teclas param aqui e a
+ * 'main' as entrega ao teclado na fronteira de um tick, anotando qual.
+ * Assim o trace diz exatamente em que tick cada tecla entrou.
+ */
+class EntradaPendente {
+public:
+    void eventoUsuarioDigitou(const std::string& texto) {
+        eventoUsuarioDigitou(texto.data(), texto.size());
     }
 
-    ~MmapFrameBuffer() override {
-        if (m_map_ptr != nullptr) {
-            munmap(m_map_ptr, m_size);
-        }
-        if (m_fd != -1) {
-            close(m_fd);
-        }
+    void eventoUsuarioDigitou(const char* teclas, size_t quantidade) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_teclas.insert(m_teclas.end(), teclas, teclas + quantidade);
     }
 
-    void limpar() override {
-        // Limpar o buffer de memória com espaços
-        if (m_map_ptr != nullptr) {
-            memset(m_map_ptr, ' ', m_size);
-            // msync para garantir a escrita imediata (opcional, mas bom para IPC)
-            msync(m_map_ptr, m_size, MS_SYNC);
-        }
+    bool temTeclas() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_teclas.empty();
     }
 
-    void atualizar(const std::string& conteudo) override {
-        if (m_map_ptr == nullptr || conteudo.empty()) {
-            return;
-        }
-        
-        // 1. Copia o conteúdo da string (o frame) para a memória mapeada
-        size_t bytesToCopy = std::min(conteudo.size(), m_size);
-        memcpy(m_map_ptr, conteudo.data(), bytesToCopy);
-        
-        // 2. Garante a sincronização imediata com o disco (opcional)
-        msync(m_map_ptr, m_size, MS_SYNC);
+    /**
+     * @brief Move as teclas pendentes para 'destino' (que é sobrescrito).
+     */
+    void retirar(std::vector<char>& destino) {
+        destino.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        destino.swap(m_teclas);
     }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<char> m_teclas;
 };
 
+// Zerado pelo SIGINT/SIGTERM: o loop principal termina e tudo é drenado/fechado.
+// Atômico (sem lock, seguro em handler de sinal): a thread de input também lê
+static std::atomic<bool> g_executando{true};
 
-/**
- * @brief Função que a 'main' usa para fazer o papel do "socket".
- * Ela lê o arquivo de input, envia para o teclado e limpa o arquivo.
- */
-void pollerDeInput(HardwareTeclado& teclado) {
-    std::ifstream in(ARQUIVO_INPUT);
-    if (!in.is_open()) return;
+static void tratarSinalDeParada(int) {
+    g_executando.store(false, std::memory_order_relaxed);
+}
 
-    std::string input;
-    // Lê a primeira linha de input
-    std::getline(in, input); 
-    in.close();
+// SIGUSR1: a 'main' exporta o rastreio (--rastreio) sem parar a simulação
+static std::atomic<bool> g_exportarRastreio{false};
 
-    if (!input.empty()) {
-        // Envia o input para o hardware do teclado
-        teclado.eventoUsuarioDigitou(input);
-        
-        // Limpa o arquivo de input (truncando)
-        std::ofstream out(ARQUIVO_INPUT, std::ios::trunc);
-        out.close();
-    }
+static void tratarSinalDeRastreio(int) {
+    g_exportarRastreio.store(true, std::memory_order_relaxed);
 }
 
-int main() {
-    // --- 0. CORREÇÃO: Criação inicial do arquivo de input ---
+int main(int argc, char* argv[]) {
+    // --bench: roda a suíte de benchmarks e sai (ver bench/SuiteBench.h)
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--bench") {
+            return executarSuiteBench(argc, argv);
+        }
+    }
+
+    // --- 0. Argumentos ---
+    // --entrada=arquivo  : usa o sim_input.txt (modo legado) em vez do canal shm
+    // --sem-persistencia : não grava o texto do frame em sim_frame.txt
+    // --threads-render=N : divide cada frame do donut em N threads
+    // --modo=headless    : roda os ticks sem esperar (lote/benchmark)
+    // --hz=N             : frequência do passo fixo no modo ritmado (padrão 30)
+    // --atraso=pular     : descarta os ticks atrasados em vez de recuperá-los
+    // --ticks=N          : encerra sozinho depois de N ticks (0 = sem limite)
+    // --processos=N      : roda N donuts (o PID 0 tem teclado e tela; os outros, tela nula)
+    // --escalonador=ponderado : fatias proporcionais ao peso (PID 0 tem peso 4)
+    // --quantum=N        : IRQs de timer por fatia (padrão 1)
+    // --pit=N            : uma IRQ de timer a cada N ticks (padrão 10)
+    // --nucleos=N        : modo SMP, N CPUs em threads próprias (--ticks=N vale por núcleo)
+    // --fifo=N           : FIFO do teclado com IRQ a cada N teclas (padrão 8; 0 = uma IRQ por tecla)
+    // --fifo-timeout=MS  : IRQ também quando a FIFO fica MS parada com teclas retidas (padrão 2)
+    // --gravar=ARQUIVO   : grava todos os frames (comprimidos) para o ./player
+    // --gravar-entrada=ARQUIVO     : grava as teclas (com o tick de cada uma) e o checksum dos frames
+    // --reproduzir-entrada=ARQUIVO : repete um trace em modo headless e confere os checksums
+    // --rastreio=ARQUIVO : spans por thread, exportados em JSON do Chrome ao sair (e no SIGUSR1)
+    // --sem-metricas     : não cria a página de métricas (sim_metricas.shm, lida pelo ./simtop)
+    // --resolucao=LxA    : tamanho do display em caracteres (padrão 80x24; ex: 400x200)
+    // --cor              : frames com cor (truecolor) em sim_frame.shm; o resto continua em texto
+    bool entradaPorArquivo = false;
+    bool persistirFrame = true;
+    int threadsRender = 1;
+    RelogioSimulacao::Modo modoRelogio = RelogioSimulacao::Modo::Ritmado;
+    RelogioSimulacao::PoliticaAtraso politicaAtraso = RelogioSimulacao::PoliticaAtraso::Recuperar;
+    int hz = 30;
+    uint64_t limiteTicks = 0;
+    int numProcessos = 1;
+    Escalonador::Politica politicaEscalonador = Escalonador::Politica::RoundRobin;
+    int quantum = 1;
+    int divisorPIT = 10;
+    int numNucleos = 1;
+    int limiarFIFO = 8;
+    int timeoutFIFOMs = 2;
+    std::string arquivoGravacao;
+    std::string arquivoGravarEntrada;
+    std::string arquivoReproduzirEntrada;
+    std::string arquivoRastreio;
+    bool metricasLigadas = true;
+    int largura = LARGURA_PADRAO_DONUT;
+    int altura = ALTURA_PADRAO_DONUT;
+    bool corLigada = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--entrada=arquivo") {
+            entradaPorArquivo = true;
+        } else if (arg == "--sem-persistencia") {
+            persistirFrame = false;
+        } else if (arg.rfind("--threads-render=", 0) == 0) {
+            threadsRender = std::atoi(arg.c_str() + 17);
+        } else if (arg == "--modo=headless") {
+            modoRelogio = RelogioSimulacao::Modo::Livre;
+        } else if (arg.rfind("--hz=", 0) == 0 && std::atoi(arg.c_str() + 5) > 0) {
+            hz = std::atoi(arg.c_str() + 5);
+        } else if (arg == "--atraso=pular") {
+            politicaAtraso = RelogioSimulacao::PoliticaAtraso::PularQuadros;
+        } else if (arg.rfind("--ticks=", 0) == 0) {
+            limiteTicks = std::strtoull(arg.c_str() + 8, nullptr, 10);
+        } else if (arg.rfind("--processos=", 0) == 0 && std::atoi(arg.c_str() + 12) > 0) {
+            numProcessos = std::atoi(arg.c_str() + 12);
+        } else if (arg == "--escalonador=ponderado") {
+            politicaEscalonador = Escalonador::Politica::Ponderado;
+        } else if (arg.rfind("--quantum=", 0) == 0 && std::atoi(arg.c_str() + 10) > 0) {
+            quantum = std::atoi(arg.c_str() + 10);
+        } else if (arg.rfind("--pit=", 0) == 0 && std::atoi(arg.c_str() + 6) > 1) {
+            divisorPIT = std::atoi(arg.c_str() + 6);
+        } else if (arg.rfind("--nucleos=", 0) == 0 && std::atoi(arg.c_str() + 10) > 0) {
+            numNucleos = std::atoi(arg.c_str() + 10);
+        } else if (arg.rfind("--fifo=", 0) == 0 && std::atoi(arg.c_str() + 7) >= 0) {
+            limiarFIFO = std::atoi(arg.c_str() + 7);
+        } else if (arg.rfind("--fifo-timeout=", 0) == 0 && std::atoi(arg.c_str() + 15) >= 0) {
+            timeoutFIFOMs = std::atoi(arg.c_str() + 15);
+        } else if (arg.rfind("--gravar=", 0) == 0 && arg.size() > 9) {
+            arquivoGravacao = arg.substr(9);
+        } else if (arg.rfind("--gravar-entrada=", 0) == 0 && arg.size() > 17) {
+            arquivoGravarEntrada = arg.substr(17);
+        } else if (arg.rfind("--reproduzir-entrada=", 0) == 0 && arg.size() > 21) {
+            arquivoReproduzirEntrada = arg.substr(21);
+        } else if (arg.rfind("--rastreio=", 0) == 0 && arg.size() > 11) {
+            arquivoRastreio = arg.substr(11);
+        } else if (arg == "--sem-metricas") {
+            metricasLigadas = false;
+        } else if (arg.rfind("--resolucao=", 0) == 0) {
+            int l = 0, a = 0;
+            if (std::sscanf(arg.c_str() + 12, "%dx%d", &l, &a) != 2 || l < 2 || a < 2
+                || l > LIMITE_RESOLUCAO || a > LIMITE_RESOLUCAO) {
+                std::cerr << "Erro: --resolucao espera LxA (ex: 400x200), de 2 a " << LIMITE_RESOLUCAO << " por eixo." << std::endl;
+                return 1;
+            }
+            largura = l;
+            altura = a;
+        } else if (arg == "--cor") {
+            corLigada = true;
+        } else if (arg != "--entrada=shm" && arg != "--modo=ritmado" && arg != "--atraso=recuperar"
+                   && arg != "--escalonador=rr") {
+            std::cerr << "Argumento desconhecido: " << arg << std::endl;
+            std::cerr << "Uso: " << argv[0] << " [--entrada=shm|arquivo] [--sem-persistencia] [--threads-render=N]"
+                      << " [--modo=ritmado|headless] [--hz=N] [--atraso=recuperar|pular] [--ticks=N]"
+                      << " [--processos=N] [--escalonador=rr|ponderado] [--quantum=N] [--pit=N] [--nucleos=N]"
+                      << " [--fifo=N] [--fifo-timeout=MS] [--gravar=ARQUIVO]"
+                      << " [--gravar-entrada=ARQUIVO | --reproduzir-entrada=ARQUIVO] [--rastreio=ARQUIVO]"
+                      << " [--sem-metricas] [--resolucao=LxA] [--cor] | --bench [opções]" << std::endl;
+            return 1;
+        }
+    }
+
+    // O trace conta ticks de uma única CPU: no SMP a ordem entre núcleos não se repete
+    const bool gravandoEntrada = !arquivoGravarEntrada.empty();
+    const bool reproduzindoEntrada = !arquivoReproduzirEntrada.empty();
+    if ((gravandoEntrada || reproduzindoEntrada) && numNucleos > 1) {
+        std::cerr << "Erro: --gravar-entrada/--reproduzir-entrada só funcionam com --nucleos=1." << std::endl;
+        return 1;
+    }
+    if (gravandoEntrada && reproduzindoEntrada) {
+        std::cerr << "Erro: use --gravar-entrada ou --reproduzir-entrada, não os dois." << std::endl;
+        return 1;
+    }
+    // Tudo o que muda o que acontece em cada tick (o hz dá o tempo simulado por tick)
+    const std::string configuracaoTrace = "fifo=" + std::to_string(limiarFIFO) + " fifo-timeout=" + std::to_string(timeoutFIFOMs)
+        + " processos=" + std::to_string(numProcessos)
+        + " escalonador=" + (politicaEscalonador == Escalonador::Politica::Ponderado ? "ponderado" : "rr")
+        + " quantum=" + std::to_string(quantum) + " pit=" + std::to_string(divisorPIT) + " hz=" + std::to_string(hz)
+        + (largura != LARGURA_PADRAO_DONUT || altura != ALTURA_PADRAO_DONUT
+               ? " resolucao=" + std::to_string(largura) + "x" + std::to_string(altura) : std::string());
+    std::unique_ptr<LeitorTrace> leitorTrace;
+    if (reproduzindoEntrada) {
+        leitorTrace.reset(new LeitorTrace(arquivoReproduzirEntrada));
+        if (!leitorTrace->valido()) {
+            std::cerr << "Erro: " << arquivoReproduzirEntrada << " não é um trace de entrada (versão " << VERSAO_TRACE_ENTRADA << ")." << std::endl;
+            return 1;
+        }
+        if (leitorTrace->configuracao() != configuracaoTrace) {
+            std::cerr << "Aviso: trace gravado com '" << leitorTrace->configuracao() << "', reproduzindo com '"
+                      << configuracaoTrace << "'. Espere divergências." << std::endl;
+        }
+        // Sem tempo real: os ticks rodam o mais rápido possível
+        modoRelogio = RelogioSimulacao::Modo::Livre;
+        if (limiteTicks == 0) {
+            limiteTicks = leitorTrace->totalTicks();
+        }
+    }
+
+    // --- 0b. CORREÇÃO: Criação inicial do arquivo de input ---
     // Isso garante que 'sim_input.txt' exista no sistema de arquivos,
     // corrigindo o bug onde o poller não conseguiria abri-lo.
-    std::ofstream inputInit(ARQUIVO_INPUT, std::ios::out | std::ios::app);
-    inputInit.close();
+    if (entradaPorArquivo) {
+        std::ofstream inputInit(ARQUIVO_INPUT, std::ios::out | std::ios::app);
+        inputInit.close();
+    }
 
     // --- 1. Redirecionar Logs ---
-    // Todo std::cout será escrito em 'sim_logs.txt'
+    // Os componentes usam o Logger binário (sim_logs.bin, lido com ./logdecoder).
+    // O std::cout que sobrar ainda vai para 'sim_logs.txt'.
     std::ofstream logStream(ARQUIVO_LOGS);
     std::streambuf* coutBuf = std::cout.rdbuf(); // Salva o buffer original
     std::cout.rdbuf(logStream.rdbuf()); // Redireciona
 
-    std::cout << "--- SIMULADOR INICIADO (MMAP) ---" << std::endl;
+    if (!Logger::iniciar(ARQUIVO_LOGS_BIN)) {
+        std::cerr << "Erro: Não foi possível criar " << ARQUIVO_LOGS_BIN << std::endl;
+    }
+    std::signal(SIGINT, tratarSinalDeParada);
+    std::signal(SIGTERM, tratarSinalDeParada);
+    if (!arquivoRastreio.empty()) {
+        // Antes de criar as threads: cada uma já nasce rastreando
+        Rastreador::iniciar();
+        Rastreador::nomearThread("main");
+        std::signal(SIGUSR1, tratarSinalDeRastreio);
+    }
+
+    SIM_LOG(LOG_INFO, "MAIN", "--- SIMULADOR INICIADO (MMAP) ---");
 
     // --- 2. Criar Serviços, Hardware e Aplicação ---
     BufferDeEntradaOS bufferDeEntrada;
-    // NOVO: Usando a implementação MMAP
-    MmapFrameBuffer tela(ARQUIVO_FRAME); 
-    
+    // O simulador é o dono do canal: cria e zera o anel compartilhado
+    CanalEntradaShm canalEntrada(ARQUIVO_CANAL_INPUT, true);
+    if (!entradaPorArquivo && !canalEntrada.valido()) {
+        SIM_LOG(LOG_AVISO, "MAIN", "Canal shm indisponível. Usando o modo arquivo.");
+        entradaPorArquivo = true;
+    }
+    // NOVO: Usando a implementação MMAP (sim_frame.shm).
+    // O sim_frame.txt vira uma cópia assíncrona, para quem usa 'watch cat'.
+    // Com --cor os slots levam células (glifo + cores); o sim_frame.txt segue em texto.
+    MmapFrameBuffer tela(ARQUIVO_FRAME_SHM, largura, altura, persistirFrame ? ARQUIVO_FRAME : "",
+                         corLigada ? FORMATO_FRAME_CELULAS : FORMATO_FRAME_TEXTO);
+
     HardwareTeclado teclado;
-    ControladorPIC pic;
-    CPU cpu(pic);
-    
-    AppDonut appDonut;
+    teclado.configurarFIFO((size_t)limiarFIFO, (unsigned)timeoutFIFOMs);
+    AppDonut appDonut(threadsRender, largura, altura);
+    appDonut.usarCores(corLigada);
 
-    // --- 3. Fazer a "Fiação" (SOLID) ---
-    pic.registrarDispositivo(1, &teclado);
+    // Processos em segundo plano: cada um com a sua fila de teclas (vazia)
+    FrameBufferNulo telaNula;
+    std::vector<std::unique_ptr<BufferDeEntradaOS>> entradasFundo;
+    std::vector<std::unique_ptr<AppDonut>> appsFundo;
+    for (int pid = 1; pid < numProcessos; pid++) {
+        entradasFundo.emplace_back(new BufferDeEntradaOS());
+        appsFundo.emplace_back(new AppDonut(1, largura, altura));
+        appsFundo.back()->conectar(entradasFundo.back().get(), &telaNula);
+    }
+    // --gravar: a tela recebe os frames e o gravador também
+    std::unique_ptr<GravadorFrameBuffer> gravador;
+    std::unique_ptr<FrameBufferDuplo> telaGravada;
+    if (!arquivoGravacao.empty()) {
+        gravador.reset(new GravadorFrameBuffer(arquivoGravacao, largura, altura));
+        telaGravada.reset(new FrameBufferDuplo(tela, *gravador));
+    }
+    IFrameBuffer *telaDonut = telaGravada ? static_cast<IFrameBuffer *>(telaGravada.get()) : &tela;
+    // Trace de entrada: o checksum do frame do donut é conferido tick a tick
+    std::unique_ptr<FrameBufferChecksum> telaChecksum;
+    std::unique_ptr<GravadorTrace> gravadorTrace;
+    if (gravandoEntrada || reproduzindoEntrada) {
+        telaChecksum.reset(new FrameBufferChecksum(*telaDonut));
+        telaDonut = telaChecksum.get();
+        teclado.usarTempoSimulado(); // O timeout da FIFO passa a contar ticks
+    }
+    if (gravandoEntrada) {
+        gravadorTrace.reset(new GravadorTrace(arquivoGravarEntrada, configuracaoTrace));
+        if (!gravadorTrace->valido()) {
+            std::cerr << "Erro: Não foi possível criar " << arquivoGravarEntrada << std::endl;
+            return 1;
+        }
+    }
+    appDonut.conectar(&bufferDeEntrada, telaDonut);
+    const uint32_t pesoDonut = politicaEscalonador == Escalonador::Politica::Ponderado ? 4 : 1;
 
-    cpu.registrarISR(1, [&teclado, &bufferDeEntrada]() {
+    // O ISR é uma variável local: a IDT só guarda o endereço dele
+    const bool modoFIFO = limiarFIFO > 0;
+    auto isrTeclado = [&teclado, &bufferDeEntrada, modoFIFO]() {
+        if (modoFIFO) {
+            // Uma IRQ esvazia a FIFO inteira (leitura em rajada)
+            char teclas[256];
+            size_t n = teclado.lerFIFO(teclas, sizeof(teclas));
+            for (size_t k = 0; k < n; k++) {
+                bufferDeEntrada.enfileirarTecla(teclas[k]);
+            }
+            return;
+        }
         char c = (char)teclado.lerDados();
         bufferDeEntrada.enfileirarTecla(c);
         teclado.eventoCPULeuDados();
-    });
+    };
 
-    appDonut.conectar(&bufferDeEntrada, &tela);
-    cpu.carregarAplicacao(&appDonut);
+    // Fazer o papel do "socket" numa thread própria, como o mundo lá fora:
+    // a tecla sobe a IRQ do teclado, e o PIC acorda a CPU se ela estiver em HLT
+    // (Gravando o trace, as teclas esperam a fronteira do tick na EntradaPendente
+    // e o timeout da FIFO anda com os ticks, não aqui.)
+    std::atomic<bool> encerrarInput{false};
+    EntradaPendente entradaPendente;
+    // Métricas de entrada: amostradas a cada volta da thread de input (até 10x/s)
+    auto amostrarEntrada = [&teclado, &bufferDeEntrada]() {
+        if (!Metricas::ativo()) {
+            return;
+        }
+        AmostraEntrada amostra;
+        amostra.tecladoRetidas = teclado.lerNivelFIFO();
+        amostra.tecladoEntregues = teclado.estatisticasEntrega().teclasEntregues;
+        amostra.tecladoDescartadas = teclado.totalTeclasDescartadas();
+        amostra.entradaOSPendentes = bufferDeEntrada.pendentes();
+        amostra.entradaOSEnfileiradas = bufferDeEntrada.totalEnfileiradas();
+        amostra.entradaOSDescartadas = bufferDeEntrada.totalDescartadas();
+        Metricas::publicarEntrada(amostra);
+    };
+    auto loopInput = [&]() {
+        if (Rastreador::ativo()) {
+            Rastreador::nomearThread("input");
+        }
+        while (g_executando && !encerrarInput.load(std::memory_order_relaxed)) {
+            int esperaMs = entradaPorArquivo ? 33 : 100;
+            {
+                // O span cobre a leitura, não a espera abaixo
+                SIM_SPAN("entrada", "pollerDeInput");
+                amostrarEntrada();
+                if (gravandoEntrada) {
+                    if (entradaPorArquivo) {
+                        pollerDeInput(entradaPendente);
+                    } else {
+                        pollerDeInput(canalEntrada, entradaPendente);
+                    }
+                } else {
+                    if (entradaPorArquivo) {
+                        pollerDeInput(teclado);
+                    } else {
+                        pollerDeInput(canalEntrada, teclado);
+                    }
+                    teclado.verificarTimeout();
 
-    std::cout << "Sistema montado. Iniciando loop principal..." << std::endl;
+                    // Com teclas retidas na FIFO, acorda a tempo de vencer o timeout dela
+                    int timeoutFIFO = teclado.msAteTimeout();
+                    if (timeoutFIFO >= 0 && timeoutFIFO < esperaMs) {
+                        esperaMs = timeoutFIFO;
+                    }
+                }
+            }
+            if (entradaPorArquivo) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(esperaMs));
+            } else {
+                canalEntrada.aguardarEventos(esperaMs); // Futex do canal: dorme até o listener publicar
+            }
+        }
+    };
 
-    // --- 4. Loop Principal (Infinito) ---
-    // Este é o "clock" do nosso sistema
-    while (true) {
-        // 4a. Fazer o papel do "socket" (ler arquivo de input)
-        pollerDeInput(teclado);
-        
-        // 4b. Executar um tick da CPU (que roda a AppDonut)
-        cpu.tick();
+    auto relatarTeclado = [&teclado](std::ostream &saida) {
+        HardwareTeclado::EstatisticasEntrega e = teclado.estatisticasEntrega();
+        saida << std::fixed << std::setprecision(1) << "[TECLADO] modo=" << (teclado.fifoAtivo() ? "fifo" : "byte")
+              << " irqs_atendidas=" << e.leituras << " teclas=" << e.teclasEntregues;
+        if (e.leituras > 0) {
+            saida << " teclas_por_irq=" << (double)e.teclasEntregues / (double)e.leituras
+                  << " latencia_media=" << e.latenciaTotalNs / e.teclasEntregues / 1e3 << "us"
+                  << " latencia_max=" << e.latenciaMaximaNs / 1e3 << "us";
+        }
+        if (teclado.fifoAtivo()) {
+            saida << " disparos_limiar=" << e.disparosPorLimiar << " disparos_timeout=" << e.disparosPorTimeout;
+        }
+        saida << " descartadas=" << teclado.totalTeclasDescartadas() << "\n";
+    };
 
-        // NOVO: Flush forçado do log. Garante que os logs sejam escritos
-        // no arquivo imediatamente para que o servidor WebSocket os leia.
-        logStream.flush(); 
+    auto relatarGravacao = [&gravador](std::ostream &saida) {
+        if (!gravador) {
+            return;
+        }
+        gravador->fechar();
+        const GravadorFrameBuffer::Estatisticas &e = gravador->estatisticas();
+        saida << "[GRAVADOR] frames=" << e.frames << " keyframes=" << e.keyframes
+              << " bytes_brutos=" << e.bytesBrutos << " bytes_gravados=" << e.bytesGravados;
+        if (e.bytesGravados > 0) {
+            saida << " compressao=" << (double)e.bytesBrutos / (double)e.bytesGravados << "x";
+        }
+        saida << "\n";
+    };
+
+    auto relatarTrace = [&gravadorTrace](std::ostream &saida, uint64_t totalTicks) {
+        if (!gravadorTrace) {
+            return;
+        }
+        gravadorTrace->fechar(totalTicks);
+        saida << "[TRACE] ticks=" << totalTicks << " eventos=" << gravadorTrace->totalEventos()
+              << " bytes=" << gravadorTrace->bytesGravados() << "\n";
+    };
 
-        // 4c. Simular a velocidade do clock (ex: 30 ticks por segundo)
-        std::this_thread::sleep_for(std::chrono::milliseconds(33));
+    // Exporta o rastreio (ao sair ou no SIGUSR1); a simulação segue gravando
+    auto exportarRastreio = [&arquivoRastreio](std::ostream &saida) {
+        if (arquivoRastreio.empty()) {
+            return;
+        }
+        bool ok = Rastreador::exportarChrome(arquivoRastreio);
+        Rastreador::Estatisticas e = Rastreador::estatisticas();
+        saida << "[RASTREIO] spans=" << e.spans << " sobrescritos=" << e.sobrescritos << " threads=" << e.threads
+              << " arquivo=" << arquivoRastreio << (ok ? "" : " (ERRO ao gravar)") << "\n";
+    };
+
+    const uint64_t periodoNs = 1000000000ull / (uint64_t)hz;
+    if (metricasLigadas) {
+        const uint64_t periodoAlvoNs = modoRelogio == RelogioSimulacao::Modo::Ritmado ? periodoNs : 0;
+        if (!Metricas::iniciar(ARQUIVO_METRICAS, periodoAlvoNs, (uint32_t)numNucleos)) {
+            std::cerr << "Aviso: Não foi possível criar " << ARQUIVO_METRICAS << " (sem métricas ao vivo)." << std::endl;
+        }
+    }
+
+    if (numNucleos > 1) {
+        // --- 3/4 (SMP). N núcleos, cada um na sua thread e com o seu relógio ---
+        EscalonadorSMP kernelSMP(numNucleos, politicaEscalonador, (uint32_t)quantum);
+        kernelSMP.adicionarProcesso(&appDonut, "donut", pesoDonut);
+        for (size_t k = 0; k < appsFundo.size(); k++) {
+            kernelSMP.adicionarProcesso(appsFundo[k].get(), "donut-fundo-" + std::to_string(k + 1), 1);
+        }
+
+        MaquinaSMP maquina(numNucleos, kernelSMP, (uint32_t)divisorPIT);
+
+        // O teclado é entregue sempre ao núcleo 0. O donut pode estar em
+        // HLT em outro núcleo: a IPI o acorda para consumir a tecla
+        maquina.distribuidor().registrarDispositivo(1, &teclado);
+        maquina.distribuidor().definirAfinidade(1, 1ull << 0);
+        auto isrTecladoSMP = [&isrTeclado, &maquina]() {
+            isrTeclado();
+            maquina.acordarNucleosOciosos();
+        };
+        maquina.registrarISR(1, isrTecladoSMP);
+
+        SIM_LOG(LOG_INFO, "MAIN", "Sistema SMP montado ({} núcleos). Iniciando...", numNucleos);
+        maquina.iniciar(modoRelogio, periodoNs, politicaAtraso, limiteTicks);
+        std::thread threadInput(loopInput);
+        while (g_executando && maquina.executando()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (g_exportarRastreio.exchange(false, std::memory_order_relaxed)) {
+                exportarRastreio(std::cerr);
+            }
+        }
+        maquina.parar();
+        encerrarInput.store(true, std::memory_order_relaxed);
+        threadInput.join();
+
+        SIM_LOG(LOG_INFO, "MAIN", "Encerrando depois de {} ticks...", maquina.totalTicks());
+        maquina.relatar(std::cerr);
+        kernelSMP.relatar(std::cerr);
+        relatarTeclado(std::cerr);
+        relatarGravacao(std::cerr);
+        amostrarEntrada();
+        Metricas::encerrar();
+        Rastreador::encerrar();
+        exportarRastreio(std::cerr);
+        Logger::encerrar();
+        std::cout.rdbuf(coutBuf); // Restaura o stdout
+        return 0;
+    }
+
+    TimerPIT pit;
+    Escalonador escalonador(politicaEscalonador, (uint32_t)quantum);
+
+    // --- 3. Fazer a "Fiação" ---
+    // Com um núcleo a máquina é fixa: a placa é montada na compilação (PIT
+    // na IRQ 0, teclado na IRQ 1) e a CPU roda o kernel, que reparte a CPU
+    // entre os processos. O tick não passa por nenhuma vtable.
+    PlacaEstatica<ControladorPIC, Escalonador,
+                  NaLinha<0, TimerPIT, TipoDisparo::Borda>,
+                  NaLinha<1, HardwareTeclado>> placa(escalonador, pit, teclado);
+    ControladorPIC &pic = placa.controlador();
+    auto &cpu = placa.cpu();
+    pit.programar((uint32_t)divisorPIT);
+
+    // IRQ 0: a "batida" do timer entrega a preempção ao escalonador
+    auto isrTimer = [&escalonador]() {
+        escalonador.interrupcaoTimer();
+    };
+    cpu.registrarISR(0, isrTimer);
+    cpu.registrarISR(1, isrTeclado);
+
+    escalonador.adicionarProcesso(&appDonut, "donut", pesoDonut);
+    for (size_t k = 0; k < appsFundo.size(); k++) {
+        escalonador.adicionarProcesso(appsFundo[k].get(), "donut-fundo-" + std::to_string(k + 1), 1);
+    }
+
+    SIM_LOG(LOG_INFO, "MAIN", "Sistema montado. Iniciando loop principal...");
+
+    // --- 4. Loop Principal (até SIGINT/SIGTERM ou --ticks=N) ---
+    // Este é o "clock" do nosso sistema: o relógio decide quando e quantos ticks rodar
+    RelogioSimulacao relogio(modoRelogio, periodoNs, politicaAtraso);
+    // Reproduzindo, o mundo lá fora é o trace: nenhuma tecla de verdade entra
+    std::thread threadInput;
+    if (!reproduzindoEntrada) {
+        threadInput = std::thread(loopInput);
+    }
+    uint64_t ticksExecutados = 0;
+    std::vector<char> teclasDoTick;
+    uint64_t ultimoChecksum = 0;
+    uint64_t divergencias = 0;
+    uint64_t primeiraDivergencia = 0;
+    uint64_t teclasReproduzidas = 0;
+    uint64_t ticksUltimaAmostra = 0;
+    const unsigned periodoMs = (unsigned)((periodoNs + 999999ull) / 1000000ull);
+    while (g_executando && (limiteTicks == 0 || ticksExecutados < limiteTicks)) {
+        // 4a. Esperar o próximo prazo (no modo headless, retorna na hora)
+        uint32_t ticks = relogio.aguardarProximoTick();
+
+        // 4b. Executar o(s) tick(s) da CPU (que roda a AppDonut);
+        // mais de um quando o relógio precisa recuperar atraso
+        for (uint32_t k = 0; k < ticks && (limiteTicks == 0 || ticksExecutados < limiteTicks); k++) {
+            SIM_SPAN("sistema", "tick");
+            // Trace: as teclas entram no teclado só aqui, na fronteira do tick
+            if (gravadorTrace) {
+                entradaPendente.retirar(teclasDoTick);
+                gravadorTrace->registrarTeclas(ticksExecutados, teclasDoTick.data(), teclasDoTick.size());
+            } else if (leitorTrace) {
+                teclasReproduzidas += leitorTrace->teclasDoTick(ticksExecutados, teclasDoTick);
+            }
+            if (!teclasDoTick.empty()) {
+                teclado.eventoUsuarioDigitou(teclasDoTick.data(), teclasDoTick.size());
+                teclasDoTick.clear();
+            }
+
+            placa.tick(); // O oscilador da placa alimenta o timer, e a CPU roda um tick
+
+            if (telaChecksum) {
+                teclado.avancarTempoSimulado(periodoNs);
+                uint64_t checksum = telaChecksum->valor();
+                if (gravadorTrace && (ticksExecutados == 0 || checksum != ultimoChecksum)) {
+                    gravadorTrace->registrarChecksum(ticksExecutados, checksum);
+                } else if (leitorTrace) {
+                    uint64_t esperado;
+                    if (leitorTrace->checksumEsperado(ticksExecutados, esperado) && esperado != checksum) {
+                        if (divergencias == 0) {
+                            primeiraDivergencia = ticksExecutados;
+                            SIM_LOG(LOG_ERRO, "REPLAY", "ERRO: Frame divergiu do trace no tick {}.", ticksExecutados);
+                        }
+                        divergencias++;
+                    }
+                }
+                ultimoChecksum = checksum;
+            }
+            ticksExecutados++;
+        }
+        Metricas::publicarTicks(0, ticksExecutados);
+        // Reproduzindo não há thread de input: a entrada é amostrada aqui
+        if (leitorTrace && ticksExecutados - ticksUltimaAmostra >= 4096) {
+            amostrarEntrada();
+            ticksUltimaAmostra = ticksExecutados;
+        }
+
+        // 4c. HLT: nada a fazer até a próxima IRQ. Sistema "tickless": o PIT
+        // não é alimentado enquanto a CPU dorme, e a grade recomeça ao acordar.
+        // (No modo headless não há tempo real a economizar: segue girando.)
+        if (modoRelogio == RelogioSimulacao::Modo::Ritmado && cpu.estaOciosa()) {
+            if (gravadorTrace) {
+                // As teclas esperam na EntradaPendente (não sobem IRQ): confere a cada
+                // período. Com teclas retidas na FIFO, o timeout precisa dos ticks
+                while (g_executando && teclado.msAteTimeout() < 0 && !entradaPendente.temTeclas()
+                       && !cpu.aguardarInterrupcao(periodoMs)) {
+                }
+            } else {
+                cpu.aguardarInterrupcao(1000);
+            }
+            relogio.reancorar();
+        }
+
+        if (g_exportarRastreio.load(std::memory_order_relaxed)) {
+            g_exportarRastreio.store(false, std::memory_order_relaxed);
+            exportarRastreio(std::cerr);
+        }
+    }
+    encerrarInput.store(true, std::memory_order_relaxed);
+    if (threadInput.joinable()) {
+        threadInput.join();
     }
 
-    // (Nunca vai chegar aqui)
+    SIM_LOG(LOG_INFO, "MAIN", "Encerrando depois de {} ticks...", ticksExecutados);
+    relogio.relatar(std::cerr);
+    escalonador.relatar(std::cerr);
+    const CPU::EstatisticasOcio &ocio = cpu.estatisticasOcio();
+    const ControladorPIC::EstatisticasDespertar &despertar = pic.estatisticasDespertar();
+    std::cerr << std::fixed << std::setprecision(1)
+              << "[HLT] ticks_ociosos=" << ocio.ticksOciosos << " esperas=" << ocio.esperas
+              << " dormindo=" << ocio.tempoDormindoNs / 1e6 << "ms"
+              << " despertares_por_irq=" << despertar.despertares;
+    if (despertar.despertares > 0) {
+        std::cerr << " latencia_media=" << despertar.latenciaTotalNs / despertar.despertares / 1e3 << "us"
+                  << " latencia_max=" << despertar.latenciaMaximaNs / 1e3 << "us";
+    }
+    std::cerr << "\n";
+    relatarTeclado(std::cerr);
+    relatarGravacao(std::cerr);
+    relatarTrace(std::cerr, ticksExecutados);
+    if (leitorTrace) {
+        std::cerr << "[REPLAY] ticks=" << ticksExecutados << "/" << leitorTrace->totalTicks()
+                  << " teclas=" << teclasReproduzidas << " divergencias=" << divergencias;
+        if (divergencias > 0) {
+            std::cerr << " primeira_divergencia=" << primeiraDivergencia;
+        }
+        std::cerr << "\n";
+    }
+    amostrarEntrada();
+    Metricas::encerrar();
+    Rastreador::encerrar();
+    exportarRastreio(std::cerr);
+    Logger::encerrar();
     std::cout.rdbuf(coutBuf); // Restaura o stdout
-    return 0;
+    return divergencias > 0 ? 2 : 0;
 }
@@ -0,0 +1,160 @@
+#include "MaquinaSMP.h"
+
+#include "../log/Logger.h"
+#include "../rastreio/Rastreador.h"
+#include "../metricas/Metricas.h"
+
+#include <string>
+
+MaquinaSMP::MaquinaSMP(int numNucleos, EscalonadorSMP &kernel, uint32_t divisorTimer)
+    : m_kernel(kernel)
+{
+    if (numNucleos < 1)
+        numNucleos = 1;
+    if (numNucleos > DistribuidorAPIC::MAX_NUCLEOS)
+        numNucleos = DistribuidorAPIC::MAX_NUCLEOS;
+
+    m_contextosTimer.resize(numNucleos);
+    for (int k = 0; k < numNucleos; k++)
+    {
+        m_nucleos.emplace_back(new Nucleo());
+        Nucleo &nucleo = *m_nucleos[k];
+
+        m_distribuidor.conectarNucleo(&nucleo.pic);
+
+        // Timer local na IRQ 0 do PIC do próprio núcleo (não passa pelo distribuidor)
+        nucleo.pic.registrarDispositivo(0, &nucleo.timer, TipoDisparo::Borda);
+        nucleo.timer.programar(divisorTimer);
+        m_contextosTimer[k].maquina = this;
+        m_contextosTimer[k].nucleo = k;
+        nucleo.cpu.registrarISR(0, &MaquinaSMP::_isrTimer, &m_contextosTimer[k]);
+        nucleo.pic.configurarDisparo(LINHA_IPI, TipoDisparo::Borda);
+        nucleo.cpu.registrarISR(LINHA_IPI, &MaquinaSMP::_isrIPI, nullptr);
+
+        nucleo.cpu.carregarAplicacao(m_kernel.nucleo(k < m_kernel.numNucleos() ? k : 0));
+    }
+    SIM_LOG(LOG_INFO, "SMP", "Máquina SMP montada com {} núcleos.", numNucleos);
+}
+
+MaquinaSMP::~MaquinaSMP()
+{
+    parar();
+}
+
+void MaquinaSMP::_isrTimer(void *contexto)
+{
+    ContextoTimer *c = static_cast<ContextoTimer *>(contexto);
+    c->maquina->m_kernel.interrupcaoTimer(c->nucleo);
+}
+
+void MaquinaSMP::_isrIPI(void *)
+{
+    // Nada a fazer: acordar o núcleo já é o serviço
+}
+
+void MaquinaSMP::acordarNucleosOciosos()
+{
+    for (auto &nucleo : m_nucleos)
+    {
+        if (nucleo->cpu.estaOciosa())
+        {
+            nucleo->pic.elevarLinha(LINHA_IPI);
+            nucleo->pic.abaixarLinha(LINHA_IPI);
+        }
+    }
+}
+
+void MaquinaSMP::iniciar(RelogioSimulacao::Modo modo, uint64_t periodoNs, RelogioSimulacao::PoliticaAtraso politica,
+                         uint64_t limiteTicksPorNucleo)
+{
+    m_parar.store(false, std::memory_order_relaxed);
+    m_nucleosAtivos.store(numNucleos(), std::memory_order_release);
+    for (int k = 0; k < numNucleos(); k++)
+    {
+        m_nucleos[k]->thread = std::thread(&MaquinaSMP::_loopNucleo, this, k, modo, periodoNs, politica, limiteTicksPorNucleo);
+    }
+}
+
+void MaquinaSMP::parar()
+{
+    m_parar.store(true, std::memory_order_relaxed);
+    aguardar();
+}
+
+void MaquinaSMP::aguardar()
+{
+    for (auto &nucleo : m_nucleos)
+    {
+        if (nucleo->thread.joinable())
+            nucleo->thread.join();
+    }
+}
+
+void MaquinaSMP::_loopNucleo(int k, RelogioSimulacao::Modo modo, uint64_t periodoNs,
+                             RelogioSimulacao::PoliticaAtraso politica, uint64_t limiteTicks)
+{
+    Nucleo &nucleo = *m_nucleos[k];
+    RelogioSimulacao relogio(modo, periodoNs, politica);
+    uint64_t ticks = 0;
+
+    SIM_LOG(LOG_INFO, "SMP", "Núcleo {} rodando.", k);
+    if (Rastreador::ativo())
+        Rastreador::nomearThread("cpu " + std::to_string(k));
+    while (!m_parar.load(std::memory_order_relaxed) && (limiteTicks == 0 || ticks < limiteTicks))
+    {
+        uint32_t n = relogio.aguardarProximoTick();
+        if (m_gancho != nullptr)
+            m_gancho(m_contextoGancho, k);
+
+        for (uint32_t t = 0; t < n && (limiteTicks == 0 || ticks < limiteTicks); t++)
+        {
+            SIM_SPAN("sistema", "tick");
+            nucleo.timer.eventoClock();
+            nucleo.cpu.tick();
+            ticks++;
+        }
+        nucleo.ticks.store(ticks, std::memory_order_relaxed);
+        Metricas::publicarTicks((uint32_t)k, ticks);
+
+        // HLT: sem IRQ nem trabalho, dorme no PIC local em vez de girar
+        // (no modo livre/headless não há tempo real a economizar)
+        if (modo == RelogioSimulacao::Modo::Ritmado && nucleo.cpu.estaOciosa())
+        {
+            nucleo.cpu.aguardarInterrupcao(TIMEOUT_OCIOSO_MS);
+            relogio.reancorar();
+        }
+    }
+
+    nucleo.relogio = relogio.estatisticas();
+    m_nucleosAtivos.fetch_sub(1, std::memory_order_acq_rel);
+    SIM_LOG(LOG_INFO, "SMP", "Núcleo {} parado depois de {} ticks.", k, ticks);
+}
+
+uint64_t MaquinaSMP::totalTicks() const
+{
+    uint64_t total = 0;
+    for (auto &nucleo : m_nucleos)
+        total += nucleo->ticks.load(std::memory_order_relaxed);
+    return total;
+}
+
+void MaquinaSMP::relatar(std::ostream &saida) const
+{
+    saida << "[SMP] nucleos=" << m_nucleos.size() << " ticks=" << totalTicks() << "\n";
+    for (size_t k = 0; k < m_nucleos.size(); k++)
+    {
+        const Nucleo &nucleo = *m_nucleos[k];
+        saida << "[SMP] nucleo " << k << ": ticks=" << nucleo.ticks.load(std::memory_order_relaxed)
+              << " irqs_roteadas=" << m_distribuidor.totalEntregues((int)k)
+              << " irqs_timer=" << nucleo.timer.totalDisparos()
+              << " ticks_ociosos=" << nucleo.cpu.estatisticasOcio().ticksOciosos
+              << " dormindo=" << nucleo.cpu.estatisticasOcio().tempoDormindoNs / 1e6 << "ms"
+              << " intervalo_medio=" << nucleo.relogio.intervalo.mediaNs / 1e3 << "us";
+        if (nucleo.relogio.atraso.amostras > 0)
+        {
+            saida << " atraso_medio=" << nucleo.relogio.atraso.mediaNs / 1e3 << "us"
+                  << " atraso_max=" << nucleo.relogio.atraso.maximoNs / 1e3 << "us";
+        }
+        saida << "\n";
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef MAQUINA_SMP_H
+#define MAQUINA_SMP_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "../cpu/cpu.h"
+#include "../pic/ControladorPIC.h"
+#include "../pic/DistribuidorAPIC.h"
+#include "../timer/TimerPIT.h"
+#include "../kernel/EscalonadorSMP.h"
+#include "../relogio/RelogioSimulacao.h"
+
+/**
+ * @class MaquinaSMP
+ * @brief A placa multiprocessada: N núcleos, cada um com a sua CPU,
+ * o seu PIC local (IRQ 0 = timer local) e a sua thread do SO.
+ *
+ * Os dispositivos são ligados no distribuidor() (o "I/O APIC"), que
+ * entrega cada IRQ a um núcleo conforme a afinidade da linha. Cada
+ * núcleo roda a sua parte do EscalonadorSMP, com o seu próprio relógio.
+ */
+class MaquinaSMP
+{
+public:
+    typedef void (*GanchoNucleo)(void *contexto, int nucleo);
+
+    // IPI de "reagendamento": só tira um núcleo ocioso do HLT
+    static const int LINHA_IPI = 2;
+
+    // Núcleo ocioso dorme no máximo isto: trabalho pode aparecer na fila
+    // de outro núcleo (roubo) sem que nenhuma IRQ chegue a ele
+    static const unsigned TIMEOUT_OCIOSO_MS = 50;
+
+    /**
+     * @param divisorTimer Ticks entre IRQs do timer local de cada núcleo.
+     */
+    MaquinaSMP(int numNucleos, EscalonadorSMP &kernel, uint32_t divisorTimer);
+    ~MaquinaSMP();
+
+    MaquinaSMP(const MaquinaSMP &) = delete;
+    MaquinaSMP &operator=(const MaquinaSMP &) = delete;
+
+    int numNucleos() const { return (int)m_nucleos.size(); }
+    DistribuidorAPIC &distribuidor() { return m_distribuidor; }
+    CPU &cpu(int k) { return m_nucleos[k]->cpu; }
+
+    /**
+     * @brief Registra o mesmo ISR na IDT de todos os núcleos (a afinidade
+     * no distribuidor é que decide onde ele roda). Não-dono, como na CPU.
+     */
+    template <typename F>
+    void registrarISR(int linha, F &isr)
+    {
+        for (auto &nucleo : m_nucleos)
+            nucleo->cpu.registrarISR(linha, isr);
+    }
+    template <typename F>
+    void registrarISR(int linha, const F &&isr) = delete;
+
+    /**
+     * @brief Chamado por cada núcleo, na sua thread, a cada despertar
+     * do relógio (antes dos ticks). Ex: o núcleo 0 lê o input.
+     */
+    template <typename F>
+    void definirGancho(F &gancho)
+    {
+        m_gancho = &MaquinaSMP::_trampolimGancho<F>;
+        m_contextoGancho = static_cast<void *>(&gancho);
+    }
+
+    /**
+     * @brief Sobe uma thread por núcleo.
+     * @param limiteTicksPorNucleo 0 = até parar().
+     */
+    void iniciar(RelogioSimulacao::Modo modo, uint64_t periodoNs, RelogioSimulacao::PoliticaAtraso politica,
+                 uint64_t limiteTicksPorNucleo = 0);
+
+    /**
+     * @brief Pede para os núcleos pararem e espera as threads.
+     */
+    void parar();
+
+    /**
+     * @brief Espera os núcleos terminarem sozinhos (limite de ticks).
+     */
+    void aguardar();
+
+    /**
+     * @brief Manda uma IPI para cada núcleo em HLT (ex: o ISR do teclado
+     * acabou de dar trabalho a um processo que roda em outro núcleo).
+     * Um núcleo que perder a IPI acorda pelo TIMEOUT_OCIOSO_MS.
+     */
+    void acordarNucleosOciosos();
+
+    bool executando() const { return m_nucleosAtivos.load(std::memory_order_acquire) > 0; }
+    uint64_t totalTicks() const;
+
+    void relatar(std::ostream &saida) const;
+
+private:
+    struct Nucleo
+    {
+        ControladorPIC pic; // Antes da CPU: a CPU guarda uma referência
+        CPU cpu;
+        TimerPIT timer;
+        std::thread thread;
+        std::atomic<uint64_t> ticks{0};
+        RelogioSimulacao::Estatisticas relogio;
+
+        Nucleo() : cpu(pic) {}
+    };
+
+    EscalonadorSMP &m_kernel;
+    DistribuidorAPIC m_distribuidor;
+    std::vector<std::unique_ptr<Nucleo>> m_nucleos;
+    std::atomic<bool> m_parar{false};
+    std::atomic<int> m_nucleosAtivos{0};
+
+    GanchoNucleo m_gancho = nullptr;
+    void *m_contextoGancho = nullptr;
+
+    // Contexto do ISR do timer local: (máquina, núcleo)
+    struct ContextoTimer
+    {
+        MaquinaSMP *maquina;
+        int nucleo;
+    };
+    std::vector<ContextoTimer> m_contextosTimer;
+
+    static void _isrTimer(void *contexto);
+    static void _isrIPI(void *contexto);
+    void _loopNucleo(int k, RelogioSimulacao::Modo modo, uint64_t periodoNs,
+                     RelogioSimulacao::PoliticaAtraso politica, uint64_t limiteTicks);
+
+    template <typename F>
+    static void _trampolimGancho(void *contexto, int nucleo)
+    {
+        (*static_cast<F *>(contexto))(nucleo);
+    }
+};
+
+#endif // MAQUINA_SMP_H
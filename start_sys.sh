@@ -32,14 +32,17 @@ tmux split-window -v -p 50
 # 6. Envia os comandos para cada painel
 echo "Iniciando processos..."
 
-# Pane 0 (top-left): O 'watch' do framebuffer
-tmux send-keys -t 0 "watch -n 0.1 cat sim_frame.txt" C-m
+# Pane 0 (top-left): O visor do framebuffer (mmap + futex, só as células que mudaram)
+tmux send-keys -t 0 "./visor --estatisticas" C-m
 
 # Pane 1 (side-right): O listener de input
 tmux send-keys -t 1 "./listener" C-m 
 
 # Pane 2 (bottom-left): O 'tail' dos logs
-tmux send-keys -t 2 "tail -f sim_logs.txt" C-m
+tmux send-keys -t 2 "./logdecoder -f sim_logs.bin" C-m
+
+# Janela 2 (Ctrl-b n): as métricas ao vivo (sim_metricas.shm)
+tmux new-window -d -n metricas "./simtop"
 
 # 7. Foca no painel do listener e anexa à sessão
 tmux select-pane -t 1 # <-- CORREÇÃO AQUI (era -t 2)
@@ -1,60 +1,95 @@
 #include "teclado.h"
 
-// Includes necessários para os logs corretos
-#include <iostream>
-#include <string>
-#include <sstream> // Para std::stringstream
-#include <iomanip> // Para std::hex, std::setw, std::setfill
-#include <cstdint> // Para uint8_t
+#include "../log/Logger.h"
+
+#include <chrono>
+
+static inline uint64_t _relogioRealNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
 
 // --- CONSTRUTOR ---
 HardwareTeclado::HardwareTeclado()
-    : m_registroStatus(STATUS_VAZIO),
+    : m_inicioBuffer(0),
+      m_teclasNoBuffer(0),
+      m_teclasDescartadas(0),
+      m_registroStatus(STATUS_VAZIO),
       m_registroDados(0x00),
-      m_sinalIRQAtivo(false)
+      m_sinalIRQAtivo(false),
+      m_chegadaRegistroNs(0),
+      m_limiarFIFO(0),
+      m_timeoutFIFONs(0),
+      m_ultimaAtividadeNs(0),
+      m_timeoutVencido(false),
+      m_tempoSimulado(false),
+      m_tempoSimuladoNs(0),
+      m_controlador(nullptr),
+      m_linhaIRQ(-1)
 {
-    _log("Hardware inicializado. Estado: Ocioso.");
+    SIM_LOG(LOG_INFO, "TECLADO HARDWARE", "Hardware inicializado. Estado: Ocioso.");
 }
 
 // --- 1. EVENTOS DE GATILHO EXTERNO ---
 
 void HardwareTeclado::eventoUsuarioDigitou(const std::string &texto)
 {
-    if (texto.empty())
+    eventoUsuarioDigitou(texto.data(), texto.size());
+}
+
+void HardwareTeclado::eventoUsuarioDigitou(const char *teclas, size_t quantidade)
+{
+    if (quantidade == 0)
     {
         return;
     }
-    _log("Recebendo digitação do usuário (" + std::to_string(texto.length()) + " tecla(s)).");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "Recebendo digitação do usuário ({} tecla(s)).", quantidade);
+
+    const uint64_t agora = _agoraNs();
+    for (size_t k = 0; k < quantidade; k++)
+    {
+        char c = teclas[k];
+        if (m_teclasNoBuffer == CAPACIDADE_BUFFER_INTERNO)
+        {
+            m_teclasDescartadas++;
+            SIM_LOG(LOG_AVISO, "TECLADO HARDWARE", "AVISO: Buffer interno cheio. Tecla '{c}' descartada.", c);
+            continue;
+        }
+        const size_t posicao = (m_inicioBuffer + m_teclasNoBuffer) % CAPACIDADE_BUFFER_INTERNO;
+        m_bufferInterno[posicao] = c;
+        m_chegadaNs[posicao] = agora;
+        m_teclasNoBuffer++;
+        SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "Tecla '{c}' (0x{x}) enfileirada no buffer.", c, static_cast<uint8_t>(c));
+    }
 
-    for (char c : texto)
+    if (m_limiarFIFO > 0)
+    {
+        // Tecla nova reinicia o timeout (como o "character timeout" do 16550)
+        m_ultimaAtividadeNs = agora;
+        m_timeoutVencido = false;
+        _atualizarSinalIRQ();
+    }
+    else
     {
-        m_bufferInterno.push(c);
-
-        // --- LOG CORRIGIDO (usa a mesma lógica do main.cpp) ---
-        std::string msg = "Tecla '";
-        msg += c;
-        msg += "' (";
-        std::stringstream ss; // Usa stringstream para formatar
-        ss << "0x" << std::hex << std::setw(2) << std::setfill('0') << (int)static_cast<uint8_t>(c);
-        msg += ss.str();
-        msg += ") enfileirada no buffer.";
-        _log(msg);
+        _tentarMoverBufferParaRegistrador();
     }
-    _tentarMoverBufferParaRegistrador();
 }
 
 void HardwareTeclado::eventoCPULeuDados()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_registroStatus == STATUS_VAZIO)
     {
-        _log("AVISO: CPU leu registradores, mas o status já era VAZIO.");
+        SIM_LOG(LOG_AVISO, "TECLADO HARDWARE", "AVISO: CPU leu registradores, mas o status já era VAZIO.");
         return;
     }
 
-    // --- LOG CORRIGIDO (usa stringstream) ---
-    std::stringstream ss;
-    ss << "CPU/ISR leu o dado (0x" << std::hex << (int)m_registroDados << "). Limpando status.";
-    _log(ss.str());
+    SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "CPU/ISR leu o dado (0x{x}). Limpando status.", m_registroDados);
+    m_entrega.leituras++;
+    _registrarEntrega(m_chegadaRegistroNs, _agoraNs());
 
     // --- CORREÇÃO DO BUG 2: Limpa os registradores ---
     m_registroStatus = STATUS_VAZIO; // Marca como lido
@@ -69,35 +104,172 @@ void HardwareTeclado::eventoCPULeuDados()
 
 uint8_t HardwareTeclado::lerStatus() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limiarFIFO > 0)
+        return m_teclasNoBuffer > 0 ? STATUS_DADOS_PRONTOS : STATUS_VAZIO;
     return m_registroStatus;
 }
 
 uint8_t HardwareTeclado::lerDados() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_registroDados;
 }
 
 bool HardwareTeclado::estaSinalIRQAtivo() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_sinalIRQAtivo;
 }
 
+void HardwareTeclado::conectarIRQ(IControladorIRQ *controlador, int linha)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_controlador = controlador;
+    m_linhaIRQ = linha;
+}
+
+uint64_t HardwareTeclado::totalTeclasDescartadas() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_teclasDescartadas;
+}
+
+// --- 3. MODO FIFO ---
+
+void HardwareTeclado::configurarFIFO(size_t limiar, unsigned timeoutMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (limiar > CAPACIDADE_BUFFER_INTERNO)
+        limiar = CAPACIDADE_BUFFER_INTERNO;
+
+    // Uma tecla parada no registrador do modo byte volta para a frente da FIFO
+    if (limiar > 0 && m_registroStatus == STATUS_DADOS_PRONTOS && m_teclasNoBuffer < CAPACIDADE_BUFFER_INTERNO)
+    {
+        m_inicioBuffer = (m_inicioBuffer + CAPACIDADE_BUFFER_INTERNO - 1) % CAPACIDADE_BUFFER_INTERNO;
+        m_bufferInterno[m_inicioBuffer] = (char)m_registroDados;
+        m_chegadaNs[m_inicioBuffer] = m_chegadaRegistroNs;
+        m_teclasNoBuffer++;
+        m_registroStatus = STATUS_VAZIO;
+        m_registroDados = 0x00;
+    }
+
+    m_limiarFIFO = limiar;
+    m_timeoutFIFONs = (uint64_t)timeoutMs * 1000000ull;
+    m_ultimaAtividadeNs = _agoraNs();
+    m_timeoutVencido = false;
+    SIM_LOG(LOG_INFO, "TECLADO HARDWARE", "Modo FIFO: limiar {} tecla(s), timeout {} ms (limiar 0 = modo byte).", limiar, timeoutMs);
+
+    if (m_limiarFIFO > 0)
+        _atualizarSinalIRQ();
+    else
+        _tentarMoverBufferParaRegistrador();
+}
+
+bool HardwareTeclado::fifoAtivo() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_limiarFIFO > 0;
+}
+
+size_t HardwareTeclado::lerNivelFIFO() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_teclasNoBuffer;
+}
+
+size_t HardwareTeclado::lerFIFO(char *destino, size_t max)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limiarFIFO == 0)
+        return 0;
+
+    const uint64_t agora = _agoraNs();
+    size_t n = m_teclasNoBuffer < max ? m_teclasNoBuffer : max;
+    for (size_t k = 0; k < n; k++)
+    {
+        destino[k] = m_bufferInterno[m_inicioBuffer];
+        _registrarEntrega(m_chegadaNs[m_inicioBuffer], agora);
+        m_inicioBuffer = (m_inicioBuffer + 1) % CAPACIDADE_BUFFER_INTERNO;
+    }
+    m_teclasNoBuffer -= n;
+    if (n > 0)
+        m_entrega.leituras++;
+    SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "ISR leu {} tecla(s) da FIFO em rajada.", n);
+
+    // A leitura também reinicia o timeout do que sobrou
+    m_ultimaAtividadeNs = agora;
+    m_timeoutVencido = false;
+    _atualizarSinalIRQ();
+    return n;
+}
+
+void HardwareTeclado::verificarTimeout()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limiarFIFO == 0 || m_teclasNoBuffer == 0 || m_timeoutVencido)
+        return;
+    if (_agoraNs() - m_ultimaAtividadeNs >= m_timeoutFIFONs)
+    {
+        m_timeoutVencido = true;
+        _atualizarSinalIRQ();
+    }
+}
+
+int HardwareTeclado::msAteTimeout() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_limiarFIFO == 0 || m_teclasNoBuffer == 0 || m_timeoutVencido)
+        return -1;
+    uint64_t decorrido = _agoraNs() - m_ultimaAtividadeNs;
+    if (decorrido >= m_timeoutFIFONs)
+        return 0;
+    return (int)((m_timeoutFIFONs - decorrido + 999999ull) / 1000000ull);
+}
+
+void HardwareTeclado::usarTempoSimulado()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tempoSimulado = true;
+    m_tempoSimuladoNs = 0;
+    m_ultimaAtividadeNs = 0; // Instantes antigos eram do relógio real
+    for (size_t k = 0; k < CAPACIDADE_BUFFER_INTERNO; k++)
+        m_chegadaNs[k] = 0;
+    m_chegadaRegistroNs = 0;
+}
+
+void HardwareTeclado::avancarTempoSimulado(uint64_t ns)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_tempoSimulado)
+            return;
+        m_tempoSimuladoNs += ns;
+    }
+    verificarTimeout();
+}
+
+HardwareTeclado::EstatisticasEntrega HardwareTeclado::estatisticasEntrega() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entrega;
+}
+
 // --- 4. FUNÇÕES DE LÓGICA INTERNA (Privadas) ---
 
 void HardwareTeclado::_tentarMoverBufferParaRegistrador()
 {
-    if (m_registroStatus == STATUS_VAZIO && !m_bufferInterno.empty())
+    if (m_registroStatus == STATUS_VAZIO && m_teclasNoBuffer > 0)
     {
-        char scancode = m_bufferInterno.front();
-        m_bufferInterno.pop();
+        char scancode = m_bufferInterno[m_inicioBuffer];
+        m_chegadaRegistroNs = m_chegadaNs[m_inicioBuffer];
+        m_inicioBuffer = (m_inicioBuffer + 1) % CAPACIDADE_BUFFER_INTERNO;
+        m_teclasNoBuffer--;
 
         m_registroDados = static_cast<uint8_t>(scancode);
         m_registroStatus = STATUS_DADOS_PRONTOS;
 
-        // --- LOG CORRIGIDO (usa stringstream) ---
-        std::stringstream ss;
-        ss << "Movendo dado do buffer (0x" << std::hex << (int)m_registroDados << ") para registradores MMIO.";
-        _log(ss.str());
+        SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "Movendo dado do buffer (0x{x}) para registradores MMIO.", m_registroDados);
 
         _atualizarSinalIRQ(); // Sinal IRQ será ativado
     }
@@ -105,24 +277,53 @@ void HardwareTeclado::_tentarMoverBufferParaRegistrador()
 
 void HardwareTeclado::_atualizarSinalIRQ()
 {
-    bool novoEstadoIRQ = (m_registroStatus == STATUS_DADOS_PRONTOS);
+    bool novoEstadoIRQ;
+    bool porLimiar = false;
+    if (m_limiarFIFO > 0)
+    {
+        porLimiar = m_teclasNoBuffer >= m_limiarFIFO;
+        novoEstadoIRQ = porLimiar || (m_teclasNoBuffer > 0 && m_timeoutVencido);
+    }
+    else
+    {
+        novoEstadoIRQ = (m_registroStatus == STATUS_DADOS_PRONTOS);
+    }
+
     if (novoEstadoIRQ != m_sinalIRQAtivo)
     {
         m_sinalIRQAtivo = novoEstadoIRQ;
         if (m_sinalIRQAtivo)
         {
-            _log("Sinal IRQ definido para ATIVO.");
+            SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "Sinal IRQ definido para ATIVO.");
+            if (m_limiarFIFO > 0)
+            {
+                if (porLimiar)
+                    m_entrega.disparosPorLimiar++;
+                else
+                    m_entrega.disparosPorTimeout++;
+            }
+            if (m_controlador != nullptr)
+                m_controlador->elevarLinha(m_linhaIRQ);
         }
         else
         {
-            _log("Sinal IRQ definido para INATIVO.");
+            SIM_LOG(LOG_DEBUG, "TECLADO HARDWARE", "Sinal IRQ definido para INATIVO.");
+            if (m_controlador != nullptr)
+                m_controlador->abaixarLinha(m_linhaIRQ);
         }
     }
 }
 
-// --- 5. HELPER DE LOG ---
+uint64_t HardwareTeclado::_agoraNs() const
+{
+    return m_tempoSimulado ? m_tempoSimuladoNs : _relogioRealNs();
+}
 
-void HardwareTeclado::_log(const std::string &mensagem)
+void HardwareTeclado::_registrarEntrega(uint64_t chegadaNs, uint64_t agoraNs)
 {
-    std::cout << "[TECLADO HARDWARE] " << mensagem << std::endl;
-}
\ No newline at end of file
+    uint64_t latencia = agoraNs - chegadaNs;
+    m_entrega.teclasEntregues++;
+    m_entrega.latenciaTotalNs += latencia;
+    if (latencia > m_entrega.latenciaMaximaNs)
+        m_entrega.latenciaMaximaNs = latencia;
+}
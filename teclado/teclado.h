@@ -3,13 +3,12 @@
 
 // 1. Inclui a nova interface
 #include "../interface/IDispositivoIRQ.h"
+#include "../interface/IControladorIRQ.h"
 
 #include <string>   // Para std::string
-#include <queue>    // Para std::queue
-#include <cstdint>  // Para uint8_t
-#include <iostream> // Para std::cout, std::endl, std::hex
-#include <sstream>  // Para std::stringstream
-#include <iomanip>  // Para std::setw, std::setfill
+#include <cstdint>  // Para uint8_t, uint64_t
+#include <cstddef>  // Para size_t
+#include <mutex>
 
 // Constantes públicas
 static const uint8_t STATUS_VAZIO = 0x00;
@@ -18,6 +17,14 @@ static const uint8_t STATUS_DADOS_PRONTOS = 0x01;
 /**
  * @class HardwareTeclado
  * @brief Simula o hardware físico de um teclado (Controlador).
+ *
+ * Dois modos, como a UART 8250/16550:
+ *  - Byte (padrão): uma tecla por vez no registrador de dados, e uma
+ *    volta IRQ -> ISR -> eventoCPULeuDados() por tecla;
+ *  - FIFO (configurarFIFO): o buffer interno vira a FIFO do hardware,
+ *    com registrador de nível. A IRQ só sobe quando o nível chega ao
+ *    limiar ou quando a FIFO fica parada por 'timeout' com teclas
+ *    retidas (coalescência), e o ISR esvazia tudo com lerFIFO().
  */
 class HardwareTeclado : public IDispositivoIRQ
 {
@@ -25,26 +32,105 @@ public:
     // --- 1. EVENTOS DE GATILHO EXTERNO ---
     HardwareTeclado();
     void eventoUsuarioDigitou(const std::string &texto);
+    void eventoUsuarioDigitou(const char *teclas, size_t quantidade);
     void eventoCPULeuDados();
 
     // --- 2. INTERFACE PÚBLICA (Lida por outras classes) ---
     uint8_t lerStatus() const;
     uint8_t lerDados() const;
-    bool estaSinalIRQAtivo() const;
+    bool estaSinalIRQAtivo() const override;
+    void conectarIRQ(IControladorIRQ *controlador, int linha) override;
+    uint64_t totalTeclasDescartadas() const;
+
+    // --- 2b. MODO FIFO (16550) ---
+    /**
+     * @param limiar Nível da FIFO que dispara a IRQ (0 = volta ao modo byte).
+     * @param timeoutMs Tempo sem teclas novas (nem leituras) que dispara a
+     * IRQ com a FIFO abaixo do limiar.
+     */
+    void configurarFIFO(size_t limiar, unsigned timeoutMs);
+    bool fifoAtivo() const;
+    size_t lerNivelFIFO() const; // Registrador de nível: teclas na FIFO
+    /**
+     * @brief Leitura em rajada (ISR): retira até 'max' teclas de uma vez.
+     * @return Quantas teclas foram copiadas para 'destino'.
+     */
+    size_t lerFIFO(char *destino, size_t max);
+
+    /**
+     * @brief O oscilador do próprio dispositivo: confere se o timeout
+     * venceu. Chamado por quem alimenta o teclado (não depende da CPU,
+     * que pode estar em HLT).
+     */
+    void verificarTimeout();
+    /**
+     * @return ms até o timeout vencer, ou -1 se não há teclas retidas.
+     */
+    int msAteTimeout() const;
+
+    /**
+     * @brief Troca o relógio do timeout da FIFO (e da latência) pelo tempo
+     * simulado, que só anda com avancarTempoSimulado(): o mesmo trace de
+     * entrada dispara as mesmas IRQs nos mesmos ticks (replay determinístico).
+     */
+    void usarTempoSimulado();
+    /**
+     * @brief Avança o tempo simulado (um tick) e confere o timeout.
+     */
+    void avancarTempoSimulado(uint64_t ns);
+
+    struct EstatisticasEntrega
+    {
+        uint64_t leituras = 0;         // Leituras do ISR (1 por IRQ atendida)
+        uint64_t teclasEntregues = 0;  // Teclas que chegaram à CPU
+        uint64_t latenciaTotalNs = 0;  // Da tecla chegar ao hardware até o ISR lê-la
+        uint64_t latenciaMaximaNs = 0;
+        uint64_t disparosPorLimiar = 0;
+        uint64_t disparosPorTimeout = 0;
+    };
+    EstatisticasEntrega estatisticasEntrega() const;
 
 private:
     // --- 3. ESTADO INTERNO DO HARDWARE ---
-    std::queue<char> m_bufferInterno;
+    // Buffer interno de tamanho fixo (anel): como num controlador real,
+    // nunca aloca memória; teclas além da capacidade são descartadas.
+    static const size_t CAPACIDADE_BUFFER_INTERNO = 256;
+    char m_bufferInterno[CAPACIDADE_BUFFER_INTERNO];
+    uint64_t m_chegadaNs[CAPACIDADE_BUFFER_INTERNO]; // Instante de cada tecla (latência)
+    size_t m_inicioBuffer;
+    size_t m_teclasNoBuffer;
+    uint64_t m_teclasDescartadas;
+
     uint8_t m_registroStatus;
     uint8_t m_registroDados;
     bool m_sinalIRQAtivo;
+    uint64_t m_chegadaRegistroNs; // Chegada da tecla que está no registrador
+
+    // Modo FIFO (m_limiarFIFO == 0: modo byte)
+    size_t m_limiarFIFO;
+    uint64_t m_timeoutFIFONs;
+    uint64_t m_ultimaAtividadeNs; // Última tecla nova ou leitura
+    bool m_timeoutVencido;
+
+    // Tempo simulado (usarTempoSimulado): avança por tick, não pelo relógio real
+    bool m_tempoSimulado;
+    uint64_t m_tempoSimuladoNs;
+
+    EstatisticasEntrega m_entrega;
+
+    // O "fio" até o controlador de interrupções
+    IControladorIRQ *m_controlador;
+    int m_linhaIRQ;
+
+    // O "lado do usuário" (thread de input) e o ISR (thread da CPU)
+    // mexem nos mesmos registradores
+    mutable std::mutex m_mutex;
 
     // --- 4. FUNÇÕES DE LÓGICA INTERNA ---
     void _tentarMoverBufferParaRegistrador();
     void _atualizarSinalIRQ();
-
-    // --- 5. HELPER DE LOG ---
-    void _log(const std::string &mensagem);
+    void _registrarEntrega(uint64_t chegadaNs, uint64_t agoraNs);
+    uint64_t _agoraNs() const; // Relógio real ou tempo simulado
 };
 
 #endif // HARDWARE_TECLADO_H
\ No newline at end of file
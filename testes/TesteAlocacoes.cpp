@@ -0,0 +1,475 @@
+#include <algorithm> // Para std::max
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory> // Para std::unique_ptr
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>    // Para open()
+#include <sys/mman.h> // Para mmap()
+#include <sys/stat.h> // Para fstat()
+#include <unistd.h>   // Para close(), unlink(), getpid()
+
+#include "../app/donut.h"
+#include "../buffer/FrameBufferChecksum.h"
+#include "../buffer/FrameBufferDuplo.h"
+#include "../buffer/MmapFrameBuffer.h"
+#include "../cpu/cpu.h"
+#include "../metricas/Metricas.h"
+#include "../pic/ControladorPIC.h"
+#include "../rastreio/Rastreador.h"
+#include "../teclado/teclado.h"
+
+// Teste de alocações do tick em regime.
+//
+// Monta a máquina do simulador (ControladorPIC, CPU, HardwareTeclado em
+// modo FIFO com o ISR do simulador, AppDonut publicando num
+// MmapFrameBuffer) e, depois do aquecimento, conta as chamadas ao
+// operator new (em qualquer thread, inclusive as do PoolDeRender)
+// durante N ticks com teclas chegando. Qualquer alocação é falha.
+//
+// Em texto, o donut desenha direto na sombra do MmapFrameBuffer; uma
+// segunda máquina, igual, manda o frame por string (atualizarRegioes)
+// e os dois frames publicados têm de ser idênticos a cada tick. Com cor,
+// os três planos do slot de células (glifo, frente e fundo) têm de ser
+// os das células que a segunda máquina recebeu.
+//
+// Redimensionando (80x24 -> 200x60 -> 10x2 -> 80x24) com o donut
+// rodando, o frame publicado depois de cada troca tem de ser o de uma
+// máquina criada já no tamanho novo, pelo desenho direto e pelo caminho
+// de string atrás do FrameBufferChecksum e do FrameBufferDuplo. Entre as
+// trocas, depois de alguns ticks, também não pode haver alocação.
+//
+// Rastreador e Metricas ficam ligados (spans e contadores no tick). O
+// Logger fica desligado: o SIM_LOG do tick só grava num anel fixo, mas
+// a thread de drenagem aloca os lotes dela e não faz parte do tick.
+//
+// Sai com código 1 na primeira falha.
+
+namespace
+{
+    std::atomic<bool> g_contando{false};
+    std::atomic<uint64_t> g_alocacoes{0};
+
+    void *_alocar(size_t tamanho, size_t alinhamento)
+    {
+        if (g_contando.load(std::memory_order_relaxed))
+            g_alocacoes.fetch_add(1, std::memory_order_relaxed);
+        if (tamanho == 0)
+            tamanho = 1;
+        void *p = nullptr;
+        if (alinhamento <= alignof(std::max_align_t))
+            p = malloc(tamanho);
+        else if (posix_memalign(&p, alinhamento, tamanho) != 0)
+            p = nullptr;
+        if (p == nullptr)
+            throw std::bad_alloc();
+        return p;
+    }
+}
+
+// --- Todas as formas do operator new passam pelo contador ---
+void *operator new(size_t tamanho) { return _alocar(tamanho, 0); }
+void *operator new[](size_t tamanho) { return _alocar(tamanho, 0); }
+void *operator new(size_t tamanho, std::align_val_t a) { return _alocar(tamanho, (size_t)a); }
+void *operator new[](size_t tamanho, std::align_val_t a) { return _alocar(tamanho, (size_t)a); }
+void *operator new(size_t tamanho, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return _alocar(tamanho, 0);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+void *operator new[](size_t tamanho, const std::nothrow_t &t) noexcept { return operator new(tamanho, t); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { free(p); }
+
+namespace
+{
+    const int TICKS_AQUECIMENTO = 200;
+    const int TICKS_MEDIDOS = 2000;
+    const uint64_t PERIODO_NS = 33333333; // 30 Hz, como o --hz padrão
+
+    // Teclas do tick t: rajadas (mais que o limiar da FIFO), teclas
+    // soltas (saem pelo timeout) e ticks sem nada
+    size_t _teclasDoTick(int t, char *teclas)
+    {
+        static const char PADRAO[] = "wdsawwddssaa";
+        if (t % 50 == 0)
+        {
+            for (int k = 0; k < 12; k++)
+                teclas[k] = PADRAO[(t / 50 + k) % 12];
+            return 12;
+        }
+        if (t % 7 == 0)
+        {
+            teclas[0] = PADRAO[(t / 7) % 12];
+            return 1;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief O frame recebido por string ou em células (o caminho de quem
+     * não empresta a memória), para comparar com o que foi publicado.
+     */
+    class FrameBufferCaptura : public IFrameBuffer
+    {
+    public:
+        explicit FrameBufferCaptura(size_t tamanho) { m_texto.reserve(tamanho); }
+
+        void limpar() override { m_texto.clear(); }
+
+        void atualizar(const std::string &conteudo) override { m_texto.assign(conteudo); }
+
+        void atualizarRegioes(const std::string &conteudo, const RegiaoSuja *regioes, size_t quantidade) override
+        {
+            if (conteudo.size() != m_texto.size())
+            {
+                m_texto.assign(conteudo);
+                return;
+            }
+            for (size_t k = 0; k < quantidade; k++)
+                memcpy(&m_texto[regioes[k].deslocamento], conteudo.data() + regioes[k].deslocamento, regioes[k].tamanho);
+        }
+
+        void atualizarCelulas(const FrameCelulas &celulas) override { m_celulas = celulas; }
+
+        void atualizarCelulasRegioes(const FrameCelulas &celulas, const RegiaoSuja *regioes, size_t quantidade) override
+        {
+            if (celulas.largura != m_celulas.largura || celulas.altura != m_celulas.altura)
+            {
+                m_celulas = celulas;
+                return;
+            }
+            for (size_t k = 0; k < quantidade; k++)
+            {
+                const size_t o = regioes[k].deslocamento, n = regioes[k].tamanho;
+                memcpy(&m_celulas.glifos[o], &celulas.glifos[o], n);
+                memcpy(&m_celulas.frente[o], &celulas.frente[o], n * sizeof(uint32_t));
+                memcpy(&m_celulas.fundo[o], &celulas.fundo[o], n * sizeof(uint32_t));
+            }
+        }
+
+        const std::string &texto() const { return m_texto; }
+        const FrameCelulas &celulas() const { return m_celulas; }
+
+    private:
+        std::string m_texto;
+        FrameCelulas m_celulas;
+    };
+
+    /**
+     * @brief O slot de células publicado tem os três planos (glifo,
+     * frente e fundo) iguais aos de 'esperado'?
+     */
+    bool _celulasIguais(const char *slot, size_t tamanho, const FrameCelulas &esperado)
+    {
+        const size_t n = esperado.celulas();
+        return n > 0 && tamanho == tamanhoCelulasShm(n) &&
+               memcmp(slot, esperado.glifos.data(), n) == 0 &&
+               memcmp(slot + inicioFrenteCelulasShm(n), esperado.frente.data(), n * sizeof(uint32_t)) == 0 &&
+               memcmp(slot + inicioFundoCelulasShm(n), esperado.fundo.data(), n * sizeof(uint32_t)) == 0;
+    }
+
+    /**
+     * @brief A fiação do simulador com um núcleo, sem escalonador: o
+     * teclado na IRQ 1 e o donut como aplicação da CPU.
+     */
+    struct Maquina
+    {
+        ControladorPIC pic;
+        CPU cpu;
+        HardwareTeclado teclado;
+        BufferDeEntradaOS entrada;
+        AppDonut donut;
+
+        Maquina(int threadsRender, int largura, int altura, IFrameBuffer &tela)
+            : cpu(pic), donut(threadsRender, largura, altura)
+        {
+            teclado.configurarFIFO(8, 2);
+            teclado.usarTempoSimulado();
+            pic.registrarDispositivo(1, &teclado);
+            cpu.registrarISR(1, Maquina::_isrTeclado, this);
+            donut.conectar(&entrada, &tela);
+            cpu.carregarAplicacao(&donut);
+        }
+
+        void tick(int t)
+        {
+            char teclas[16];
+            size_t n = _teclasDoTick(t, teclas);
+            if (n > 0)
+                teclado.eventoUsuarioDigitou(teclas, n);
+            teclado.avancarTempoSimulado(PERIODO_NS);
+            teclado.verificarTimeout();
+            cpu.tick();
+        }
+
+        // O mesmo ISR do simulador no modo FIFO: esvazia a FIFO de uma vez
+        static void _isrTeclado(void *contexto)
+        {
+            Maquina *m = static_cast<Maquina *>(contexto);
+            char teclas[256];
+            size_t n = m->teclado.lerFIFO(teclas, sizeof(teclas));
+            for (size_t k = 0; k < n; k++)
+                m->entrada.enfileirarTecla(teclas[k]);
+        }
+    };
+
+    /**
+     * @brief O sim_frame.shm do teste, mapeado como o visor o mapeia.
+     */
+    CabecalhoFrameShm *_mapearFrame(const std::string &caminho, size_t &tamanho)
+    {
+        int fd = open(caminho.c_str(), O_RDONLY);
+        if (fd == -1)
+            return nullptr;
+        struct stat st;
+        void *mapa = MAP_FAILED;
+        if (fstat(fd, &st) == 0)
+            mapa = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapa == MAP_FAILED)
+            return nullptr;
+        tamanho = (size_t)st.st_size;
+        return static_cast<CabecalhoFrameShm *>(mapa);
+    }
+
+    /**
+     * @brief Troca o mapeamento do teste pelo arquivo atual do caminho
+     * (o MmapFrameBuffer recria o arquivo ao redimensionar).
+     */
+    bool _remapearFrame(const std::string &caminho, CabecalhoFrameShm *&cabecalho, size_t &tamanho)
+    {
+        if (cabecalho != nullptr)
+            munmap(cabecalho, tamanho);
+        cabecalho = _mapearFrame(caminho, tamanho);
+        if (cabecalho == nullptr)
+        {
+            fprintf(stderr, "FALHA: não foi possível mapear %s\n", caminho.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool _executar(int threadsRender, int largura, int altura, bool cores)
+    {
+        const std::string caminho = "/tmp/teste_alocacoes_" + std::to_string(getpid()) + ".shm";
+        MmapFrameBuffer tela(caminho, largura, altura, "", cores ? FORMATO_FRAME_CELULAS : FORMATO_FRAME_TEXTO);
+        Maquina maquina(threadsRender, largura, altura, tela);
+        maquina.donut.usarCores(cores);
+
+        // A referência recebe o mesmo frame por string (ou em células, com cor)
+        FrameBufferCaptura captura(3 + (size_t)largura * altura);
+        Maquina referencia(threadsRender, largura, altura, captura);
+        referencia.donut.usarCores(cores);
+
+        size_t tamanhoMapa = 0;
+        CabecalhoFrameShm *cabecalho = _mapearFrame(caminho, tamanhoMapa);
+        if (cabecalho == nullptr)
+        {
+            fprintf(stderr, "FALHA: não foi possível mapear %s\n", caminho.c_str());
+            unlink(caminho.c_str());
+            return false;
+        }
+        std::vector<char> publicado(cabecalho->tamanhoSlot);
+
+        bool ok = true;
+        int t = 0;
+        for (; t < TICKS_AQUECIMENTO; t++)
+        {
+            maquina.tick(t);
+            referencia.tick(t);
+        }
+
+        g_alocacoes.store(0);
+        g_contando.store(true);
+        uint64_t frames = 0;
+        for (; t < TICKS_AQUECIMENTO + TICKS_MEDIDOS && ok; t++)
+        {
+            maquina.tick(t);
+            referencia.tick(t);
+
+            uint64_t sequencia = 0, timestampNs = 0;
+            size_t n = lerFrameShm(cabecalho, publicado.data(), sequencia, timestampNs);
+            if (cores && !_celulasIguais(publicado.data(), n, captura.celulas()))
+            {
+                fprintf(stderr, "FALHA: %dx%d, %d thread(s), cor: tick %d: o slot de células (glifo, frente ou "
+                                "fundo) difere das células enviadas\n", largura, altura, threadsRender, t);
+                ok = false;
+            }
+            const std::string &esperado = captura.texto();
+            if (!cores && (n != esperado.size() || memcmp(publicado.data(), esperado.data(), n) != 0))
+            {
+                fprintf(stderr, "FALHA: %dx%d, %d thread(s): tick %d: o frame desenhado direto difere do enviado por string\n",
+                        largura, altura, threadsRender, t);
+                ok = false;
+            }
+            frames++;
+        }
+        g_contando.store(false);
+
+        const uint64_t alocacoes = g_alocacoes.load();
+        if (ok && alocacoes != 0)
+        {
+            fprintf(stderr, "FALHA: %dx%d, %d thread(s)%s: %llu alocação(ões) em %d ticks\n", largura, altura,
+                    threadsRender, cores ? ", cor" : "", (unsigned long long)alocacoes, TICKS_MEDIDOS);
+            ok = false;
+        }
+        if (ok)
+            printf("ok: %dx%d, %d thread(s)%s: 0 alocações em %d ticks (%llu frames conferidos)\n", largura, altura,
+                   threadsRender, cores ? ", cor" : "", TICKS_MEDIDOS, (unsigned long long)frames);
+
+        munmap(cabecalho, tamanhoMapa);
+        unlink(caminho.c_str());
+        return ok;
+    }
+    bool _executarRedimensionando(int threadsRender)
+    {
+        static const int TAMANHOS[][2] = {{80, 24}, {200, 60}, {10, 2}, {80, 24}};
+        static const int NUM_TAMANHOS = sizeof(TAMANHOS) / sizeof(TAMANHOS[0]);
+        const int TICKS_POR_TAMANHO = 400;
+        const int AQUECIMENTO_POR_TAMANHO = 20; // A troca aloca; o regime depois dela, não
+
+        const std::string prefixo = "/tmp/teste_alocacoes_" + std::to_string(getpid());
+        const std::string caminhoDireto = prefixo + "_direto.shm", caminhoString = prefixo + "_string.shm";
+        const int largura0 = TAMANHOS[0][0], altura0 = TAMANHOS[0][1];
+
+        // Desenho direto na sombra do MmapFrameBuffer
+        MmapFrameBuffer telaDireta(caminhoDireto, largura0, altura0);
+        Maquina direta(threadsRender, largura0, altura0, telaDireta);
+
+        // Caminho de string, pelos decoradores que repassam o redimensionar()
+        MmapFrameBuffer telaString(caminhoString, largura0, altura0);
+        FrameBufferCaptura capturaString(0);
+        FrameBufferDuplo duplo(telaString, capturaString);
+        FrameBufferChecksum checksum(duplo);
+        Maquina porString(threadsRender, largura0, altura0, checksum);
+
+        // Referências: uma máquina por tamanho, criada nele e nunca
+        // redimensionada, com as mesmas teclas desde o tick 0 (o estado
+        // do donut não depende da resolução)
+        std::vector<std::unique_ptr<FrameBufferCaptura>> capturas;
+        std::vector<std::unique_ptr<Maquina>> referencias;
+        for (int k = 0; k < NUM_TAMANHOS; k++)
+        {
+            const int largura = TAMANHOS[k][0], altura = TAMANHOS[k][1];
+            capturas.emplace_back(new FrameBufferCaptura(3 + (size_t)largura * altura));
+            referencias.emplace_back(new Maquina(threadsRender, largura, altura, *capturas.back()));
+        }
+
+        size_t tamanhoDireto = 0, tamanhoString = 0;
+        CabecalhoFrameShm *cabecalhoDireto = nullptr, *cabecalhoString = nullptr;
+        bool ok = _remapearFrame(caminhoDireto, cabecalhoDireto, tamanhoDireto) &&
+                  _remapearFrame(caminhoString, cabecalhoString, tamanhoString);
+        std::vector<char> publicado;
+        uint64_t frames = 0, alocacoes = 0;
+
+        int t = 0;
+        for (int fase = 0; fase < NUM_TAMANHOS && ok; fase++)
+        {
+            const int largura = TAMANHOS[fase][0], altura = TAMANHOS[fase][1];
+            if (fase > 0)
+            {
+                direta.donut.redimensionar(largura, altura);
+                porString.donut.redimensionar(largura, altura);
+                ok = _remapearFrame(caminhoDireto, cabecalhoDireto, tamanhoDireto) &&
+                     _remapearFrame(caminhoString, cabecalhoString, tamanhoString);
+                if (!ok)
+                    break;
+            }
+            publicado.assign(std::max(cabecalhoDireto->tamanhoSlot, cabecalhoString->tamanhoSlot), 0);
+
+            // O frame em branco da troca fica até o donut desenhar de novo
+            uint64_t sequencia = 0, timestampNs = 0, brancoDireto = 0, brancoString = 0;
+            lerFrameShm(cabecalhoDireto, publicado.data(), brancoDireto, timestampNs);
+            lerFrameShm(cabecalhoString, publicado.data(), brancoString, timestampNs);
+
+            for (int k = 0; k < TICKS_POR_TAMANHO && ok; k++, t++)
+            {
+                if (k == AQUECIMENTO_POR_TAMANHO)
+                {
+                    g_alocacoes.store(0);
+                    g_contando.store(true);
+                }
+                direta.tick(t);
+                porString.tick(t);
+                for (auto &referencia : referencias)
+                    referencia->tick(t);
+
+                const std::string &esperado = capturas[fase]->texto();
+                size_t n = lerFrameShm(cabecalhoDireto, publicado.data(), sequencia, timestampNs);
+                frames += sequencia != brancoDireto;
+                if (sequencia != brancoDireto && (n != esperado.size() || memcmp(publicado.data(), esperado.data(), n) != 0))
+                {
+                    fprintf(stderr, "FALHA: redimensionando para %dx%d, tick %d: o frame desenhado direto difere do "
+                                    "de um donut criado nesse tamanho\n", largura, altura, t);
+                    ok = false;
+                }
+                n = lerFrameShm(cabecalhoString, publicado.data(), sequencia, timestampNs);
+                if (sequencia != brancoString &&
+                    (n != esperado.size() || memcmp(publicado.data(), esperado.data(), n) != 0 ||
+                     capturaString.texto() != esperado || checksum.valor() != checksumFrame(esperado.data(), esperado.size())))
+                {
+                    fprintf(stderr, "FALHA: redimensionando para %dx%d, tick %d: o frame por string (checksum, duplo, "
+                                    "mmap) difere do de um donut criado nesse tamanho\n", largura, altura, t);
+                    ok = false;
+                }
+            }
+            g_contando.store(false);
+            alocacoes += g_alocacoes.load();
+        }
+
+        if (ok && alocacoes != 0)
+        {
+            fprintf(stderr, "FALHA: redimensionando, %d thread(s): %llu alocação(ões) fora das trocas\n", threadsRender,
+                    (unsigned long long)alocacoes);
+            ok = false;
+        }
+        if (ok)
+            printf("ok: redimensionando 80x24 -> 200x60 -> 10x2 -> 80x24, %d thread(s): 0 alocações em regime "
+                   "(%llu frames conferidos)\n", threadsRender, (unsigned long long)frames);
+
+        if (cabecalhoDireto != nullptr)
+            munmap(cabecalhoDireto, tamanhoDireto);
+        if (cabecalhoString != nullptr)
+            munmap(cabecalhoString, tamanhoString);
+        unlink(caminhoDireto.c_str());
+        unlink(caminhoString.c_str());
+        return ok;
+    }
+}
+
+int main()
+{
+    Rastreador::iniciar();
+    const std::string caminhoMetricas = "/tmp/teste_alocacoes_" + std::to_string(getpid()) + "_metricas.shm";
+    if (!Metricas::iniciar(caminhoMetricas, PERIODO_NS, 1))
+        fprintf(stderr, "aviso: métricas indisponíveis, seguindo sem elas\n");
+
+    bool ok = _executar(1, LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT, false) &&
+              _executar(3, LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT, false) &&
+              _executar(2, 200, 60, false) &&
+              _executar(1, 10, 2, false) &&
+              _executar(1, LARGURA_PADRAO_DONUT, ALTURA_PADRAO_DONUT, true) &&
+              _executarRedimensionando(1) &&
+              _executarRedimensionando(3);
+
+    Metricas::encerrar();
+    unlink(caminhoMetricas.c_str());
+    Rastreador::encerrar();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,351 @@
+#include <algorithm> // Para std::min
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../buffer/CodificadorANSI.h"
+
+// Teste do CodificadorANSI contra um terminal de mentira.
+//
+// Um modelo mínimo de terminal VT (células com glifo e cores, cursor,
+// quebra pendente na última coluna, CUP, CUF, SGR truecolor, "\r\n")
+// interpreta tudo o que o codificador manda. Depois de cada frame, a
+// tela do modelo tem de ser igual ao frame, célula a célula.
+//
+// Os frames são deltas aleatórios (células soltas, trechos de linha,
+// linhas inteiras, poucas cores para os buracos reescritos), em vários
+// tamanhos, com esquecerCursor() e restaurarCores() como o visor faz
+// ao escrever a linha de status, e invalidar() depois de um ESC[2J.
+// Sequência desconhecida, rolagem da tela ou escrita fora dela é falha.
+//
+// Sai com código 1 na primeira falha.
+
+namespace
+{
+    const int FRAMES_POR_TAMANHO = 3000;
+    const unsigned SEMENTE = 20261017;
+
+    /**
+     * @brief O terminal: só o que o codificador pode usar.
+     */
+    class TerminalModelo
+    {
+    public:
+        TerminalModelo(int largura, int altura) { m_tela.redimensionar(largura, altura); }
+
+        // ESC[2J: apaga com as cores atuais (aqui, sempre as padrão) e não mexe no cursor
+        void apagar() { m_tela.limpar(); }
+
+        // Texto de fora (linha de status...): o cursor vai parar em qualquer lugar
+        void moverCursor(int linha, int coluna, bool quebraPendente)
+        {
+            m_linha = linha;
+            m_coluna = coluna;
+            m_quebraPendente = quebraPendente;
+        }
+
+        /**
+         * @return false (com o motivo em 'erro') se a saída tem algo que
+         * o terminal não entende ou que o tiraria da grade.
+         */
+        bool interpretar(const std::string &saida, std::string &erro)
+        {
+            for (size_t k = 0; k < saida.size(); k++)
+            {
+                const char c = saida[k];
+                if (c == '\x1b')
+                {
+                    if (!_sequencia(saida, k, erro))
+                        return false;
+                    continue;
+                }
+                if (c == '\r')
+                {
+                    m_coluna = 0;
+                    m_quebraPendente = false;
+                    continue;
+                }
+                if (c == '\n')
+                {
+                    if (m_linha + 1 >= m_tela.altura)
+                    {
+                        erro = "'\\n' na última linha rolaria a tela";
+                        return false;
+                    }
+                    m_linha++;
+                    m_quebraPendente = false;
+                    continue;
+                }
+                if ((unsigned char)c < 0x20)
+                {
+                    erro = "caractere de controle inesperado";
+                    return false;
+                }
+                if (!_imprimir(c, erro))
+                    return false;
+            }
+            return true;
+        }
+
+        const FrameCelulas &tela() const { return m_tela; }
+
+    private:
+        FrameCelulas m_tela;
+        int m_linha = 0, m_coluna = 0;
+        bool m_quebraPendente = false; // Escreveu na última coluna: o próximo glifo quebra a linha
+        uint32_t m_frente = COR_PADRAO, m_fundo = COR_PADRAO;
+
+        bool _imprimir(char c, std::string &erro)
+        {
+            if (m_quebraPendente)
+            {
+                if (m_linha + 1 >= m_tela.altura)
+                {
+                    erro = "glifo depois da última coluna da última linha rolaria a tela";
+                    return false;
+                }
+                m_linha++;
+                m_coluna = 0;
+                m_quebraPendente = false;
+            }
+            const size_t o = (size_t)m_linha * m_tela.largura + m_coluna;
+            m_tela.glifos[o] = c;
+            m_tela.frente[o] = m_frente;
+            m_tela.fundo[o] = m_fundo;
+            if (m_coluna + 1 < m_tela.largura)
+                m_coluna++;
+            else
+                m_quebraPendente = true;
+            return true;
+        }
+
+        // CSI: ESC [ parâmetros (dígitos e ';') e o byte final
+        bool _sequencia(const std::string &saida, size_t &k, std::string &erro)
+        {
+            if (k + 1 >= saida.size() || saida[k + 1] != '[')
+            {
+                erro = "ESC sem '['";
+                return false;
+            }
+            std::vector<int> parametros;
+            int atual = -1; // -1: parâmetro omitido
+            for (k += 2; k < saida.size(); k++)
+            {
+                const char c = saida[k];
+                if (c >= '0' && c <= '9')
+                {
+                    atual = (atual < 0 ? 0 : atual * 10) + (c - '0');
+                    continue;
+                }
+                if (c == ';')
+                {
+                    parametros.push_back(atual);
+                    atual = -1;
+                    continue;
+                }
+                parametros.push_back(atual);
+                return _executar(c, parametros, erro);
+            }
+            erro = "CSI sem byte final";
+            return false;
+        }
+
+        static int _ou(const std::vector<int> &p, size_t i, int padrao)
+        {
+            return i < p.size() && p[i] > 0 ? p[i] : padrao;
+        }
+
+        bool _executar(char final, const std::vector<int> &p, std::string &erro)
+        {
+            switch (final)
+            {
+            case 'H': // CUP (1-based, omitido = 1)
+                m_linha = _ou(p, 0, 1) - 1;
+                m_coluna = _ou(p, 1, 1) - 1;
+                m_quebraPendente = false;
+                if (m_linha >= m_tela.altura || m_coluna >= m_tela.largura)
+                {
+                    erro = "CUP fora da tela";
+                    return false;
+                }
+                return true;
+            case 'C': // CUF: para na última coluna
+                m_coluna = std::min(m_coluna + _ou(p, 0, 1), m_tela.largura - 1);
+                m_quebraPendente = false;
+                return true;
+            case 'm':
+                return _sgr(p, erro);
+            default:
+                erro = std::string("sequência CSI desconhecida: ") + final;
+                return false;
+            }
+        }
+
+        bool _sgr(const std::vector<int> &p, std::string &erro)
+        {
+            for (size_t i = 0; i < p.size(); i++)
+            {
+                const int codigo = p[i] < 0 ? 0 : p[i];
+                if (codigo == 0)
+                {
+                    m_frente = COR_PADRAO;
+                    m_fundo = COR_PADRAO;
+                }
+                else if (codigo == 39)
+                    m_frente = COR_PADRAO;
+                else if (codigo == 49)
+                    m_fundo = COR_PADRAO;
+                else if ((codigo == 38 || codigo == 48) && i + 4 < p.size() && p[i + 1] == 2)
+                {
+                    const uint32_t cor = corRGB((uint32_t)p[i + 2], (uint32_t)p[i + 3], (uint32_t)p[i + 4]);
+                    (codigo == 38 ? m_frente : m_fundo) = cor;
+                    i += 4;
+                }
+                else
+                {
+                    erro = "SGR desconhecido: " + std::to_string(codigo);
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief Muda o frame ao acaso: poucas células, um trecho de linha ou
+     * linhas inteiras, com glifos e cores de conjuntos pequenos (assim os
+     * buracos entre mudanças muitas vezes já estão certos na tela).
+     */
+    void _mudarFrame(FrameCelulas &frame, std::mt19937 &rng)
+    {
+        static const char GLIFOS[] = " .,-~:;=!*#$@";
+        static const uint32_t CORES[] = {COR_PADRAO, 0x000000, 0xFFFFFF, 0xFF8000, 0x102030};
+        std::uniform_int_distribution<int> glifo(0, (int)sizeof(GLIFOS) - 2);
+        std::uniform_int_distribution<int> cor(0, (int)(sizeof(CORES) / sizeof(CORES[0])) - 1);
+        std::uniform_int_distribution<int> linha(0, frame.altura - 1), coluna(0, frame.largura - 1);
+
+        auto mudar = [&](size_t o) {
+            frame.glifos[o] = GLIFOS[glifo(rng)];
+            if (rng() % 3 == 0)
+                frame.frente[o] = CORES[cor(rng)];
+            if (rng() % 5 == 0)
+                frame.fundo[o] = CORES[cor(rng)];
+        };
+
+        switch (rng() % 4)
+        {
+        case 0: // Células soltas (inclui a última coluna de cada linha)
+        {
+            const int n = 1 + (int)(rng() % 12);
+            for (int k = 0; k < n; k++)
+            {
+                const int c = rng() % 4 == 0 ? frame.largura - 1 : coluna(rng);
+                mudar((size_t)linha(rng) * frame.largura + c);
+            }
+            break;
+        }
+        case 1: // Um trecho de linha com buracos curtos
+        {
+            const int y = linha(rng);
+            for (int x = coluna(rng); x < frame.largura; x += 1 + (int)(rng() % 6))
+                mudar((size_t)y * frame.largura + x);
+            break;
+        }
+        case 2: // Linhas inteiras
+        {
+            const int n = 1 + (int)(rng() % 3);
+            for (int k = 0; k < n; k++)
+            {
+                const int y = linha(rng);
+                for (int x = 0; x < frame.largura; x++)
+                    mudar((size_t)y * frame.largura + x);
+            }
+            break;
+        }
+        default: // Nada (o codificador não deve mandar nada)
+            break;
+        }
+    }
+
+    bool _telaIgual(const FrameCelulas &tela, const FrameCelulas &frame, int &linha, int &coluna)
+    {
+        for (size_t o = 0; o < frame.celulas(); o++)
+        {
+            if (!tela.igual(o, frame))
+            {
+                linha = (int)(o / frame.largura);
+                coluna = (int)(o % frame.largura);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool _executar(int largura, int altura)
+    {
+        std::mt19937 rng(SEMENTE + (unsigned)(largura * 1000 + altura));
+        CodificadorANSI codificador;
+        TerminalModelo terminal(largura, altura);
+        FrameCelulas frame;
+        frame.redimensionar(largura, altura);
+
+        std::string saida, erro;
+        size_t bytes = 0;
+        for (int f = 0; f < FRAMES_POR_TAMANHO; f++)
+        {
+            saida.clear();
+            const unsigned evento = rng() % 40;
+            if (evento == 0)
+            {
+                // Como a linha de status do visor: cores padrão, texto de fora, cursor perdido
+                codificador.restaurarCores(saida);
+                if (!terminal.interpretar(saida, erro))
+                {
+                    fprintf(stderr, "FALHA: %dx%d, frame %d: %s\n", largura, altura, f, erro.c_str());
+                    return false;
+                }
+                saida.clear();
+                terminal.moverCursor((int)(rng() % altura), (int)(rng() % largura), rng() % 2 == 0);
+                codificador.esquecerCursor();
+            }
+            else if (evento == 1)
+            {
+                // ESC[2J por fora (ex: o visor reabrindo o arquivo)
+                terminal.apagar();
+                terminal.moverCursor((int)(rng() % altura), (int)(rng() % largura), false);
+                codificador.invalidar();
+            }
+
+            _mudarFrame(frame, rng);
+            codificador.codificar(frame, saida);
+            bytes += saida.size();
+            if (!terminal.interpretar(saida, erro))
+            {
+                fprintf(stderr, "FALHA: %dx%d, frame %d: %s\n", largura, altura, f, erro.c_str());
+                return false;
+            }
+            int linha = 0, coluna = 0;
+            if (!_telaIgual(terminal.tela(), frame, linha, coluna))
+            {
+                fprintf(stderr, "FALHA: %dx%d, frame %d: a tela difere do frame na linha %d, coluna %d\n",
+                        largura, altura, f, linha, coluna);
+                return false;
+            }
+        }
+        printf("ok: %dx%d: %d frames, tela igual ao frame em todos (%.1f bytes por frame)\n", largura, altura,
+               FRAMES_POR_TAMANHO, (double)bytes / FRAMES_POR_TAMANHO);
+        return true;
+    }
+}
+
+int main()
+{
+    static const int TAMANHOS[][2] = {{80, 24}, {200, 60}, {10, 2}, {7, 3}, {1, 5}, {3, 1}, {1, 1}};
+    for (const auto &tamanho : TAMANHOS)
+    {
+        if (!_executar(tamanho[0], tamanho[1]))
+            return 1;
+    }
+    return 0;
+}
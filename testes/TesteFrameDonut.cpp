@@ -0,0 +1,154 @@
+#include <algorithm> // Para std::min, std::max
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../app/donut_kernel.h"
+
+// Teste de frame de referência do kernel do donut.
+//
+// 1. Todos os kernels desta CPU (AVX2, SSE4.1, escalar) geram frames
+//    idênticos bit a bit (glifos e z-buffer), para uma varredura fixa de A/B.
+// 2. No 80x24, o frame bate com o renderizador original (double, sin/cos
+//    por amostra) dentro da tolerância abaixo: a diferença vem só do
+//    float, em amostras quase empatadas no z ou na borda de uma célula.
+//
+// Sai com código 1 na primeira falha.
+
+namespace
+{
+    const int LARGURA = 80;
+    const int ALTURA = 24;
+
+    // Tolerância contra o renderizador original (medido: 1 célula em ~400 mil)
+    const int MAX_CELULAS_DIFERENTES_POR_FRAME = 4;
+    const double MAX_FRACAO_DIFERENTE = 1e-4; // Na varredura inteira
+
+    // Varredura fixa: NUM_PASSOS x NUM_PASSOS pares (A, B)
+    const int NUM_PASSOS = 24;
+    const double PASSO_A = 0.37;
+    const double PASSO_B = 0.29;
+
+    struct Frame
+    {
+        std::vector<char> b;
+        std::vector<float> z;
+
+        Frame(int largura, int altura) : b((size_t)largura * altura, ' '), z((size_t)largura * altura, 0.0f) {}
+    };
+
+    ParametrosDonut _parametros(double A, double B, int largura, int altura, float escala)
+    {
+        ParametrosDonut p;
+        p.senA = (float)sin(A);
+        p.cosA = (float)cos(A);
+        p.senB = (float)sin(B);
+        p.cosB = (float)cos(B);
+        p.largura = largura;
+        p.altura = altura;
+        p.escalaX = 30.0f * escala;
+        p.escalaY = 15.0f * escala;
+        return p;
+    }
+
+    /**
+     * @brief Compara os kernels entre si numa resolução (mesmos passos de
+     * amostragem que o AppDonut usa nela).
+     */
+    bool _kernelsIdenticos(const std::vector<OpcaoKernelDonut> &kernels, int largura, int altura)
+    {
+        const float escala = std::min((float)largura / LARGURA, (float)altura / ALTURA);
+        const double escalaI = std::max(1.0, escala / 2.0);
+        TabelasDonut tabelas;
+        construirTabelasDonut(tabelas, 0.02 / escalaI, 0.07 / escala);
+
+        for (int a = 0; a < NUM_PASSOS; a++)
+        {
+            for (int k = 0; k < NUM_PASSOS; k++)
+            {
+                const ParametrosDonut p = _parametros(a * PASSO_A, k * PASSO_B, largura, altura, escala);
+
+                Frame esperado(largura, altura);
+                kernels.back().kernel(tabelas, p, 0, tabelas.numJ, esperado.b.data(), esperado.z.data());
+
+                for (size_t n = 0; n + 1 < kernels.size(); n++)
+                {
+                    Frame frame(largura, altura);
+                    kernels[n].kernel(tabelas, p, 0, tabelas.numJ, frame.b.data(), frame.z.data());
+                    if (frame.b != esperado.b ||
+                        memcmp(frame.z.data(), esperado.z.data(), frame.z.size() * sizeof(float)) != 0)
+                    {
+                        fprintf(stderr, "FALHA: %dx%d, A=%.2f B=%.2f: kernel %s difere do %s\n",
+                                largura, altura, a * PASSO_A, k * PASSO_B, kernels[n].nome, kernels.back().nome);
+                        return false;
+                    }
+                }
+            }
+        }
+        printf("ok: %zu kernel(s) idênticos em %dx%d (%d frames)\n", kernels.size(), largura, altura,
+               NUM_PASSOS * NUM_PASSOS);
+        return true;
+    }
+
+    bool _bateComReferencia(const OpcaoKernelDonut &kernel)
+    {
+        TabelasDonut tabelas;
+        construirTabelasDonut(tabelas, 0.02, 0.07);
+
+        std::vector<char> referencia;
+        long diferentes = 0;
+        int piorFrame = 0;
+        for (int a = 0; a < NUM_PASSOS; a++)
+        {
+            for (int k = 0; k < NUM_PASSOS; k++)
+            {
+                const double A = a * PASSO_A, B = k * PASSO_B;
+                renderizarDonutOriginal(A, B, referencia);
+
+                Frame frame(LARGURA, ALTURA);
+                kernel.kernel(tabelas, _parametros(A, B, LARGURA, ALTURA, 1.0f), 0, tabelas.numJ,
+                              frame.b.data(), frame.z.data());
+
+                int noFrame = 0;
+                for (size_t o = 0; o < referencia.size(); o++)
+                    noFrame += frame.b[o] != referencia[o];
+                if (noFrame > MAX_CELULAS_DIFERENTES_POR_FRAME)
+                {
+                    fprintf(stderr, "FALHA: A=%.2f B=%.2f: %d células diferentes do original (máximo %d)\n",
+                            A, B, noFrame, MAX_CELULAS_DIFERENTES_POR_FRAME);
+                    return false;
+                }
+                diferentes += noFrame;
+                piorFrame = std::max(piorFrame, noFrame);
+            }
+        }
+
+        const double total = (double)NUM_PASSOS * NUM_PASSOS * LARGURA * ALTURA;
+        if (diferentes / total > MAX_FRACAO_DIFERENTE)
+        {
+            fprintf(stderr, "FALHA: %ld de %.0f células diferentes do original (máximo %.4f%%)\n",
+                    diferentes, total, MAX_FRACAO_DIFERENTE * 100);
+            return false;
+        }
+        printf("ok: kernel %s x original: %ld de %.0f células diferentes (pior frame: %d)\n",
+               kernel.nome, diferentes, total, piorFrame);
+        return true;
+    }
+}
+
+int main()
+{
+    const std::vector<OpcaoKernelDonut> kernels = kernelsDonutSuportados();
+    printf("kernels nesta CPU:");
+    for (const OpcaoKernelDonut &k : kernels)
+        printf(" %s", k.nome);
+    printf("\n");
+
+    if (!_kernelsIdenticos(kernels, LARGURA, ALTURA) || !_kernelsIdenticos(kernels, 200, 60))
+        return 1;
+    // Os kernels já são idênticos entre si: basta o escalar contra o original
+    if (!_bateComReferencia(kernels.back()))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "TimerPIT.h"
+
+#include "../log/Logger.h"
+
+TimerPIT::TimerPIT()
+    : m_divisor(0),
+      m_contador(0),
+      m_disparos(0),
+      m_controlador(nullptr),
+      m_linhaIRQ(-1)
+{
+    SIM_LOG(LOG_INFO, "TIMER PIT", "Timer inicializado (desprogramado).");
+}
+
+void TimerPIT::programar(uint32_t divisor)
+{
+    m_divisor = divisor;
+    m_contador = divisor;
+    if (divisor == 0)
+    {
+        SIM_LOG(LOG_INFO, "TIMER PIT", "Timer desligado.");
+    }
+    else
+    {
+        SIM_LOG(LOG_INFO, "TIMER PIT", "Timer programado: uma IRQ a cada {} ticks.", divisor);
+    }
+}
+
+void TimerPIT::eventoClock()
+{
+    if (m_divisor == 0)
+        return;
+
+    if (--m_contador == 0)
+    {
+        m_contador = m_divisor;
+        m_disparos++;
+
+        // Pulso na linha: a subida fica registrada no PIC (disparo por borda)
+        if (m_controlador != nullptr)
+        {
+            m_controlador->elevarLinha(m_linhaIRQ);
+            m_controlador->abaixarLinha(m_linhaIRQ);
+        }
+    }
+}
+
+bool TimerPIT::estaSinalIRQAtivo() const
+{
+    // O sinal só fica alto durante o pulso
+    return false;
+}
+
+void TimerPIT::conectarIRQ(IControladorIRQ *controlador, int linha)
+{
+    m_controlador = controlador;
+    m_linhaIRQ = linha;
+}
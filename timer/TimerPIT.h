@@ -0,0 +1,50 @@
+#ifndef TIMER_PIT_H
+#define TIMER_PIT_H
+
+#include "../interface/IDispositivoIRQ.h"
+#include "../interface/IControladorIRQ.h"
+
+#include <cstdint> // Para uint32_t, uint64_t
+
+/**
+ * @class TimerPIT
+ * @brief Simula um Programmable Interval Timer (estilo 8253/8254).
+ *
+ * Um contador decrementado a cada pulso do oscilador (eventoClock).
+ * Ao chegar a zero, recarrega com o divisor e dá um pulso na sua
+ * linha de IRQ (registre-o no PIC com TipoDisparo::Borda, na IRQ 0).
+ * É a "batida" que permite ao kernel preemptar processos.
+ */
+class TimerPIT : public IDispositivoIRQ
+{
+public:
+    TimerPIT();
+
+    /**
+     * @brief Programa o período: uma interrupção a cada 'divisor' pulsos.
+     * (0 desliga o timer)
+     */
+    void programar(uint32_t divisor);
+
+    /**
+     * @brief Um pulso do oscilador da placa (um tick da simulação).
+     */
+    void eventoClock();
+
+    bool estaSinalIRQAtivo() const override;
+    void conectarIRQ(IControladorIRQ *controlador, int linha) override;
+
+    uint32_t divisor() const { return m_divisor; }
+    uint64_t totalDisparos() const { return m_disparos; }
+
+private:
+    uint32_t m_divisor;
+    uint32_t m_contador;
+    uint64_t m_disparos;
+
+    // O "fio" até o controlador de interrupções
+    IControladorIRQ *m_controlador;
+    int m_linhaIRQ;
+};
+
+#endif // TIMER_PIT_H
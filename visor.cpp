@@ -0,0 +1,286 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h>    // open
+#include <unistd.h>   // write, close
+
+#include "./buffer/FormatoFrameShm.h" // Slots, seqlock e o futex do frame
+#include "./buffer/CodificadorANSI.h"  // Células -> ANSI, só o que mudou
+#include "./ipc/CanalEntradaShm.h"    // Só para espiar o instante das teclas
+
+/**
+ * @brief Visor nativo do framebuffer (substitui o 'watch -n 0.1 cat sim_frame.txt').
+ *
+ * Uso: ./visor [--estatisticas] [sim_frame.shm]
+ *   --estatisticas : linha de status embaixo do frame (fps, latências)
+ *
+ * Mapeia o sim_frame.shm, dorme no futex da sequência até o simulador
+ * publicar um frame e redesenha só as células que mudaram (com o mínimo
+ * de bytes de cursor e de cor, ver CodificadorANSI), num único write()
+ * por frame. Frames com cor (--cor no simulador) saem em truecolor.
+ * Os frames são lidos pelo seqlock: nunca aparece um frame pela metade.
+ * Se o simulador trocar o arquivo (outro --resolucao, ou reiniciou), o
+ * visor reabre e redesenha tudo no novo tamanho.
+ *
+ * Latências (no stderr ao sair):
+ *   publicação -> tela : do simulador publicar o frame até o write() dele
+ *   tecla -> tela      : da tecla no listener até o write() do primeiro frame
+ *                        publicado depois dela
+ */
+
+static volatile std::sig_atomic_t g_executando = 1;
+
+static void tratarSinalDeParada(int) {
+    g_executando = 0;
+}
+
+/**
+ * @brief Acumula amostras de latência (média e máximo).
+ */
+struct Latencia {
+    uint64_t amostras = 0;
+    uint64_t totalNs = 0;
+    uint64_t maximaNs = 0;
+
+    void registrar(uint64_t ns) {
+        amostras++;
+        totalNs += ns;
+        if (ns > maximaNs) maximaNs = ns;
+    }
+    double mediaUs() const { return amostras > 0 ? (double)totalNs / (double)amostras / 1e3 : 0.0; }
+};
+
+/**
+ * @brief O slot lido em 'dados' como células: texto passa pelo
+ * intérprete de frames de texto; células são os três planos copiados.
+ */
+static void decodificarFrame(const CabecalhoFrameShm* cabecalho, const char* dados, size_t tamanho, FrameCelulas& celulas) {
+    if (cabecalho->formato != FORMATO_FRAME_CELULAS) {
+        celulas.deTexto(dados, tamanho);
+        return;
+    }
+    const size_t n = celulas.celulas();
+    if (tamanho < tamanhoCelulasShm(n)) return;
+    memcpy(celulas.glifos.data(), dados, n);
+    memcpy(celulas.frente.data(), dados + inicioFrenteCelulasShm(n), n * sizeof(uint32_t));
+    memcpy(celulas.fundo.data(), dados + inicioFundoCelulasShm(n), n * sizeof(uint32_t));
+}
+
+/**
+ * @brief O sim_frame.shm mapeado. O simulador nunca encolhe um arquivo
+ * mapeado: um tamanho novo (ou uma nova execução) vem num arquivo novo,
+ * e o antigo fica marcado como 'substituido'.
+ */
+struct FrameMapeado {
+    CabecalhoFrameShm* cabecalho = nullptr;
+    size_t tamanho = 0;
+
+    bool abrir(const std::string& caminho) {
+        int fd = open(caminho.c_str(), O_RDWR); // RDWR: o leitor anuncia que dorme no futex
+        if (fd == -1) return false;
+        struct stat info;
+        if (fstat(fd, &info) == -1 || (size_t)info.st_size < sizeof(CabecalhoFrameShm)) {
+            close(fd);
+            return false;
+        }
+        void* ptr = mmap(0, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) return false;
+
+        CabecalhoFrameShm* c = static_cast<CabecalhoFrameShm*>(ptr);
+        if (c->magic != MAGIC_FRAME_SHM || c->versao != VERSAO_FRAME_SHM ||
+            tamanhoArquivoFrameShm(c->numSlots, c->tamanhoSlot) > (size_t)info.st_size) {
+            munmap(ptr, (size_t)info.st_size);
+            return false;
+        }
+        cabecalho = c;
+        tamanho = (size_t)info.st_size;
+        return true;
+    }
+
+    void fechar() {
+        if (cabecalho != nullptr) munmap(cabecalho, tamanho);
+        cabecalho = nullptr;
+        tamanho = 0;
+    }
+
+    ~FrameMapeado() {
+        fechar();
+    }
+};
+
+/**
+ * @brief Espera o simulador criar o framebuffer. @return false no SIGINT.
+ */
+static bool aguardarFramebuffer(FrameMapeado& frame, const std::string& caminho) {
+    bool avisou = false;
+    while (g_executando && !frame.abrir(caminho)) {
+        if (!avisou) {
+            std::cerr << "Aguardando o simulador (" << caminho << ")..." << std::endl;
+            avisou = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    return g_executando;
+}
+
+static bool escreverTudo(const std::string& saida) {
+    size_t escrito = 0;
+    while (escrito < saida.size()) {
+        ssize_t n = write(STDOUT_FILENO, saida.data() + escrito, saida.size() - escrito);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        escrito += (size_t)n;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string caminho = "sim_frame.shm";
+    bool mostrarEstatisticas = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--estatisticas") {
+            mostrarEstatisticas = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Uso: " << argv[0] << " [--estatisticas] [sim_frame.shm]" << std::endl;
+            return 1;
+        } else {
+            caminho = arg;
+        }
+    }
+
+    std::signal(SIGINT, tratarSinalDeParada);
+    std::signal(SIGTERM, tratarSinalDeParada);
+
+    // 1. Espera o simulador criar o framebuffer
+    FrameMapeado frame;
+    if (!aguardarFramebuffer(frame, caminho)) return 0;
+    CabecalhoFrameShm* cabecalho = frame.cabecalho;
+
+    // O canal de entrada é opcional: sem ele, só não há a latência tecla -> tela
+    CanalEntradaShm canal("sim_input.shm", false);
+
+    CodificadorANSI codificador;
+    FrameCelulas celulas;
+    celulas.redimensionar((int)cabecalho->largura, (int)cabecalho->altura);
+    codificador.redimensionar(celulas.largura, celulas.altura);
+
+    std::vector<char> dados(cabecalho->tamanhoSlot);
+    std::string saida;
+    saida.reserve(dados.size() * 4);
+
+    // Esconde o cursor e limpa a tela uma única vez
+    saida = "\x1b[?25l\x1b[2J";
+    escreverTudo(saida);
+
+    uint64_t ultimaSequencia = 0;
+    uint64_t frames = 0, pulados = 0, bytesEscritos = 0, celulasEscritas = 0;
+    Latencia publicacaoTela, teclaTela;
+    uint64_t teclasVistas = 0;
+    uint64_t teclaPendenteNs = 0; // Instante da tecla esperando o próximo frame (0 = nenhuma)
+    EventoTecla evento;
+    uint64_t totalTeclas = 0;
+    if (canal.espiarUltimoEvento(evento, totalTeclas)) teclasVistas = totalTeclas;
+
+    auto partida = std::chrono::steady_clock::now();
+    auto ultimoStatus = partida;
+    uint64_t framesNoStatus = 0;
+    double fpsStatus = 0.0;
+
+    while (g_executando) {
+        // 2. Dorme até o próximo frame (o timeout só serve para ver o SIGINT)
+        uint64_t sequencia = aguardarFrameShm(cabecalho, ultimaSequencia, 100);
+        if (cabecalho->substituido.load(std::memory_order_acquire) != 0) {
+            // Arquivo novo no caminho: reabre e recomeça no tamanho dele
+            frame.fechar();
+            if (!aguardarFramebuffer(frame, caminho)) break;
+            cabecalho = frame.cabecalho;
+            celulas.redimensionar((int)cabecalho->largura, (int)cabecalho->altura);
+            codificador.redimensionar(celulas.largura, celulas.altura);
+            dados.assign(cabecalho->tamanhoSlot, 0);
+            ultimaSequencia = 0;
+            saida = "\x1b[2J";
+            escreverTudo(saida);
+            continue;
+        }
+        if (canal.espiarUltimoEvento(evento, totalTeclas) && totalTeclas != teclasVistas) {
+            teclasVistas = totalTeclas;
+            if (teclaPendenteNs == 0) teclaPendenteNs = evento.timestampNs;
+        }
+        if (sequencia == ultimaSequencia) continue;
+
+        // 3. Lê o frame publicado mais recente (os intermediários são pulados)
+        uint64_t timestampNs = 0;
+        size_t tamanho = lerFrameShm(cabecalho, dados.data(), sequencia, timestampNs);
+        if (tamanho == 0) continue;
+        if (sequencia < ultimaSequencia) {
+            codificador.invalidar(); // O simulador reiniciou
+        } else if (ultimaSequencia != 0 && sequencia > ultimaSequencia + 1) {
+            pulados += sequencia - ultimaSequencia - 1;
+        }
+        ultimaSequencia = sequencia;
+
+        // 4. Só as células que mudaram, num único write()
+        decodificarFrame(cabecalho, dados.data(), tamanho, celulas);
+        saida.clear();
+        celulasEscritas += codificador.codificar(celulas, saida);
+
+        auto agora = std::chrono::steady_clock::now();
+        framesNoStatus++;
+        if (mostrarEstatisticas && agora - ultimoStatus >= std::chrono::seconds(1)) {
+            fpsStatus = (double)framesNoStatus / std::chrono::duration<double>(agora - ultimoStatus).count();
+            framesNoStatus = 0;
+            ultimoStatus = agora;
+            codificador.restaurarCores(saida); // O status sai nas cores padrão
+            char status[160];
+            int n = std::snprintf(status, sizeof(status),
+                                  "\x1b[%d;1H\x1b[2Kfps=%.1f pulados=%llu pub->tela=%.0fus tecla->tela=%.1fms",
+                                  celulas.altura + 1, fpsStatus, (unsigned long long)pulados,
+                                  publicacaoTela.mediaUs(), teclaTela.mediaUs() / 1e3);
+            saida.append(status, (size_t)n);
+            codificador.esquecerCursor();
+        }
+        if (!saida.empty() && !escreverTudo(saida)) break;
+
+        uint64_t depoisNs = CanalEntradaShm::agoraNs(); // Mesmo relógio do frame e das teclas
+        frames++;
+        bytesEscritos += saida.size();
+        // O primeiro frame já estava publicado antes do visor abrir: não conta
+        if (frames > 1 && depoisNs > timestampNs) publicacaoTela.registrar(depoisNs - timestampNs);
+        if (teclaPendenteNs != 0 && timestampNs >= teclaPendenteNs) {
+            teclaTela.registrar(depoisNs - teclaPendenteNs);
+            teclaPendenteNs = 0;
+        }
+    }
+
+    // Devolve as cores e o cursor, abaixo do frame
+    saida.clear();
+    codificador.restaurarCores(saida);
+    saida += "\x1b[" + std::to_string(celulas.altura + (mostrarEstatisticas ? 2 : 1)) + ";1H\x1b[?25h";
+    escreverTudo(saida);
+
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - partida).count();
+    std::fprintf(stderr,
+                 "[VISOR] frames=%llu pulados=%llu fps=%.1f bytes_por_frame=%.1f celulas_por_frame=%.1f"
+                 " pub->tela media=%.1fus max=%.1fus tecla->tela amostras=%llu media=%.2fms max=%.2fms\n",
+                 (unsigned long long)frames, (unsigned long long)pulados,
+                 segundos > 0.0 ? (double)frames / segundos : 0.0,
+                 frames > 0 ? (double)bytesEscritos / (double)frames : 0.0,
+                 frames > 0 ? (double)celulasEscritas / (double)frames : 0.0,
+                 publicacaoTela.mediaUs(), publicacaoTela.maximaNs / 1e3,
+                 (unsigned long long)teclaTela.amostras, teclaTela.mediaUs() / 1e3, teclaTela.maximaNs / 1e6);
+    return 0;
+}